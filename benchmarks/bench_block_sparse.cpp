@@ -0,0 +1,106 @@
+#include "math/BlockSparse.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // cells of the grid, far beyond the caches
+  constexpr size_t nx = 64, ncells = nx*nx*nx;
+
+  // 7-point stencil of the grid, i.e. the faces of the cells
+  template<size_t N> BlockSparse<N> stencil()
+  {
+    std::vector<size_t> counts(ncells);
+    const auto cell = [](size_t i, size_t j, size_t k) { return std::uint32_t((i*nx + j)*nx + k); };
+    for (size_t i = 0; i < nx; ++i)
+      for (size_t j = 0; j < nx; ++j)
+        for (size_t k = 0; k < nx; ++k)
+          counts[cell(i, j, k)] = 1 + (i > 0) + (j > 0) + (k > 0) + (i + 1 < nx) + (j + 1 < nx) + (k + 1 < nx);
+
+    Ragged<std::uint32_t> pattern(counts);
+    for (size_t i = 0; i < nx; ++i)
+      for (size_t j = 0; j < nx; ++j)
+        for (size_t k = 0; k < nx; ++k)
+        {
+          auto *r = pattern[cell(i, j, k)].data();
+          *r++ = cell(i, j, k);
+          if (i > 0) *r++ = cell(i - 1, j, k);
+          if (j > 0) *r++ = cell(i, j - 1, k);
+          if (k > 0) *r++ = cell(i, j, k - 1);
+          if (i + 1 < nx) *r++ = cell(i + 1, j, k);
+          if (j + 1 < nx) *r++ = cell(i, j + 1, k);
+          if (k + 1 < nx) *r++ = cell(i, j, k + 1);
+        }
+
+    BlockSparse<N> A(std::move(pattern), ncells);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (auto &B : A.values())
+      for (auto &x : B)
+        x = dist(gen);
+    return A;
+  }
+
+  // the least traffic of a product: blocks, columns, row pointers, x and y once
+  template<size_t N> size_t spmv_bytes(const BlockSparse<N> &A)
+  {
+    return A.nblocks() * (sizeof(Tensor<N>) + sizeof(std::uint32_t)) + (A.nrows() + 1) * sizeof(size_t) +
+           (A.nrows() + A.ncols()) * sizeof(Vector<N>);
+  }
+} // namespace
+
+// STREAM triad a = b + s c on the same threads, the baseline of the memory bandwidth
+static void stream_triad(benchmark::State &state)
+{
+  const size_t n = 1 << 24;
+  std::vector<double, simd::allocator<double>> a(n), b(n, 1.), c(n, 2.);
+  const double s = 3;
+  for (auto _ : state)
+  {
+    Parallel::for_chunks(n, 1 << 16, [&](size_t first, size_t last)
+    {
+      MATH_SIMD_LOOP
+      for (size_t i = first; i < last; ++i)
+        a[i] = b[i] + s * c[i];
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * 3 * n * sizeof(double));
+}
+BENCHMARK(stream_triad)->UseRealTime();
+
+template<size_t N> static void bsr_multiply(benchmark::State &state)
+{
+  const auto A = stencil<N>();
+  const std::vector<Vector<N>> x(A.ncols(), Vector<N>(1.));
+  std::vector<Vector<N>> y(A.nrows());
+  for (auto _ : state)
+  {
+    multiply(A, x, y);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * spmv_bytes(A));
+  state.SetItemsProcessed(state.iterations() * A.nblocks());
+}
+BENCHMARK(bsr_multiply<3>)->UseRealTime();
+BENCHMARK(bsr_multiply<4>)->UseRealTime();
+
+template<size_t N> static void bsr_multiply_transpose(benchmark::State &state)
+{
+  const auto A = stencil<N>();
+  const std::vector<Vector<N>> x(A.nrows(), Vector<N>(1.));
+  std::vector<Vector<N>> y(A.ncols());
+  for (auto _ : state)
+  {
+    multiply_transpose(A, x, y);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * spmv_bytes(A));
+  state.SetItemsProcessed(state.iterations() * A.nblocks());
+}
+BENCHMARK(bsr_multiply_transpose<3>)->UseRealTime();
+BENCHMARK(bsr_multiply_transpose<4>)->UseRealTime();
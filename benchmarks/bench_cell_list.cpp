@@ -0,0 +1,62 @@
+#include "math/CellList.h"
+#include "math/KdTree.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // about 30 neighbours within the cutoff per point
+  constexpr double cutoff = 1.;
+
+  std::vector<Vector3D> random_points(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0, std::cbrt(static_cast<double>(n) / 7.));
+    std::vector<Vector3D> v(n);
+    for (auto &x : v)
+      x = Vector3D(dist(gen), dist(gen), dist(gen));
+    return v;
+  }
+} // namespace
+
+static void cell_list_rebuild(benchmark::State &state)
+{
+  auto v = random_points(state.range(0));
+  CellList<3> cells(cutoff);
+  for (auto _ : state)
+  {
+    cells.rebuild(v);
+    benchmark::DoNotOptimize(cells.points().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(cell_list_rebuild)->Arg(1 << 16)->Arg(1 << 20);
+
+// what a tree costs per step instead
+static void kd_tree_build(benchmark::State &state)
+{
+  auto v = random_points(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(KdTree<3>(v));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(kd_tree_build)->Arg(1 << 16)->Arg(1 << 20);
+
+// sum over all pairs within the cutoff
+static void cell_list_pairs(benchmark::State &state)
+{
+  CellList<3> cells(cutoff, random_points(state.range(0)));
+  for (auto _ : state)
+  {
+    double s = 0;
+    for (size_t k = 0; k < cells.size(); ++k)
+      cells.neighbours_of(k, [&s](size_t, double d2) { s += d2; });
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(cell_list_pairs)->Arg(1 << 16);
@@ -0,0 +1,57 @@
+#include "math/Dual.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+using namespace Math;
+
+namespace
+{
+  // flux of the Euler equations through the unit normal n, conservative variables (rho, rho u, E)
+  template<class T> Vector<5, T> flux(const Vector<5, T> &q)
+  {
+    const double gamma = 1.4;
+    const Vector<3, T> u(q[1] / q[0], q[2] / q[0], q[3] / q[0]);
+    const Vector<3, T> n(0.6, 0.8, 0);
+    const T un = u * n, p = (gamma - 1) * (q[4] - q[0] * (u * u) / 2);
+    return Vector<5, T>(q[0] * un, q[1] * un + p * n[0], q[2] * un + p * n[1], q[3] * un + p * n[2], (q[4] + p) * un);
+  }
+
+  const Vector<5, double> q0(1.2, 0.3, -0.4, 0.1, 2.5);
+} // namespace
+
+// one-sided differences, N + 1 evaluations
+static void jacobian_finite_differences(benchmark::State &state)
+{
+  Vector<5, double> q = q0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(q);
+    Tensor<5, double> J;
+    const auto f = flux(q);
+    for (size_t j = 0; j < 5; ++j)
+    {
+      const double h = 1e-7 * (1 + std::fabs(q[j]));
+      auto qh = q;
+      qh[j] += h;
+      const auto df = (flux(qh) - f) / h;
+      for (size_t i = 0; i < 5; ++i)
+        J[i][j] = df[i];
+    }
+    benchmark::DoNotOptimize(J);
+  }
+}
+BENCHMARK(jacobian_finite_differences);
+
+// one evaluation of the same code in duals, exact derivatives
+static void jacobian_dual(benchmark::State &state)
+{
+  Vector<5, double> q = q0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(q);
+    auto J = jacobian(flux(variables<5>(q)));
+    benchmark::DoNotOptimize(J);
+  }
+}
+BENCHMARK(jacobian_dual);
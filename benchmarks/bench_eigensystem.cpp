@@ -0,0 +1,116 @@
+#include "math/Eigensystem.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  constexpr size_t n = 1 << 16;
+
+  // stresses of the cells of a mesh
+  std::vector<SymTensor3D> random_tensors()
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<SymTensor3D> v(n);
+    for (auto &A : v)
+      for (auto &x : A)
+        x = dist(gen);
+    return v;
+  }
+
+  TensorField<3> random_field()
+  {
+    const auto v = random_tensors();
+    TensorField<3> f(n);
+    for (size_t k = 0; k < n; ++k)
+      f.set(k, Tensor3D(v[k]));
+    return f;
+  }
+} // namespace
+
+static void eigenvalues_scalar(benchmark::State &state)
+{
+  const auto A = random_tensors();
+  std::vector<Vector3D> l(n);
+  for (auto _ : state)
+  {
+    for (size_t k = 0; k < n; ++k)
+      l[k] = eigenvalues(A[k]);
+    benchmark::DoNotOptimize(l.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(eigenvalues_scalar);
+
+static void eigenvalues_batched(benchmark::State &state)
+{
+  const auto A = random_field();
+  VectorField<3> l(n);
+  for (auto _ : state)
+  {
+    eigenvalues(A, l);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(eigenvalues_batched);
+
+static void eigen_scalar(benchmark::State &state)
+{
+  const auto A = random_tensors();
+  std::vector<Eigensystem<3>> e(n);
+  for (auto _ : state)
+  {
+    for (size_t k = 0; k < n; ++k)
+      e[k] = eigen(A[k]);
+    benchmark::DoNotOptimize(e.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(eigen_scalar);
+
+static void eigen_batched(benchmark::State &state)
+{
+  const auto A = random_field();
+  VectorField<3> l(n);
+  TensorField<3> v(n);
+  for (auto _ : state)
+  {
+    eigen(A, l, v);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(eigen_batched);
+
+static void eigen_jacobi_scalar(benchmark::State &state)
+{
+  const auto A = random_tensors();
+  std::vector<Eigensystem<3>> e(n);
+  for (auto _ : state)
+  {
+    for (size_t k = 0; k < n; ++k)
+      e[k] = eigen_jacobi(A[k]);
+    benchmark::DoNotOptimize(e.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(eigen_jacobi_scalar);
+
+static void eigen_jacobi_batched(benchmark::State &state)
+{
+  const auto A = random_field();
+  VectorField<3> l(n);
+  TensorField<3> v(n);
+  for (auto _ : state)
+  {
+    eigen_jacobi(A, l, v);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(eigen_jacobi_batched);
@@ -0,0 +1,102 @@
+#include "math/Factorization.h"
+#include "RandomTensors.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace Math;
+using Tests::random_tensor;
+using Tests::random_vectors;
+
+namespace
+{
+  constexpr size_t nrhs = 64;
+} // namespace
+
+// the same tensor and many right hand sides: inverse every time
+template<size_t N> static void solve_by_invert(benchmark::State &state)
+{
+  const auto A = random_tensor<N>();
+  const auto b = random_vectors<N>(nrhs);
+  std::vector<Vector<N>> x(nrhs);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    for (size_t k = 0; k < nrhs; ++k)
+      x[k] = A.invert() * b[k];
+    benchmark::DoNotOptimize(x.data());
+  }
+  state.SetItemsProcessed(state.iterations() * nrhs);
+}
+BENCHMARK(solve_by_invert<3>);
+BENCHMARK(solve_by_invert<6>);
+BENCHMARK(solve_by_invert<12>);
+
+// Vector / Tensor, a solve by LU every time
+template<size_t N> static void solve_by_division(benchmark::State &state)
+{
+  const auto A = random_tensor<N>();
+  const auto b = random_vectors<N>(nrhs);
+  std::vector<Vector<N>> x(nrhs);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    for (size_t k = 0; k < nrhs; ++k)
+      x[k] = b[k] / ~A;
+    benchmark::DoNotOptimize(x.data());
+  }
+  state.SetItemsProcessed(state.iterations() * nrhs);
+}
+BENCHMARK(solve_by_division<3>);
+BENCHMARK(solve_by_division<6>);
+BENCHMARK(solve_by_division<12>);
+
+// factorization once, then the solves only
+template<class F, size_t N> static void solve_by_factors(benchmark::State &state)
+{
+  const auto A = random_tensor<N>();
+  const auto b = random_vectors<N>(nrhs);
+  std::vector<Vector<N>> x(nrhs);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    const F f(A);
+    for (size_t k = 0; k < nrhs; ++k)
+      x[k] = f.solve(b[k]);
+    benchmark::DoNotOptimize(x.data());
+  }
+  state.SetItemsProcessed(state.iterations() * nrhs);
+}
+BENCHMARK(solve_by_factors<LU<3>, 3>);
+BENCHMARK(solve_by_factors<LU<6>, 6>);
+BENCHMARK(solve_by_factors<LU<12>, 12>);
+BENCHMARK(solve_by_factors<QR<12>, 12>);
+
+// tensor of right hand sides at once
+template<size_t N> static void tensor_division(benchmark::State &state)
+{
+  const auto A = random_tensor<N>();
+  const auto B = random_tensor<N>() * 0.5;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    auto C = B / A;
+    benchmark::DoNotOptimize(C);
+  }
+}
+BENCHMARK(tensor_division<6>);
+BENCHMARK(tensor_division<12>);
+
+template<size_t N> static void tensor_times_inverse(benchmark::State &state)
+{
+  const auto A = random_tensor<N>();
+  const auto B = random_tensor<N>() * 0.5;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    auto C = B * A.invert();
+    benchmark::DoNotOptimize(C);
+  }
+}
+BENCHMARK(tensor_times_inverse<6>);
+BENCHMARK(tensor_times_inverse<12>);
@@ -0,0 +1,261 @@
+#include "math/FastMath.h"
+#include "math/Vector.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  constexpr size_t n = 4096;
+
+  template<class T> std::vector<T> random_values(T lo, T hi)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<T> dist(lo, hi);
+    std::vector<T> x(n);
+    for (auto &v : x)
+      v = dist(gen);
+    return x;
+  }
+
+  std::vector<Vector3D> random_vectors()
+  {
+    auto x = random_values(-10., 10.);
+    std::vector<Vector3D> v(n / 3);
+    for (size_t i = 0; i < v.size(); ++i)
+      v[i] = Vector3D(x[3*i], x[3*i + 1], x[3*i + 2]);
+    return v;
+  }
+} // namespace
+
+// constexpr Newton iterations, i.e. the compile-time path
+static void sqrt_newton(benchmark::State &state)
+{
+  auto x = random_values(0., 1e6);
+  for (auto _ : state)
+    for (double v : x)
+      benchmark::DoNotOptimize(details::impl::sqrt_real(v, v, 0.));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(sqrt_newton);
+
+static void sqrt_dispatched(benchmark::State &state)
+{
+  auto x = random_values(0., 1e6);
+  for (auto _ : state)
+    for (double v : x)
+      benchmark::DoNotOptimize(details::sqrt(v));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(sqrt_dispatched);
+
+static void sqrt_batched(benchmark::State &state)
+{
+  auto x = random_values(0., 1e6);
+  std::vector<double> r(n);
+  for (auto _ : state)
+  {
+    Math::sqrt(x, r);
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(sqrt_batched);
+
+static void sqrt_integer_binary_search(benchmark::State &state)
+{
+  std::vector<long> x(n);
+  for (size_t i = 0; i < n; ++i)
+    x[i] = static_cast<long>(i * i * 7919 + i);
+  for (auto _ : state)
+    for (long v : x)
+      benchmark::DoNotOptimize(details::impl::sqrt_int(v, 0L, v / 2 + 1));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(sqrt_integer_binary_search);
+
+static void sqrt_integer_dispatched(benchmark::State &state)
+{
+  std::vector<long> x(n);
+  for (size_t i = 0; i < n; ++i)
+    x[i] = static_cast<long>(i * i * 7919 + i);
+  for (auto _ : state)
+    for (long v : x)
+      benchmark::DoNotOptimize(details::sqrt(v));
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(sqrt_integer_dispatched);
+
+/*---------------------------------------------------------------------------------------*/
+
+static void vector_fabs_newton(benchmark::State &state)
+{
+  auto v = random_vectors();
+  for (auto _ : state)
+    for (const auto &a : v)
+    {
+      double s = a * a;
+      benchmark::DoNotOptimize(details::impl::sqrt_real(s, s, 0.));
+    }
+  state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(vector_fabs_newton);
+
+static void vector_fabs(benchmark::State &state)
+{
+  auto v = random_vectors();
+  for (auto _ : state)
+    for (const auto &a : v)
+      benchmark::DoNotOptimize(fabs(a));
+  state.SetItemsProcessed(state.iterations() * v.size());
+}
+BENCHMARK(vector_fabs);
+
+/*---------------------------------------------------------------------------------------*/
+
+static void rsqrt_float_exact(benchmark::State &state)
+{
+  auto x = random_values(1e-3f, 1e3f);
+  std::vector<float> r(n);
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      r[i] = 1.f / std::sqrt(x[i]);
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(rsqrt_float_exact);
+
+static void rsqrt_float_scalar(benchmark::State &state)
+{
+  auto x = random_values(1e-3f, 1e3f);
+  std::vector<float> r(n);
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      r[i] = details::rsqrt(x[i]);
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(rsqrt_float_scalar);
+
+static void rsqrt_float_batched(benchmark::State &state)
+{
+  auto x = random_values(1e-3f, 1e3f);
+  std::vector<float> r(n);
+  for (auto _ : state)
+  {
+    Math::rsqrt(x, r);
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(rsqrt_float_batched);
+
+/*---------------------------------------------------------------------------------------*/
+
+static void hypot_std(benchmark::State &state)
+{
+  auto x = random_values(-1e3, 1e3), y = random_values(-1e3, 1e3);
+  std::vector<double> r(n);
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      r[i] = std::hypot(x[i], y[i]);
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(hypot_std);
+
+static void hypot_batched(benchmark::State &state)
+{
+  auto x = random_values(-1e3, 1e3), y = random_values(-1e3, 1e3);
+  std::vector<double> r(n);
+  for (auto _ : state)
+  {
+    Math::hypot(x, y, r);
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(hypot_batched);
+
+/*---------------------------------------------------------------------------------------*/
+
+// cos and sin of the same pair by three square roots
+static void cos_sin_separate(benchmark::State &state)
+{
+  auto a = random_vectors(), b = random_vectors();
+  std::vector<double> c(a.size()), s(a.size());
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+      c[i] = a[i] * b[i] / (fabs(a[i]) * fabs(b[i]));
+      s[i] = details::sqrt(1. - c[i] * c[i]);
+    }
+    benchmark::DoNotOptimize(c.data());
+    benchmark::DoNotOptimize(s.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(cos_sin_separate);
+
+static void cos_sin_fused(benchmark::State &state)
+{
+  auto a = random_vectors(), b = random_vectors();
+  std::vector<double> c(a.size()), s(a.size());
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < a.size(); ++i)
+      std::tie(c[i], s[i]) = cos_sin(a[i], b[i]);
+    benchmark::DoNotOptimize(c.data());
+    benchmark::DoNotOptimize(s.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(cos_sin_fused);
+
+static void cos_sin_batched(benchmark::State &state)
+{
+  auto a = random_vectors(), b = random_vectors();
+  std::vector<double> c(a.size()), s(a.size());
+  for (auto _ : state)
+  {
+    cos_sin(a, b, c, s);
+    benchmark::DoNotOptimize(c.data());
+    benchmark::DoNotOptimize(s.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(cos_sin_batched);
+
+static void normalize_batched(benchmark::State &state)
+{
+  auto a = random_vectors();
+  std::vector<Vector3D> r(a.size());
+  for (auto _ : state)
+  {
+    normalize(a, r);
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(normalize_batched);
@@ -0,0 +1,79 @@
+#include "math/Half.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  template<class T> std::vector<T> random_values(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-100, 100);
+    std::vector<T> v(n);
+    for (auto &x : v)
+      x = static_cast<T>(dist(gen));
+    return v;
+  }
+
+  // field larger than the caches
+  constexpr size_t ncells = 1 << 22;
+} // namespace
+
+template<class From, class To> static void bulk_convert(benchmark::State &state)
+{
+  auto x = random_values<From>(state.range(0));
+  std::vector<To> r(x.size());
+  for (auto _ : state)
+  {
+    convert(x, r);
+    benchmark::DoNotOptimize(r.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bulk_convert<float, Half>)->Arg(1 << 14);
+BENCHMARK(bulk_convert<Half, float>)->Arg(1 << 14);
+BENCHMARK(bulk_convert<double, Half>)->Arg(1 << 14);
+BENCHMARK(bulk_convert<Half, double>)->Arg(1 << 14);
+BENCHMARK(bulk_convert<float, BFloat16>)->Arg(1 << 14);
+BENCHMARK(bulk_convert<BFloat16, float>)->Arg(1 << 14);
+
+// change of a field between time levels, the old one stored in full precision
+static void time_change_double(benchmark::State &state)
+{
+  auto u = random_values<double>(3 * ncells), u_old = random_values<double>(3 * ncells);
+  std::vector<double> du(u.size());
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < u.size(); ++i)
+      du[i] = u[i] - u_old[i];
+    benchmark::DoNotOptimize(du.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ncells);
+}
+BENCHMARK(time_change_double);
+
+// and in half precision, converted by blocks in L1
+static void time_change_half(benchmark::State &state)
+{
+  auto u = random_values<double>(3 * ncells);
+  auto u_old = random_values<Half>(3 * ncells);
+  std::vector<double> du(u.size());
+  constexpr size_t block = 1024;
+  for (auto _ : state)
+  {
+    for (size_t first = 0; first < u.size(); first += block)
+    {
+      auto d = std::span(du).subspan(first, block);
+      convert(std::span(u_old).subspan(first, block), d);
+      for (size_t i = 0; i < block; ++i)
+        d[i] = u[first + i] - d[i];
+    }
+    benchmark::DoNotOptimize(du.data());
+  }
+  state.SetItemsProcessed(state.iterations() * ncells);
+}
+BENCHMARK(time_change_half);
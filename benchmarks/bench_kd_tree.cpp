@@ -0,0 +1,58 @@
+#include "math/KdTree.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  std::vector<Vector3D> random_points(size_t n, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-10, 10);
+    std::vector<Vector3D> v(n);
+    for (auto &x : v)
+      x = Vector3D(dist(gen), dist(gen), dist(gen));
+    return v;
+  }
+} // namespace
+
+static void build(benchmark::State &state)
+{
+  auto v = random_points(state.range(0), 1);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(KdTree<3>(v));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(build)->Arg(1 << 16)->Arg(1 << 20);
+
+// one traversal per query in the given order
+static void knn_single(benchmark::State &state)
+{
+  KdTree<3> tree(random_points(1 << 20, 1));
+  auto q = random_points(1 << 16, 2);
+  const auto k = static_cast<size_t>(state.range(0));
+  for (auto _ : state)
+    for (auto &x : q)
+      benchmark::DoNotOptimize(tree.knn(x, k));
+  state.SetItemsProcessed(state.iterations() * q.size());
+}
+BENCHMARK(knn_single)->Arg(1)->Arg(8);
+
+// queries ordered along the curve, packets share traversals
+static void knn_batched(benchmark::State &state)
+{
+  KdTree<3> tree(random_points(1 << 20, 1));
+  auto q = random_points(1 << 16, 2);
+  const auto k = static_cast<size_t>(state.range(0));
+  std::vector<Neighbour<double>> result(q.size() * k);
+  for (auto _ : state)
+  {
+    tree.knn(q, k, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * q.size());
+}
+BENCHMARK(knn_batched)->Arg(1)->Arg(8);
@@ -0,0 +1,104 @@
+#include "math/Vector.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  constexpr size_t n = 4096;
+
+  template<class V> using value_t = std::remove_cvref_t<decltype(V()[0])>;
+
+  template<class V> std::vector<V> random_vectors(unsigned seed)
+  {
+    using T = value_t<V>;
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<T> dist(-10, 10);
+    std::vector<V> v(n);
+    for (auto &x : v)
+      x = V(dist(gen), dist(gen), dist(gen));
+    return v;
+  }
+
+  using P3d = Vector<3, double>;
+  using A3d = PaddedVector<3, double>;
+  using P3f = Vector<3, float>;
+  using A3f = PaddedVector<3, float>;
+} // namespace
+
+// y[i] += a*x[i]
+template<class V> static void axpy(benchmark::State &state)
+{
+  auto x = random_vectors<V>(1), y = random_vectors<V>(2);
+  const value_t<V> a = 0.5;
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      y[i] += x[i] * a;
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(axpy, P3d);
+BENCHMARK_TEMPLATE(axpy, A3d);
+BENCHMARK_TEMPLATE(axpy, P3f);
+BENCHMARK_TEMPLATE(axpy, A3f);
+
+// sum of x[i]*y[i]
+template<class V> static void dot(benchmark::State &state)
+{
+  auto x = random_vectors<V>(1), y = random_vectors<V>(2);
+  for (auto _ : state)
+  {
+    decltype(x[0] * y[0]) s = 0;
+    for (size_t i = 0; i < n; ++i)
+      s += x[i] * y[i];
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(dot, P3d);
+BENCHMARK_TEMPLATE(dot, A3d);
+BENCHMARK_TEMPLATE(dot, P3f);
+BENCHMARK_TEMPLATE(dot, A3f);
+
+// r[i] = x[i] % y[i]
+template<class V> static void cross(benchmark::State &state)
+{
+  auto x = random_vectors<V>(1), y = random_vectors<V>(2);
+  std::vector<V> r(n);
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      r[i] = x[i] % y[i];
+    benchmark::DoNotOptimize(r.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(cross, P3d);
+BENCHMARK_TEMPLATE(cross, A3d);
+BENCHMARK_TEMPLATE(cross, P3f);
+BENCHMARK_TEMPLATE(cross, A3f);
+
+// x[i] /= |x[i]|
+template<class V> static void normalize(benchmark::State &state)
+{
+  auto x = random_vectors<V>(1);
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      x[i] /= fabs(x[i]);
+    benchmark::DoNotOptimize(x.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(normalize, P3d);
+BENCHMARK_TEMPLATE(normalize, A3d);
+BENCHMARK_TEMPLATE(normalize, P3f);
+BENCHMARK_TEMPLATE(normalize, A3f);
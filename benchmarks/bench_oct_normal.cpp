@@ -0,0 +1,114 @@
+#include "math/OctNormal.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // face normals of a mesh larger than the caches
+  constexpr size_t nfaces = 1 << 22;
+
+  std::vector<Vector3D> random_normals(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> dist;
+    std::vector<Vector3D> v(n);
+    for (auto &x : v)
+    {
+      x = Vector3D(dist(gen), dist(gen), dist(gen));
+      x /= std::sqrt(x * x);
+    }
+    return v;
+  }
+} // namespace
+
+// flux-like face loop over stored normals
+static void face_loop_vector3d(benchmark::State &state)
+{
+  auto n = random_normals(nfaces);
+  const Vector3D u(0.3, -0.2, 0.9);
+  for (auto _ : state)
+  {
+    double s = 0;
+    for (auto &x : n)
+      s += std::abs(u * x);
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetBytesProcessed(state.iterations() * nfaces * sizeof(Vector3D));
+}
+BENCHMARK(face_loop_vector3d);
+
+// the same with compressed normals decoded one by one
+template<class E> static void face_loop_oct(benchmark::State &state)
+{
+  auto v = random_normals(nfaces);
+  std::vector<E> n(nfaces);
+  E::encode(v, n);
+  const Vector3D u(0.3, -0.2, 0.9);
+  for (auto _ : state)
+  {
+    double s = 0;
+    for (auto &e : n)
+      s += std::abs(u * e.vector());
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetBytesProcessed(state.iterations() * nfaces * sizeof(E));
+}
+BENCHMARK(face_loop_oct<OctNormal16>);
+
+// and decoded by blocks into a buffer in L1
+template<class E> static void face_loop_oct_blocks(benchmark::State &state)
+{
+  auto v = random_normals(nfaces);
+  std::vector<E> n(nfaces);
+  E::encode(v, n);
+  const Vector3D u(0.3, -0.2, 0.9);
+  constexpr size_t block = 512;
+  std::vector<Vector3D> buf(block);
+  for (auto _ : state)
+  {
+    double s = 0;
+    for (size_t first = 0; first < nfaces; first += block)
+    {
+      E::decode(std::span(n).subspan(first, block), buf);
+      for (auto &x : buf)
+        s += std::abs(u * x);
+    }
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetBytesProcessed(state.iterations() * nfaces * sizeof(E));
+}
+BENCHMARK(face_loop_oct_blocks<OctNormal16>);
+BENCHMARK(face_loop_oct_blocks<OctNormal32>);
+
+// bulk kernels
+template<class E> static void bulk_encode(benchmark::State &state)
+{
+  auto v = random_normals(state.range(0));
+  std::vector<E> n(v.size());
+  for (auto _ : state)
+  {
+    E::encode(v, n);
+    benchmark::DoNotOptimize(n.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bulk_encode<OctNormal16>)->Arg(1 << 12);
+
+template<class E> static void bulk_decode(benchmark::State &state)
+{
+  auto v = random_normals(state.range(0));
+  std::vector<E> n(v.size());
+  E::encode(v, n);
+  for (auto _ : state)
+  {
+    E::decode(n, v);
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bulk_decode<OctNormal16>)->Arg(1 << 12);
@@ -0,0 +1,99 @@
+#include "math/Ragged.h"
+#include "math/Vector.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // polygons of 3 to 8 vertices, allocated in a shuffled order as a mesh reader would do
+  std::vector<std::vector<Vector3D>> random_polygons(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> count(3, 8);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<std::vector<Vector3D>> v(n);
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i)
+      order[i] = i;
+    std::shuffle(order.begin(), order.end(), gen);
+    for (auto i : order)
+    {
+      v[i].resize(count(gen));
+      for (auto &x : v[i])
+        x = Vector3D(dist(gen), dist(gen), dist(gen));
+    }
+    return v;
+  }
+
+  template<class R> Vector3D centroid(const R &polygon)
+  {
+    Vector3D c;
+    for (auto &x : polygon)
+      c += x;
+    return c / static_cast<double>(polygon.size());
+  }
+} // namespace
+
+static void centroids_nested_vectors(benchmark::State &state)
+{
+  auto polygons = random_polygons(state.range(0));
+  std::vector<Vector3D> c(polygons.size());
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < polygons.size(); ++i)
+      c[i] = centroid(polygons[i]);
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(centroids_nested_vectors)->Arg(1 << 14)->Arg(1 << 20);
+
+static void centroids_ragged(benchmark::State &state)
+{
+  auto polygons = Ragged<Vector3D>::from_rows(random_polygons(state.range(0)));
+  std::vector<Vector3D> c(polygons.size());
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < polygons.size(); ++i)
+      c[i] = centroid(polygons[i]);
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(centroids_ragged)->Arg(1 << 14)->Arg(1 << 20);
+
+// allocation of the rows of the given sizes
+static void construct_nested_vectors(benchmark::State &state)
+{
+  std::vector<int> counts(state.range(0));
+  for (size_t i = 0; i < counts.size(); ++i)
+    counts[i] = 3 + static_cast<int>(i % 6);
+  for (auto _ : state)
+  {
+    std::vector<std::vector<Vector3D>> v(counts.size());
+    for (size_t i = 0; i < counts.size(); ++i)
+      v[i].resize(counts[i]);
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(construct_nested_vectors)->Arg(1 << 20);
+
+static void construct_ragged(benchmark::State &state)
+{
+  std::vector<int> counts(state.range(0));
+  for (size_t i = 0; i < counts.size(); ++i)
+    counts[i] = 3 + static_cast<int>(i % 6);
+  for (auto _ : state)
+  {
+    Ragged<Vector3D> r(counts);
+    benchmark::DoNotOptimize(r.values().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(construct_ragged)->Arg(1 << 20);
@@ -0,0 +1,65 @@
+#include "math/Reductions.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  template<class V> std::vector<V> random_vectors(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-10, 10);
+    std::vector<V> v(n);
+    for (auto &x : v)
+      x = V(dist(gen), dist(gen), dist(gen));
+    return v;
+  }
+} // namespace
+
+// hand-written serial loop, what we replace
+template<class V> static void serial_loop(benchmark::State &state)
+{
+  auto v = random_vectors<V>(state.range(0));
+  for (auto _ : state)
+  {
+    auto sum = v[0], lo = v[0], hi = v[0];
+    auto sqs = v[0] * v[0], max_sqs = sqs;
+    for (size_t i = 1; i < v.size(); ++i)
+    {
+      sum += v[i];
+      for (size_t k = 0; k < 3; ++k)
+      {
+        lo[k] = std::min(lo[k], v[i][k]);
+        hi[k] = std::max(hi[k], v[i][k]);
+      }
+      auto q = v[i] * v[i];
+      sqs += q;
+      max_sqs = std::max(max_sqs, q);
+    }
+    benchmark::DoNotOptimize(sum);
+    benchmark::DoNotOptimize(lo);
+    benchmark::DoNotOptimize(hi);
+    benchmark::DoNotOptimize(sqs);
+    benchmark::DoNotOptimize(max_sqs);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(serial_loop, Vector<3>)->Arg(1 << 14)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(serial_loop, Vector<3, float>)->Arg(1 << 14)->Arg(1 << 20);
+
+// single pass with all threads
+template<class V> static void aggregate(benchmark::State &state)
+{
+  auto v = random_vectors<V>(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(Math::aggregate(v));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(aggregate, Vector<3>)->Arg(1 << 14)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(aggregate, Vector<3, float>)->Arg(1 << 14)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(aggregate, PaddedVector<3>)->Arg(1 << 14)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(aggregate, PaddedVector<3, float>)->Arg(1 << 14)->Arg(1 << 20);
@@ -0,0 +1,96 @@
+#include "math/SpaceCurves.h"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  std::vector<Vector3D> random_points(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-10, 10);
+    std::vector<Vector3D> v(n);
+    for (auto &x : v)
+      x = Vector3D(dist(gen), dist(gen), dist(gen));
+    return v;
+  }
+
+  std::vector<uint64_t> random_keys(size_t n)
+  {
+    std::mt19937_64 gen(42);
+    std::vector<uint64_t> keys(n);
+    for (auto &k : keys)
+      k = gen() >> 1;
+    return keys;
+  }
+} // namespace
+
+// keys of quantized points
+template<uint64_t (*key)(const Vector3D &, const Quantizer<3, double> &)>
+  static void encode(benchmark::State &state)
+{
+  auto v = random_points(state.range(0));
+  Quantizer<3, double> q(aggregate(v));
+  std::vector<uint64_t> keys(v.size());
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < v.size(); ++i)
+      keys[i] = key(v[i], q);
+    benchmark::DoNotOptimize(keys.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(encode, morton_key<3, double>)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(encode, hilbert_key<3, double>)->Arg(1 << 20);
+
+// comparison based sort of the indices, what we replace
+static void stable_sort(benchmark::State &state)
+{
+  auto keys = random_keys(state.range(0));
+  std::vector<size_t> p(keys.size());
+  for (auto _ : state)
+  {
+    std::iota(p.begin(), p.end(), size_t(0));
+    std::stable_sort(p.begin(), p.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    benchmark::DoNotOptimize(p.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(stable_sort)->Arg(1 << 16)->Arg(1 << 20);
+
+static void radix_sort(benchmark::State &state)
+{
+  auto keys = random_keys(state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(sort_permutation(keys));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(radix_sort)->Arg(1 << 16)->Arg(1 << 20);
+
+// sum over the points in the memory order, after gathering them in the curve order
+static void gather(benchmark::State &state)
+{
+  auto v = random_points(state.range(0));
+  std::vector<size_t> p(v.size());
+  if (state.range(1) == 0)
+  {
+    std::iota(p.begin(), p.end(), size_t(0));
+    std::shuffle(p.begin(), p.end(), std::mt19937(1));
+  }
+  else
+    p = hilbert_order(v);
+  for (auto _ : state)
+  {
+    Vector3D s;
+    for (size_t i = 1; i < p.size(); ++i)
+      s += v[p[i]] - v[p[i - 1]];
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(gather)->Args({1 << 22, 0})->Args({1 << 22, 1});
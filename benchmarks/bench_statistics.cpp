@@ -0,0 +1,56 @@
+#include "math/Statistics.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  std::vector<Vector3D> random_vectors(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::normal_distribution<double> dist(0, 1);
+    std::vector<Vector3D> v(n);
+    for (auto &x : v)
+      x = Vector3D(10 + dist(gen), dist(gen), -5 + dist(gen));
+    return v;
+  }
+} // namespace
+
+// mean and covariance by two passes over the data
+static void covariance_two_pass(benchmark::State &state)
+{
+  auto v = random_vectors(state.range(0));
+  for (auto _ : state)
+  {
+    Vector3D m;
+    for (auto &x : v)
+      m += x;
+    m /= static_cast<double>(v.size());
+    Tensor3D c;
+    for (auto &x : v)
+    {
+      auto d = x - m;
+      c += d ^ d;
+    }
+    c /= static_cast<double>(v.size());
+    benchmark::DoNotOptimize(c);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(covariance_two_pass)->Arg(1 << 22);
+
+// the same in a single pass, parallel chunks merged
+static void covariance_streaming(benchmark::State &state)
+{
+  auto v = random_vectors(state.range(0));
+  for (auto _ : state)
+  {
+    auto s = statistics(v);
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(covariance_streaming)->Arg(1 << 22);
@@ -0,0 +1,82 @@
+#include "math/SymTensor.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  constexpr size_t n = 1 << 16;
+
+  // field of stress-like symmetric tensors stored either way
+  template<class S> std::vector<S> random_field()
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<S> v(n);
+    for (auto &A : v)
+    {
+      SymTensor3D s(3.);
+      for (auto &x : s)
+        x += dist(gen);
+      A = S(s);
+    }
+    return v;
+  }
+
+  std::vector<Vector3D> random_vectors()
+  {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<Vector3D> v(n);
+    for (auto &x : v)
+      x = Vector3D(dist(gen), dist(gen), dist(gen));
+    return v;
+  }
+} // namespace
+
+template<class S> static void tensor_times_vector(benchmark::State &state)
+{
+  auto A = random_field<S>();
+  auto v = random_vectors();
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      v[i] = A[i] * v[i];
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(tensor_times_vector<Tensor3D>);
+BENCHMARK(tensor_times_vector<SymTensor3D>);
+
+template<class S> static void tensor_invert_field(benchmark::State &state)
+{
+  auto A = random_field<S>();
+  std::vector<S> B(n);
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      B[i] = A[i].invert();
+    benchmark::DoNotOptimize(B.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(tensor_invert_field<Tensor3D>);
+BENCHMARK(tensor_invert_field<SymTensor3D>);
+
+template<class S> static void tensor_axpy(benchmark::State &state)
+{
+  auto A = random_field<S>(), B = random_field<S>();
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      A[i] += 0.5 * B[i];
+    benchmark::DoNotOptimize(A.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(tensor_axpy<Tensor3D>);
+BENCHMARK(tensor_axpy<SymTensor3D>);
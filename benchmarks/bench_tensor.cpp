@@ -0,0 +1,64 @@
+#include "math/Tensor.h"
+#include "RandomTensors.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace Math;
+using Tests::random_tensor;
+
+template<size_t N> static void tensor_det(benchmark::State &state)
+{
+  auto A = random_tensor<N>();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    benchmark::DoNotOptimize(A.det());
+  }
+}
+BENCHMARK(tensor_det<4>);
+BENCHMARK(tensor_det<5>);
+BENCHMARK(tensor_det<6>);
+BENCHMARK(tensor_det<7>);
+BENCHMARK(tensor_det<8>);
+BENCHMARK(tensor_det<10>);
+BENCHMARK(tensor_det<12>);
+
+template<size_t N> static void tensor_invert(benchmark::State &state)
+{
+  auto A = random_tensor<N>();
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    auto B = A.invert();
+    benchmark::DoNotOptimize(B);
+  }
+}
+BENCHMARK(tensor_invert<4>);
+BENCHMARK(tensor_invert<5>);
+BENCHMARK(tensor_invert<6>);
+BENCHMARK(tensor_invert<7>);
+BENCHMARK(tensor_invert<8>);
+BENCHMARK(tensor_invert<10>);
+BENCHMARK(tensor_invert<12>);
+
+template<size_t N> static void tensor_multiply(benchmark::State &state)
+{
+  auto A = random_tensor<N>(), B = random_tensor<N>(7);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(A);
+    benchmark::DoNotOptimize(B);
+    auto C = A * B;
+    benchmark::DoNotOptimize(C);
+  }
+  state.counters["flops"] = benchmark::Counter(2. * N * N * N * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(tensor_multiply<3>);
+BENCHMARK(tensor_multiply<4>);
+BENCHMARK(tensor_multiply<6>);
+BENCHMARK(tensor_multiply<8>);
+BENCHMARK(tensor_multiply<12>);
+BENCHMARK(tensor_multiply<16>);
+BENCHMARK(tensor_multiply<24>);
+BENCHMARK(tensor_multiply<32>);
+BENCHMARK(tensor_multiply<64>);
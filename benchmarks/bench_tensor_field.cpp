@@ -0,0 +1,110 @@
+#include "math/TensorField.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // Jacobians of the quadrature points of a mesh
+  std::vector<Tensor3D> random_tensors(size_t n)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<Tensor3D> v(n);
+    for (auto &A : v)
+    {
+      for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j)
+          A[i][j] = dist(gen);
+      A += Tensor3D(3.);
+    }
+    return v;
+  }
+
+  TensorField<3> random_field(size_t n)
+  {
+    const auto v = random_tensors(n);
+    TensorField<3> f(n);
+    for (size_t k = 0; k < n; ++k)
+      f.set(k, v[k]);
+    return f;
+  }
+} // namespace
+
+// one Tensor::invert() call per tensor of an array of structures
+static void invert_aos(benchmark::State &state)
+{
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto A = random_tensors(n);
+  std::vector<Tensor3D> R(n);
+  for (auto _ : state)
+  {
+    for (size_t k = 0; k < n; ++k)
+      R[k] = A[k].invert();
+    benchmark::DoNotOptimize(R.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(invert_aos)->Arg(1 << 10)->Arg(1 << 16);
+
+static void invert_soa(benchmark::State &state)
+{
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto A = random_field(n);
+  TensorField<3> R(n);
+  std::vector<std::uint8_t> singular(n);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(invert(A, R, singular));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(invert_soa)->Arg(1 << 10)->Arg(1 << 16);
+
+static void invert_transpose_soa(benchmark::State &state)
+{
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto A = random_field(n);
+  TensorField<3> R(n);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(invert_transpose(A, R));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(invert_transpose_soa)->Arg(1 << 10)->Arg(1 << 16);
+
+static void det_aos(benchmark::State &state)
+{
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto A = random_tensors(n);
+  std::vector<double> d(n);
+  for (auto _ : state)
+  {
+    for (size_t k = 0; k < n; ++k)
+      d[k] = A[k].det();
+    benchmark::DoNotOptimize(d.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(det_aos)->Arg(1 << 10)->Arg(1 << 16);
+
+static void det_soa(benchmark::State &state)
+{
+  const auto n = static_cast<size_t>(state.range(0));
+  const auto A = random_field(n);
+  std::vector<double> d(n);
+  for (auto _ : state)
+  {
+    det(A, std::span(d));
+    benchmark::DoNotOptimize(d.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(det_soa)->Arg(1 << 10)->Arg(1 << 16);
@@ -0,0 +1,81 @@
+#include "math/TensorN.h"
+
+#include <benchmark/benchmark.h>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  constexpr size_t ncells = 1024;
+
+  // blocks of the cells, e.g. the species plus the equations
+  template<size_t N> std::vector<Tensor<N>> random_blocks()
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<Tensor<N>> v(ncells);
+    for (auto &A : v)
+    {
+      for (auto &x : A)
+        x = dist(gen);
+      A += Tensor<N>(double(N));
+    }
+    return v;
+  }
+
+  // the per cell work with the temporaries: the update of the block and the solve
+  template<class M, class V> auto cell(const M &A, const M &J, const V &b)
+  {
+    const auto B = A + J * A * 0.5;
+    return b / ~B;
+  }
+} // namespace
+
+// compile-time dimension, everything on stack
+template<size_t N> static void cells_tensor(benchmark::State &state)
+{
+  const auto A = random_blocks<N>();
+  const auto J = random_blocks<N>();
+  const Vector<N> b(1.);
+  for (auto _ : state)
+    for (size_t c = 0; c < ncells; ++c)
+    {
+      auto x = cell(A[c], J[c], b);
+      benchmark::DoNotOptimize(x);
+    }
+  state.SetItemsProcessed(state.iterations() * ncells);
+}
+BENCHMARK(cells_tensor<4>);
+BENCHMARK(cells_tensor<8>);
+BENCHMARK(cells_tensor<16>);
+
+// runtime dimension, the temporaries from the given resource
+template<size_t N, bool UseArena> static void cells_tensor_n(benchmark::State &state)
+{
+  const auto A = random_blocks<N>();
+  const auto J = random_blocks<N>();
+  std::byte buffer[1 << 16];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+  auto *mr = UseArena? static_cast<std::pmr::memory_resource*>(&arena) : std::pmr::new_delete_resource();
+  for (auto _ : state)
+    for (size_t c = 0; c < ncells; ++c)
+    {
+      {
+        const TensorN<> An(A[c], mr), Jn(J[c], mr);
+        const VectorN<> b(N, 1., mr);
+        auto x = cell(An, Jn, b);
+        benchmark::DoNotOptimize(x.begin());
+      }
+      arena.release();
+    }
+  state.SetItemsProcessed(state.iterations() * ncells);
+}
+BENCHMARK(cells_tensor_n<4, false>);
+BENCHMARK(cells_tensor_n<4, true>);
+BENCHMARK(cells_tensor_n<8, false>);
+BENCHMARK(cells_tensor_n<8, true>);
+BENCHMARK(cells_tensor_n<16, false>);
+BENCHMARK(cells_tensor_n<16, true>);
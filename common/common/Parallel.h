@@ -0,0 +1,106 @@
+#ifndef PARALLEL_H_INCLUDED
+#define PARALLEL_H_INCLUDED
+
+/*!
+  \file Parallel.h
+  \author gennadiy
+  \brief Minimal fork-join helpers: static partition of an index range over threads.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Parallel
+{
+  namespace details
+  {
+    inline std::atomic<size_t>& concurrency_limit() noexcept
+    {
+      static std::atomic<size_t> limit = 0;
+      return limit;
+    }
+  } // namespace details
+
+  // number of threads used by the algorithms below
+  inline size_t concurrency() noexcept
+  {
+    if (size_t n = details::concurrency_limit().load(std::memory_order_relaxed))
+      return n;
+    return std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // 0 restores the default, i.e. the number of hardware threads
+  inline void set_concurrency(size_t n) noexcept
+  {
+    details::concurrency_limit().store(n, std::memory_order_relaxed);
+  }
+
+  // [0, n) split into nearly equal consecutive chunks, one per thread
+  struct Partition
+  {
+    size_t n = 0;       // number of indices
+    size_t nchunks = 0; // number of chunks
+
+    size_t first(size_t c) const noexcept { return c * n / nchunks; }
+    size_t last(size_t c) const noexcept { return (c + 1) * n / nchunks; }
+  };
+
+  // chunks are not smaller than grain (unless n is), and there are no more of them than threads
+  inline Partition partition(size_t n, size_t grain) noexcept
+  {
+    size_t nchunks = std::min(concurrency(), std::max<size_t>(n / std::max<size_t>(grain, 1), 1));
+    return {n, (n == 0)? 0 : nchunks};
+  }
+
+  // calls f(c, first, last) for all chunks in parallel, the last chunk runs in the calling thread;
+  // f must not throw
+  template<class F> void run(const Partition &p, F &&f)
+  {
+    if (p.nchunks == 0)
+      return;
+
+    std::vector<std::jthread> threads;
+    threads.reserve(p.nchunks - 1);
+    for (size_t c = 0; c + 1 < p.nchunks; ++c)
+      threads.emplace_back([&f, &p, c] { f(c, p.first(c), p.last(c)); });
+    f(p.nchunks - 1, p.first(p.nchunks - 1), p.n);
+  }
+
+  // calls f(first, last) for consecutive chunks of [0, n) in parallel
+  template<class F> void for_chunks(size_t n, size_t grain, F &&f)
+  {
+    run(partition(n, grain), [&f](size_t, size_t first, size_t last) { f(first, last); });
+  }
+
+  // calls f(i) for all i in [0, n) in parallel
+  template<class F> void for_each(size_t n, size_t grain, F &&f)
+  {
+    for_chunks(n, grain, [&f](size_t first, size_t last)
+    {
+      for (size_t i = first; i < last; ++i)
+        f(i);
+    });
+  }
+
+  // combine(...combine(combine(init, map(first0, last0)), map(first1, last1))...),
+  // chunks are mapped in parallel and combined in their order, thus the result is
+  // deterministic for the given number of threads
+  template<class R, class Map, class Combine>
+    R reduce(size_t n, size_t grain, R init, Map &&map, Combine &&combine)
+  {
+    auto p = partition(n, grain);
+    if (p.nchunks == 1)
+      return combine(std::move(init), map(size_t(0), n));
+
+    std::vector<R> partial(p.nchunks, init);
+    run(p, [&](size_t c, size_t first, size_t last) { partial[c] = map(first, last); });
+    for (auto &r : partial)
+      init = combine(std::move(init), std::move(r));
+    return init;
+  }
+} // namespace Parallel
+
+#endif // PARALLEL_H_INCLUDED
@@ -0,0 +1,269 @@
+#ifndef MATH_BLOCK_SPARSE_H_INCLUDED
+#define MATH_BLOCK_SPARSE_H_INCLUDED
+
+/*!
+  \file BlockSparse.h
+  \author gennadiy
+  \brief Block compressed sparse row (BSR) matrix of tensors and its products with block vectors,
+    definition, documentation and tests.
+*/
+
+#include "Ragged.h"
+#include "Tensor.h"
+#include "simd.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Math
+{
+  template<size_t N, Type T = double> class BlockSparse
+  {
+    Ragged<std::uint32_t> cols; // columns of the blocks row by row, ascending in each row
+    std::vector<Tensor<N, T>, simd::allocator<Tensor<N, T>>> blocks; // in the order of cols
+    size_t nc = 0;
+
+  public:
+    using block_type = Tensor<N, T>;
+    using vector_type = Vector<N, T>;
+
+    // ctors
+    BlockSparse() = default;
+    // zero blocks in the pattern, i.e. the columns of the blocks of each row, the rows are sorted
+    BlockSparse(Ragged<std::uint32_t> pattern, size_t ncols);
+
+    // sizes in blocks
+    size_t nrows() const noexcept { return cols.size(); }
+    size_t ncols() const noexcept { return nc; }
+    size_t nblocks() const noexcept { return blocks.size(); }
+
+    // the row pointers of CSR and the columns of the blocks
+    const RaggedIndex& index() const noexcept { return cols.index(); }
+    std::span<const std::uint32_t> columns(size_t i) const noexcept { return cols[i]; }
+    std::span<const std::uint32_t> columns() const noexcept { return cols.values(); }
+
+    // access to the blocks of the rows and to all of them, no allocations
+    std::span<block_type> row(size_t i) noexcept
+      { return {blocks.data() + index().first(i), index().row_size(i)}; }
+    std::span<const block_type> row(size_t i) const noexcept
+      { return {blocks.data() + index().first(i), index().row_size(i)}; }
+    std::span<block_type> values() noexcept { return blocks; }
+    std::span<const block_type> values() const noexcept { return blocks; }
+
+    // block (i, j) or nullptr if it isn't in the pattern, O(log(row size))
+    block_type* find(size_t i, size_t j) noexcept;
+    const block_type* find(size_t i, size_t j) const noexcept;
+  }; // class BlockSparse<N, T>
+
+/*---------------------------------------------------------------------------------------*/
+
+  // y = A x, the rows are split over the threads, x has A.ncols() and y A.nrows() vectors
+  template<size_t N, Type T>
+    void multiply(const BlockSparse<N, T> &A, std::type_identity_t<std::span<const Vector<N, T>>> x,
+                  std::type_identity_t<std::span<Vector<N, T>>> y);
+
+  // y = ~A x, x has A.nrows() and y A.ncols() vectors; the threads scatter to their own buffers
+  // covering the columns of their rows, which are summed in the order of the rows, thus
+  // the result is deterministic for the given number of threads
+  template<size_t N, Type T>
+    void multiply_transpose(const BlockSparse<N, T> &A, std::type_identity_t<std::span<const Vector<N, T>>> x,
+                            std::type_identity_t<std::span<Vector<N, T>>> y);
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definition ---------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    BlockSparse<N, T>::BlockSparse(Ragged<std::uint32_t> pattern, size_t ncols)
+      : cols(std::move(pattern)), blocks(cols.nvalues()), nc(ncols)
+  {
+    Parallel::for_each(nrows(), 1 << 10, [this](size_t i)
+    {
+      std::ranges::sort(cols[i]);
+      assert(std::ranges::adjacent_find(cols[i]) == cols[i].end());
+      assert(cols[i].empty() || cols[i].back() < nc);
+    });
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    auto BlockSparse<N, T>::find(size_t i, size_t j) noexcept -> block_type*
+  {
+    return const_cast<block_type*>(std::as_const(*this).find(i, j));
+  }
+
+  template<size_t N, Type T>
+    auto BlockSparse<N, T>::find(size_t i, size_t j) const noexcept -> const block_type*
+  {
+    assert(i < nrows() && j < ncols());
+    const auto c = cols[i];
+    const auto it = std::ranges::lower_bound(c, j);
+    return (it != c.end() && *it == j)? &blocks[index().first(i) + (it - c.begin())] : nullptr;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  namespace details::impl
+  {
+    // rows per chunk of the products, enough to amortize a thread
+    inline constexpr size_t bsr_grain = 1 << 12;
+
+    // y = sum A[k] x[c[k]] over the blocks of a row: the products are accumulated componentwise
+    // in N*N lanes, i.e. contiguous loads of the blocks and no reduction inside the loop,
+    // the rows of the lanes are summed once per row
+    template<size_t N, class T>
+      Vector<N, T> bsr_row(const Tensor<N, T> *a, const std::uint32_t *c, size_t n, const Vector<N, T> *x) noexcept
+    {
+      T acc[N*N] = {};
+      for (size_t k = 0; k < n; ++k)
+      {
+        const T *b = a[k].begin();
+        const auto &xk = x[c[k]];
+        for (size_t i = 0; i < N; ++i)
+          for (size_t j = 0; j < N; ++j)
+            acc[i*N + j] += b[i*N + j] * xk[j];
+      }
+      Vector<N, T> y;
+      for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < N; ++j)
+          y[i] += acc[i*N + j];
+      return y;
+    }
+
+    // y[c[k] - c0] += ~A[k] x over the blocks of a row, the rows of the blocks are axpy's
+    template<size_t N, class T>
+      void bsr_row_transpose(const Tensor<N, T> *a, const std::uint32_t *c, size_t n, const Vector<N, T> &x,
+                             Vector<N, T> *y, size_t c0 = 0) noexcept
+    {
+      for (size_t k = 0; k < n; ++k)
+      {
+        const T *b = a[k].begin();
+        auto &yk = y[c[k] - c0];
+        for (size_t i = 0; i < N; ++i)
+          for (size_t j = 0; j < N; ++j)
+            yk[j] += b[i*N + j] * x[i];
+      }
+    }
+  } // namespace details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    void multiply(const BlockSparse<N, T> &A, std::type_identity_t<std::span<const Vector<N, T>>> x,
+                  std::type_identity_t<std::span<Vector<N, T>>> y)
+  {
+    assert(x.size() == A.ncols() && y.size() == A.nrows());
+    const auto rows = A.index().offsets();
+    const auto *a = A.values().data();
+    const auto *c = A.columns().data();
+    Parallel::for_chunks(A.nrows(), details::impl::bsr_grain, [&](size_t first, size_t last)
+    {
+      for (size_t i = first; i < last; ++i)
+        y[i] = details::impl::bsr_row(a + rows[i], c + rows[i], rows[i + 1] - rows[i], x.data());
+    });
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    void multiply_transpose(const BlockSparse<N, T> &A, std::type_identity_t<std::span<const Vector<N, T>>> x,
+                            std::type_identity_t<std::span<Vector<N, T>>> y)
+  {
+    assert(x.size() == A.nrows() && y.size() == A.ncols());
+    const auto rows = A.index().offsets();
+    const auto *a = A.values().data();
+    const auto *c = A.columns().data();
+    std::ranges::fill(y, Vector<N, T>());
+
+    const auto p = Parallel::partition(A.nrows(), details::impl::bsr_grain);
+    if (p.nchunks <= 1)
+    {
+      for (size_t i = 0; i < A.nrows(); ++i)
+        details::impl::bsr_row_transpose(a + rows[i], c + rows[i], rows[i + 1] - rows[i], x[i], y.data());
+      return;
+    }
+
+    // columns [lo, hi) of the chunks, e.g. narrow bands for the meshes in the space curve order
+    std::vector<size_t> lo(p.nchunks), hi(p.nchunks);
+    std::vector<std::vector<Vector<N, T>>> partial(p.nchunks);
+    Parallel::run(p, [&](size_t ch, size_t first, size_t last)
+    {
+      const auto [cmin, cmax] = std::minmax_element(c + rows[first], c + rows[last]);
+      lo[ch] = (rows[first] == rows[last])? 0 : *cmin;
+      hi[ch] = (rows[first] == rows[last])? 0 : *cmax + size_t(1);
+      auto &buf = partial[ch];
+      buf.assign(hi[ch] - lo[ch], Vector<N, T>());
+      for (size_t i = first; i < last; ++i)
+        details::impl::bsr_row_transpose(a + rows[i], c + rows[i], rows[i + 1] - rows[i], x[i],
+                                         buf.data(), lo[ch]);
+    });
+    Parallel::for_chunks(A.ncols(), details::impl::bsr_grain, [&](size_t first, size_t last)
+    {
+      for (size_t ch = 0; ch < p.nchunks; ++ch)
+      {
+        const size_t from = std::max(first, lo[ch]), to = std::min(last, hi[ch]);
+        for (size_t j = from; j < to; ++j)
+          y[j] += partial[ch][j - lo[ch]];
+      }
+    });
+  }
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::BlockSparses::tests
+{
+  static_assert(std::is_same_v<BlockSparse<3>::block_type, Tensor3D>);
+  static_assert(std::is_same_v<decltype(std::declval<const BlockSparse<2>&>().row(0)), std::span<const Tensor2D>>);
+} // namespace Math::BlockSparses::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::BlockSparse
+  \brief Block compressed sparse row (BSR) matrix, its nonzeros are N x N tensors.
+  \tparam N Dimension of the blocks, e.g. the number of unknowns of a cell.
+  \tparam T Type of the components.
+
+  The columns of the blocks are a Math::Ragged array (the row pointers are its index), the blocks
+  are stored one after another in the same order in a single aligned buffer. The pattern is fixed
+  at construction, the values are assembled through row(), find() or values():
+  \code
+  Ragged<std::uint32_t> pattern(counts);        // neighbours of the cells incl. themselves
+  ... fill pattern ...
+  BlockSparse<4> A(std::move(pattern), ncells);
+  Parallel::for_each(ncells, 1024, [&](size_t i) { assemble(i, A.columns(i), A.row(i)); });
+  multiply(A, x, y);                              // y = A x, spans of Vector<4>
+  \endcode
+  The products are memory bound: every block is read once, thus the rate is about
+  nblocks() * (N*N*sizeof(T) + 4) bytes per product, compare with the STREAM triad of
+  benchmarks/bench_block_sparse.cpp. Order the cells along a space filling curve
+  (Math::hilbert_order) for the reuse of x and narrow columns ranges of the threads
+  of multiply_transpose().
+*/
+
+/*!
+  \fn void multiply(const BlockSparse &A, std::span<const Vector<N, T>> x, std::span<Vector<N, T>> y)
+  \brief Block sparse matrix-vector product, y = A x.
+  \param A Matrix.
+  \param x Block vector of A.ncols() vectors, must not overlap y.
+  \param y Result, A.nrows() vectors.
+*/
+
+/*!
+  \fn void multiply_transpose(const BlockSparse &A, std::span<const Vector<N, T>> x, std::span<Vector<N, T>> y)
+  \brief Transposed block sparse matrix-vector product, y = ~A x, without the transpose of A.
+  \param A Matrix.
+  \param x Block vector of A.nrows() vectors, must not overlap y.
+  \param y Result, A.ncols() vectors.
+*/
+
+#endif // MATH_BLOCK_SPARSE_H_INCLUDED
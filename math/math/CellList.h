@@ -0,0 +1,247 @@
+#ifndef MATH_CELL_LIST_H_INCLUDED
+#define MATH_CELL_LIST_H_INCLUDED
+
+/*!
+  \file CellList.h
+  \author gennadiy
+  \brief Uniform grid of cells for fixed radius neighbour search, definition and documentation.
+*/
+
+#include "Reductions.h"
+#include "common/Parallel.h"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Math
+{
+  // points sorted into the cells of a uniform grid, cells are not smaller than the cutoff
+  template<size_t N, std::floating_point T = double> class CellList
+  {
+  public:
+    using point_type = Vector<N, T>;
+
+    explicit CellList(T cutoff) noexcept : rc(cutoff) { assert(cutoff > T()); }
+    template<std::ranges::random_access_range R>
+      CellList(T cutoff, const R &points) : CellList(cutoff) { rebuild(points); }
+
+    // sorts the points into the cells in O(n), the buffers are reused between calls
+    template<std::ranges::random_access_range R> void rebuild(const R &points);
+
+    T cutoff() const noexcept { return rc; }
+    T cell_size() const noexcept { return h; }
+    size_t size() const noexcept { return pts.size(); }
+    size_t ncells() const noexcept { return start.size() - 1; }
+
+    // points in the cell order and their indices in the original range
+    std::span<const point_type> points() const noexcept { return pts; }
+    std::span<const size_t> indices() const noexcept { return idx; }
+
+    // calls f(k, sqr_distance) for all points()[k] within the cutoff of q
+    template<class F> void neighbours(const point_type &q, F &&f) const;
+    // the same for q = points()[k] except the point itself
+    template<class F> void neighbours_of(size_t k, F &&f) const;
+
+  private:
+    T rc;                             // cutoff
+    T h = T();                        // cell size
+    point_type lo;                    // origin of the grid
+    std::array<uint32_t, N> dims = {}; // number of cells along the axes
+    std::vector<size_t> start = {0};  // points of cell c are [start[c], start[c + 1])
+    std::vector<point_type> pts;
+    std::vector<size_t> idx;
+    std::vector<uint32_t> cells;              // cell of each point in the original order
+    std::vector<std::vector<size_t>> counts;  // per chunk histograms
+
+    template<class F> void visit(const point_type &q, size_t self, F &f) const;
+  }; // class CellList<N, T>
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+template<std::ranges::random_access_range R>
+  void Math::CellList<N, T>::rebuild(const R &points)
+{
+  const auto n = static_cast<size_t>(std::ranges::distance(points));
+  auto it = std::ranges::begin(points);
+
+  // the grid covers the bounding box, cells are enlarged if there are more of them than points
+  auto box = aggregate(points);
+  lo = box.lo;
+  h = rc;
+  // the numbers of cells are counted in double, e.g. extent/rc may exceed the range of uint32_t
+  double d[N];
+  for (;;)
+  {
+    double total = 1;
+    for (size_t c = 0; c < N; ++c)
+    {
+      d[c] = (n == 0)? 1 : std::floor(static_cast<double>(box.hi[c] - box.lo[c]) / h) + 1;
+      total *= d[c];
+    }
+    if (total <= std::max<double>(n, 1))
+      break;
+    h *= static_cast<T>(std::pow(total / std::max<double>(n, 1), 1./N));
+  }
+  for (size_t c = 0; c < N; ++c)
+    dims[c] = static_cast<uint32_t>(d[c]);
+
+  // counting sort: histograms of the chunks, offsets ordered by cell then by chunk, scattering
+  auto part = Parallel::partition(n, 1 << 14);
+  size_t nc = 1;
+  for (auto d : dims)
+    nc *= d;
+  cells.resize(n);
+  counts.resize(part.nchunks);
+  Parallel::run(part, [&](size_t ch, size_t first, size_t last)
+  {
+    auto &count = counts[ch];
+    count.assign(nc, 0);
+    for (size_t i = first; i < last; ++i)
+    {
+      point_type p(it[i]);
+      uint32_t id = 0;
+      for (size_t c = N; c-- > 0;)
+      {
+        auto x = static_cast<uint32_t>((p[c] - lo[c]) / h);
+        id = id * dims[c] + std::min(x, dims[c] - 1);
+      }
+      cells[i] = id;
+      ++count[id];
+    }
+  });
+
+  start.resize(nc + 1);
+  size_t total = 0;
+  for (size_t id = 0; id < nc; ++id)
+  {
+    start[id] = total;
+    for (auto &count : counts)
+      total += std::exchange(count[id], total);
+  }
+  start[nc] = total;
+
+  pts.resize(n);
+  idx.resize(n);
+  Parallel::run(part, [&](size_t ch, size_t first, size_t last)
+  {
+    auto &offset = counts[ch];
+    for (size_t i = first; i < last; ++i)
+    {
+      size_t k = offset[cells[i]]++;
+      pts[k] = point_type(it[i]);
+      idx[k] = i;
+    }
+  });
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+template<class F>
+  void Math::CellList<N, T>::visit(const point_type &q, size_t self, F &f) const
+{
+  if (pts.empty())
+    return;
+
+  // cell of the query, it may be outside of the grid
+  std::array<int64_t, N> cell;
+  for (size_t c = 0; c < N; ++c)
+    cell[c] = static_cast<int64_t>(std::floor((q[c] - lo[c]) / h));
+
+  // runs of 3 cells along x are contiguous, the runs are visited in the memory order
+  constexpr size_t nruns = [] { size_t r = 1; for (size_t c = 1; c < N; ++c) r *= 3; return r; }();
+  const T rc2 = rc * rc;
+  const int64_t x0 = std::max<int64_t>(cell[0] - 1, 0);
+  const int64_t x1 = std::min<int64_t>(cell[0] + 1, int64_t(dims[0]) - 1);
+  if (x0 > x1)
+    return;
+  for (size_t r = 0; r < nruns; ++r)
+  {
+    int64_t id = 0;
+    bool inside = true;
+    for (size_t c = N - 1, rest = r; c > 0; --c)
+    {
+      size_t stride = 1;
+      for (size_t k = 1; k < c; ++k)
+        stride *= 3;
+      int64_t x = cell[c] - 1 + static_cast<int64_t>(rest / stride);
+      rest %= stride;
+      inside = inside && x >= 0 && x < int64_t(dims[c]);
+      id = id * dims[c] + x;
+    }
+    if (!inside)
+      continue;
+
+    id *= dims[0];
+    for (size_t k = start[id + x0], last = start[id + x1 + 1]; k < last; ++k)
+    {
+      auto d = pts[k] - q;
+      T d2 = d * d;
+      if (d2 <= rc2 && k != self)
+        f(k, d2);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+template<class F>
+  void Math::CellList<N, T>::neighbours(const point_type &q, F &&f) const
+{
+  visit(q, size(), f);
+}
+
+template<size_t N, std::floating_point T>
+template<class F>
+  void Math::CellList<N, T>::neighbours_of(size_t k, F &&f) const
+{
+  assert(k < size());
+  visit(pts[k], k, f);
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::CellList
+  \brief Uniform grid of cells over a set of moving points for fixed radius neighbour search.
+  \tparam N Number of dimensions.
+  \tparam T Floating point type of the coordinates.
+
+  Cells are not smaller than the cutoff radius, thus the neighbours of a point are in its cell
+  and the adjacent ones. The grid covers the bounding box of the points, if it has more cells
+  than points, the cells are enlarged. Cells are numbered in the row-major order with x
+  fastest, so that 3 adjacent cells along x are contiguous in memory and a neighbourhood is
+  scanned as 3^(N-1) contiguous runs in the increasing memory order.
+
+  Unlike Math::KdTree, rebuilding is a counting sort in O(n): the bounding box, cell histograms
+  and scattering of the points run in parallel by Parallel::concurrency() threads, the order of
+  the points within a cell is their order in the range. Typical use per time step:
+  \code
+  cells.rebuild(x);
+  Parallel::for_each(cells.size(), 1024, [&](size_t k)
+  {
+    cells.neighbours_of(k, [&](size_t j, double d2) { ... }); // k, j are positions in cells.points()
+  });
+  \endcode
+  Data attached to the points can be reordered by cells.indices() for the best locality.
+*/
+
+/*!
+  \fn void Math::CellList::neighbours(const point_type &q, F &&f) const
+  \brief Calls f(k, sqr_distance) for all points()[k] within the cutoff of q.
+  \param q Point, it may be outside the bounding box of the points.
+  \param f Function object, the points come ordered by cells.
+*/
+
+#endif // MATH_CELL_LIST_H_INCLUDED
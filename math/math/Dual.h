@@ -0,0 +1,254 @@
+#ifndef MATH_DUAL_H_INCLUDED
+#define MATH_DUAL_H_INCLUDED
+
+/*!
+  \file Dual.h
+  \author gennadiy
+  \brief Dual numbers for forward-mode automatic differentiation, definition, documentation and tests.
+*/
+
+#include "Tensor.h"
+#include <cassert>
+#include <cmath>
+#include <compare>
+#include <ostream>
+#include <span>
+
+namespace Math
+{
+  // value with its derivatives along N directions (lanes), arithmetic follows the chain rule
+  template<std::floating_point T, size_t N> class Dual
+  {
+    T v = 0;
+    T d[N] = {};
+    static_assert(N != 0, "Dual number w/o derivatives is meaningless.");
+
+  public:
+    using value_type = T;
+    static constexpr size_t nlanes = N;
+
+    // ctors, constants have zero derivatives
+    constexpr Dual() noexcept = default;
+    template<class A> requires std::is_arithmetic_v<A>
+      constexpr Dual(A value) noexcept : v(static_cast<T>(value)) {}
+
+    // independent variable, i.e. the derivative along lane is 1
+    static constexpr Dual variable(T value, size_t lane) noexcept;
+
+    // access
+    constexpr T value() const noexcept { return v; }
+    constexpr T& value() noexcept { return v; }
+    constexpr T derivative(size_t i) const noexcept { assert(i < N); return d[i]; }
+    constexpr T& derivative(size_t i) noexcept { assert(i < N); return d[i]; }
+    constexpr std::span<const T, N> derivatives() const noexcept { return std::span<const T, N>(d); }
+    constexpr std::span<T, N> derivatives() noexcept { return std::span<T, N>(d); }
+
+    // unary ops
+    constexpr Dual operator+() const noexcept { return *this; }
+    constexpr Dual operator-() const noexcept;
+
+    // assign-ops
+    constexpr Dual& operator+=(const Dual &a) noexcept;
+    constexpr Dual& operator-=(const Dual &a) noexcept;
+    constexpr Dual& operator*=(const Dual &a) noexcept;
+    constexpr Dual& operator/=(const Dual &a) noexcept;
+
+    // arithmetic ops
+    friend constexpr Dual operator+(Dual a, const Dual &b) noexcept { return a += b; }
+    friend constexpr Dual operator-(Dual a, const Dual &b) noexcept { return a -= b; }
+    friend constexpr Dual operator*(Dual a, const Dual &b) noexcept { return a *= b; }
+    friend constexpr Dual operator/(Dual a, const Dual &b) noexcept { return a /= b; }
+
+    // comparison ops compare values only, as branches of the differentiated code do
+    friend constexpr bool operator==(const Dual &a, const Dual &b) noexcept { return a.v == b.v; }
+    friend constexpr auto operator<=>(const Dual &a, const Dual &b) noexcept { return a.v <=> b.v; }
+
+    // elementary functions, found by argument-dependent lookup (details::sqrt included)
+    friend Dual sqrt(const Dual &a) noexcept { T r = std::sqrt(a.v); return a.chain(r, T(0.5) / r); }
+    friend Dual exp(const Dual &a) noexcept { T r = std::exp(a.v); return a.chain(r, r); }
+    friend Dual log(const Dual &a) noexcept { return a.chain(std::log(a.v), T(1) / a.v); }
+    friend Dual sin(const Dual &a) noexcept { return a.chain(std::sin(a.v), std::cos(a.v)); }
+    friend Dual cos(const Dual &a) noexcept { return a.chain(std::cos(a.v), -std::sin(a.v)); }
+    friend Dual pow(const Dual &a, T p) noexcept { return a.chain(std::pow(a.v, p), p * std::pow(a.v, p - 1)); }
+    friend constexpr Dual abs(const Dual &a) noexcept { return (a.v < 0)? -a : a; }
+
+    // IO ops, e.g. 1.5[0, 1, 0]
+    friend std::ostream& operator<<(std::ostream &out, const Dual &a)
+    {
+      out << a.v << '[';
+      for (size_t i = 0; i < N; ++i)
+        out << (i? ", " : "") << a.d[i];
+      return out << ']';
+    }
+
+  private:
+    // f(a) given f(a.value) and f'(a.value)
+    constexpr Dual chain(T f, T df) const noexcept;
+  }; // class Dual<T, N>
+
+/*---------------------------------------------------------------------------------------*/
+
+  // vector of independent variables along the lanes first, first + 1, ...
+  template<size_t M, size_t N, std::floating_point T, bool B, class L>
+    constexpr Vector<N, Dual<T, M>, B, L> variables(const Vector<N, T, B, L> &x, size_t first = 0) noexcept;
+
+  // J[i][j] = df[i]/dx[j] of f = f(variables<N>(x))
+  template<size_t N, std::floating_point T, bool B, class L>
+    constexpr Tensor<N, T> jacobian(const Vector<N, Dual<T, N>, B, L> &f) noexcept;
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+template<std::floating_point T, size_t N>
+  constexpr auto Math::Dual<T, N>::variable(T value, size_t lane) noexcept -> Dual
+{
+  assert(lane < N);
+  Dual r(value);
+  r.d[lane] = 1;
+  return r;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::floating_point T, size_t N>
+  constexpr auto Math::Dual<T, N>::operator-() const noexcept -> Dual
+{
+  Dual r;
+  r.v = -v;
+  for (size_t i = 0; i < N; ++i)
+    r.d[i] = -d[i];
+  return r;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+// NB! the loops over the lanes have the fixed length and are unrolled and vectorized
+
+template<std::floating_point T, size_t N>
+  constexpr auto Math::Dual<T, N>::operator+=(const Dual &a) noexcept -> Dual&
+{
+  v += a.v;
+  for (size_t i = 0; i < N; ++i)
+    d[i] += a.d[i];
+  return *this;
+}
+
+template<std::floating_point T, size_t N>
+  constexpr auto Math::Dual<T, N>::operator-=(const Dual &a) noexcept -> Dual&
+{
+  v -= a.v;
+  for (size_t i = 0; i < N; ++i)
+    d[i] -= a.d[i];
+  return *this;
+}
+
+template<std::floating_point T, size_t N>
+  constexpr auto Math::Dual<T, N>::operator*=(const Dual &a) noexcept -> Dual&
+{
+  // (uv)' = u'v + uv'
+  for (size_t i = 0; i < N; ++i)
+    d[i] = d[i] * a.v + v * a.d[i];
+  v *= a.v;
+  return *this;
+}
+
+template<std::floating_point T, size_t N>
+  constexpr auto Math::Dual<T, N>::operator/=(const Dual &a) noexcept -> Dual&
+{
+  // (u/v)' = (u' - (u/v) v')/v
+  const T r = T(1) / a.v, q = v * r;
+  for (size_t i = 0; i < N; ++i)
+    d[i] = (d[i] - q * a.d[i]) * r;
+  v = q;
+  return *this;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::floating_point T, size_t N>
+  constexpr auto Math::Dual<T, N>::chain(T f, T df) const noexcept -> Dual
+{
+  Dual r;
+  r.v = f;
+  for (size_t i = 0; i < N; ++i)
+    r.d[i] = df * d[i];
+  return r;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t M, size_t N, std::floating_point T, bool B, class L>
+  constexpr Math::Vector<N, Math::Dual<T, M>, B, L> Math::variables(const Vector<N, T, B, L> &x, size_t first) noexcept
+{
+  assert(first + N <= M);
+  Vector<N, Dual<T, M>, B, L> r;
+  for (size_t i = 0; i < N; ++i)
+    r[i] = Dual<T, M>::variable(x[i], first + i);
+  return r;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T, bool B, class L>
+  constexpr Math::Tensor<N, T> Math::jacobian(const Vector<N, Dual<T, N>, B, L> &f) noexcept
+{
+  Tensor<N, T> J;
+  for (size_t i = 0; i < N; ++i)
+    for (size_t j = 0; j < N; ++j)
+      J[i][j] = f[i].derivative(j);
+  return J;
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::Duals::tests
+{
+  using D = Dual<double, 2>;
+  static_assert(Type<D> && !Pack<D>, "Type failed");
+
+  constexpr auto x = D::variable(3, 0), y = D::variable(-2, 1);
+  constexpr auto f = x * x * y + x / y - 1; // df/dx = 2xy + 1/y, df/dy = x^2 - x/y^2
+  static_assert(f.value() == -18 - 1.5 - 1, "value failed");
+  static_assert(f.derivative(0) == -12 - 0.5 && f.derivative(1) == 9 - 0.75, "derivatives failed");
+  static_assert((-x).derivative(0) == -1 && abs(y).derivative(1) == -1, "unary failed");
+  static_assert(x == 3 && x > y && D(3) == x, "comparison failed");
+
+  // vectors and tensors of duals
+  constexpr auto v = variables<3>(Vector3D(1, 2, 3));
+  constexpr auto s = v * v; // d|v|^2/dv = 2v
+  static_assert(s.value() == 14 && s.derivative(0) == 2 && s.derivative(2) == 6, "dot product failed");
+  constexpr auto J = jacobian(v % Vector<3, Dual<double, 3>>(0, 0, 1));
+  static_assert(J == Tensor3D(0, 1, 0, -1, 0, 0, 0, 0, 0), "jacobian failed");
+  static_assert(Tensor<2, D>(x, y, 1, 2).det().derivative(0) == 2, "tensor failed");
+} // namespace Math::Duals::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::Dual
+  \brief Dual number for forward-mode automatic differentiation.
+  \tparam T Floating point type of the value and derivatives.
+  \tparam N Number of derivative lanes, i.e. independent variables differentiated at once.
+
+  Carries a value and its derivatives with respect to N independent variables. Arithmetic
+  and the elementary functions (sqrt, exp, log, sin, cos, pow, abs) apply the chain rule,
+  so any code written for Math::Type computes the exact derivatives along with the values:
+  Vector<3, Dual<double, 5>>, Tensor<3, Dual<double, 5>> or Quantities::State of duals work
+  with the existing operators. The loops over the lanes have the fixed length N and are
+  vectorized by the compiler, hence a whole row of a Jacobian costs one evaluation:
+  \code
+  auto x = Math::variables<3>(x0);   // Vector<3, Dual<double, 3>>, dx[i]/dx[j] = delta_ij
+  auto r = residual(x);              // the same code as for Vector3D
+  auto J = Math::jacobian(r);        // Tensor3D, J[i][j] = dr[i]/dx[j]
+  \endcode
+  Comparisons use the values only (as the branches of the differentiated code do),
+  thus \c == doesn't check the derivatives.
+*/
+
+#endif // MATH_DUAL_H_INCLUDED
@@ -0,0 +1,778 @@
+#ifndef MATH_EIGENSYSTEM_H_INCLUDED
+#define MATH_EIGENSYSTEM_H_INCLUDED
+
+/*!
+  \file Eigensystem.h
+  \author gennadiy
+  \brief Eigenvalues and eigenvectors of symmetric 2x2 and 3x3 tensors, one by one and batched
+    over tensor fields, definition, documentation and tests.
+*/
+
+#include "FastMath.h"
+#include "SymTensor.h"
+#include "TensorField.h"
+#include "VectorField.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <span>
+
+namespace Math
+{
+  template<size_t N, std::floating_point T = double> struct Eigensystem
+  {
+    Vector<N, T> values;  // ascending
+    Tensor<N, T> vectors; // vectors[k] is the unit eigenvector of values[k]
+  };
+
+/*---------------------------------------------------------------------------------------*/
+
+  // analytic: closed form in 2D, Cardano's formula in 3D
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    Vector<N, T> eigenvalues(const SymTensor<N, T> &A) noexcept;
+
+  // analytic, eigenvectors of the most separated eigenvalue and of the 2x2 rest in its orthogonal plane
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    Eigensystem<N, T> eigen(const SymTensor<N, T> &A) noexcept;
+
+  // cyclic Jacobi rotations until the off-diagonal part vanishes relative to the diagonal,
+  // at most sweeps of them
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    constexpr Eigensystem<N, T> eigen_jacobi(const SymTensor<N, T> &A, int sweeps = 16) noexcept;
+
+/*---------------------------------------------------------------------------------------*/
+
+  // the same over tensor fields, only the upper triangles of A are used, vectors.component(k, j)
+  // is the component j of the eigenvector k, values and vectors must have the size of A
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void eigenvalues(const TensorField<N, T> &A, VectorField<N, T> &values) noexcept;
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void eigen(const TensorField<N, T> &A, VectorField<N, T> &values, TensorField<N, T> &vectors) noexcept;
+
+  // exactly sweeps of Jacobi rotations for all the tensors
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void eigen_jacobi(const TensorField<N, T> &A, VectorField<N, T> &values, TensorField<N, T> &vectors,
+      int sweeps = 6) noexcept;
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definition ---------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+  namespace details::impl
+  {
+    // the batched kernels go over blocks of tensors by stages, the loops over the tensors are
+    // vectorized and the square roots of a block are taken at once between them
+    inline constexpr size_t eigen_block = 128;
+
+    template<class T> void block_sqrt(T *x, size_t n) noexcept
+    {
+      if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        Math::sqrt(std::span<const T>(x, n), std::span<T>(x, n));
+      else
+        for (size_t i = 0; i < n; ++i)
+          x[i] = std::sqrt(x[i]);
+    }
+
+    template<class T> void block_rsqrt(T *x, size_t n) noexcept
+    {
+      if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        Math::rsqrt(std::span<const T>(x, n), std::span<T>(x, n));
+      else
+        for (size_t i = 0; i < n; ++i)
+          x[i] = T(1) / std::sqrt(x[i]);
+    }
+
+    // symmetric 2x2 (a, b; b, c) = mean E + (d, b; b, -d), r^2 = d^2 + b^2
+    template<class T> constexpr void sym2_shift(T a, T b, T c, T &mean, T &d, T &r2) noexcept
+    {
+      mean = (a + c) / 2;
+      d = (a - c) / 2;
+      r2 = d*d + b*b;
+    }
+
+    // eigenvector (x, y) of mean + r, not normalized: (d + r, b) or (b, r - d), the one without
+    // cancellation, i.e. (g, b) or (b, g) with g = r + |d|, any vector is one if r == 0,
+    // no arithmetic depends on the choice, otherwise gcc moves it to branches and doesn't vectorize
+    template<class T> constexpr void sym2_vector(T b, T d, T r, T &x, T &y, T &n2) noexcept
+    {
+      // b == 0 if r == 0, then (1, 0) or (0, 1)
+      const bool pos = (d >= 0);
+      const T g = r + (T(1) - 2*T(d < 0))*d + T(r == 0);
+      x = pos? g : b;
+      y = pos? b : g;
+      n2 = g*g + b*b;
+    }
+
+    // a = (xx, xy, xz, yy, yz, zz) = m E + B, p^2 = B:B/6 and q = det B/2
+    template<class T> constexpr void cardano_shift(const T (&a)[6], T &m, T &p2, T &q) noexcept
+    {
+      m = (a[0] + a[3] + a[5]) / 3;
+      const T b0 = a[0] - m, b3 = a[3] - m, b5 = a[5] - m;
+      p2 = (b0*b0 + b3*b3 + b5*b5 + 2*(a[1]*a[1] + a[2]*a[2] + a[4]*a[4])) / 6;
+      q = (b0*(b3*b5 - a[4]*a[4]) - a[1]*(a[1]*b5 - a[4]*a[2]) + a[2]*(a[1]*a[4] - b3*a[2])) / 2;
+    }
+
+    // the eigenvalues are m + 2p cos(phi + 2pi k/3), phi = acos(r)/3 in [0, pi/3], r = q/p^3
+    template<class T> constexpr T cardano_ratio(T p, T q) noexcept
+    {
+      const T r = (p > 0)? q / (p*p*p) : T(0);
+      return std::clamp(r, T(-1), T(1));
+    }
+
+    template<class T> void cardano_angle(T r, T &c, T &s) noexcept
+    {
+      const T phi = std::acos(r) / 3;
+      c = std::cos(phi);
+      s = std::sin(phi);
+    }
+
+    // acos is ill-conditioned at +-1, i.e. for close pairs of eigenvalues, their error is
+    // about sqrt(epsilon/(1 - |r|)) of the spread, so they are taken from eigen() then
+    template<class T> constexpr bool cardano_close(T r) noexcept { return 1 - details::abs(r) < T(1e-3); }
+
+    template<class T> constexpr void cardano_values(T m, T p, T c, T s, T (&l)[3]) noexcept
+    {
+      constexpr T sqrt3 = std::numbers::sqrt3_v<T>;
+      l[0] = m - p*(c + sqrt3*s);
+      l[1] = m + p*(sqrt3*s - c);
+      l[2] = m + 2*p*c;
+    }
+
+    // the largest cross product of the rows of A - l E is the kernel, i.e. the eigenvector
+    // of a simple eigenvalue l, any vector is one if A == l E
+    template<class T> constexpr void kernel_vector(const T (&a)[6], T l, T (&v)[3], T &n2) noexcept
+    {
+      const T r0[3] = {a[0] - l, a[1], a[2]}, r1[3] = {a[1], a[3] - l, a[4]}, r2[3] = {a[2], a[4], a[5] - l};
+      auto cross = [](const T (&x)[3], const T (&y)[3], T (&z)[3])
+      {
+        z[0] = x[1]*y[2] - x[2]*y[1];
+        z[1] = x[2]*y[0] - x[0]*y[2];
+        z[2] = x[0]*y[1] - x[1]*y[0];
+        return z[0]*z[0] + z[1]*z[1] + z[2]*z[2];
+      };
+      T c01[3], c02[3], c12[3];
+      const T n01 = cross(r0, r1, c01), n02 = cross(r0, r2, c02), n12 = cross(r1, r2, c12);
+      const bool b02 = (n02 > n01);
+      n2 = b02? n02 : n01;
+      for (size_t i = 0; i < 3; ++i)
+        v[i] = b02? c02[i] : c01[i];
+      const bool b12 = (n12 > n2);
+      n2 = b12? n12 : n2;
+      for (size_t i = 0; i < 3; ++i)
+        v[i] = b12? c12[i] : v[i];
+      const bool zero = (n2 == 0);
+      v[0] = zero? T(1) : v[0];
+      n2 = zero? T(1) : n2;
+    }
+
+    // u orthogonal to the unit vector v, not normalized, the larger of v x (0, 0, 1) and v x (1, 0, 0)
+    template<class T> constexpr void orthogonal(const T (&v)[3], T (&u)[3], T &n2) noexcept
+    {
+      const T nz = v[0]*v[0] + v[1]*v[1], nx = v[1]*v[1] + v[2]*v[2];
+      const bool bz = (nz > nx);
+      u[0] = bz? v[1] : T(0);
+      u[1] = bz? -v[0] : v[2];
+      u[2] = bz? T(0) : -v[1];
+      n2 = bz? nz : nx;
+    }
+
+    // A in the orthonormal basis u, w of a plane: (u A u, u A w; w A u, w A w)
+    template<class T> constexpr void project(const T (&a)[6], const T (&u)[3], const T (&w)[3],
+      T &uu, T &uw, T &ww) noexcept
+    {
+      const T au[3] = {a[0]*u[0] + a[1]*u[1] + a[2]*u[2],
+                       a[1]*u[0] + a[3]*u[1] + a[4]*u[2],
+                       a[2]*u[0] + a[4]*u[1] + a[5]*u[2]};
+      const T aw[3] = {a[0]*w[0] + a[1]*w[1] + a[2]*w[2],
+                       a[1]*w[0] + a[3]*w[1] + a[4]*w[2],
+                       a[2]*w[0] + a[4]*w[1] + a[5]*w[2]};
+      uu = u[0]*au[0] + u[1]*au[1] + u[2]*au[2];
+      uw = w[0]*au[0] + w[1]*au[1] + w[2]*au[2];
+      ww = w[0]*aw[0] + w[1]*aw[1] + w[2]*aw[2];
+    }
+
+    // Jacobi rotation zeroing a_pq: t = tan of the angle by the smaller root of
+    // t^2 + 2 theta t - 1 = 0, h = sqrt((a_qq - a_pp)^2 + 4 a_pq^2)
+    template<class T> constexpr T jacobi_tangent(T app, T aqq, T apq, T h) noexcept
+    {
+      // sign and |dd| by arithmetic, den == 0 only if apq == 0, no branches for vectorized loops
+      const T dd = aqq - app, sign = T(1) - 2*T(dd < 0);
+      const T den = sign*dd + h;
+      return sign * 2*apq / std::max(den, std::numeric_limits<T>::min());
+    }
+
+    // stable sort of the eigenvalues by compare-exchange, with the rows of the eigenvectors
+    template<size_t N, class T> constexpr void sort_eigen(T (&l)[N], T (&v)[N][N]) noexcept
+    {
+      auto exchange = [&](size_t i, size_t j)
+      {
+        const bool s = (l[j] < l[i]);
+        const T li = l[i], lj = l[j];
+        l[i] = s? lj : li;
+        l[j] = s? li : lj;
+        for (size_t k = 0; k < N; ++k)
+        {
+          const T vi = v[i][k], vj = v[j][k];
+          v[i][k] = s? vj : vi;
+          v[j][k] = s? vi : vj;
+        }
+      };
+      exchange(0, 1);
+      if constexpr (N == 3)
+      {
+        exchange(1, 2);
+        exchange(0, 1);
+      }
+    }
+
+    // the pairs (p, q) of a cyclic sweep
+    template<size_t N> inline constexpr size_t jacobi_pairs = N*(N - 1)/2;
+    inline constexpr size_t jacobi_p[3] = {0, 0, 1}, jacobi_q[3] = {1, 2, 2};
+
+    // one rotation of a (full symmetric) and of the columns of v, c = cos, s = sin of the angle
+    template<size_t N, class T> constexpr void jacobi_rotate(T (&a)[N][N], T (&v)[N][N],
+      size_t p, size_t q, T t, T c, T s) noexcept
+    {
+      const T apq = a[p][q];
+      a[p][p] -= t*apq;
+      a[q][q] += t*apq;
+      a[p][q] = a[q][p] = 0;
+      for (size_t r = 0; r < N; ++r)
+      {
+        if (r != p && r != q)
+        {
+          const T arp = a[r][p], arq = a[r][q];
+          a[r][p] = a[p][r] = c*arp - s*arq;
+          a[r][q] = a[q][r] = s*arp + c*arq;
+        }
+        const T vrp = v[r][p], vrq = v[r][q];
+        v[r][p] = c*vrp - s*vrq;
+        v[r][q] = s*vrp + c*vrq;
+      }
+    }
+  } // namespace details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    Vector<N, T> eigenvalues(const SymTensor<N, T> &A) noexcept
+  {
+    using namespace details::impl;
+    if constexpr (N == 2)
+    {
+      T mean, d, r2;
+      sym2_shift(A(0, 0), A(0, 1), A(1, 1), mean, d, r2);
+      const T r = std::sqrt(r2);
+      return Vector<N, T>(mean - r, mean + r);
+    }
+    else
+    {
+      const T a[6] = {A(0, 0), A(0, 1), A(0, 2), A(1, 1), A(1, 2), A(2, 2)};
+      T m, p2, q, c, s, l[3];
+      cardano_shift(a, m, p2, q);
+      const T p = std::sqrt(p2), r = cardano_ratio(p, q);
+      if (cardano_close(r))
+        return eigen(A).values;
+      cardano_angle(r, c, s);
+      cardano_values(m, p, c, s, l);
+      return Vector<N, T>(l[0], l[1], l[2]);
+    }
+  }
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    Eigensystem<N, T> eigen(const SymTensor<N, T> &A) noexcept
+  {
+    using namespace details::impl;
+    Eigensystem<N, T> e;
+    if constexpr (N == 2)
+    {
+      T mean, d, r2, x, y, n2;
+      sym2_shift(A(0, 0), A(0, 1), A(1, 1), mean, d, r2);
+      const T r = std::sqrt(r2);
+      sym2_vector(A(0, 1), d, r, x, y, n2);
+      const T k = T(1) / std::sqrt(n2);
+      e.values = Vector<N, T>(mean - r, mean + r);
+      e.vectors = Tensor<N, T>(-y*k, x*k, x*k, y*k);
+    }
+    else
+    {
+      const T a[6] = {A(0, 0), A(0, 1), A(0, 2), A(1, 1), A(1, 2), A(2, 2)};
+      T m, p2, q, c, s, l[3];
+      cardano_shift(a, m, p2, q);
+      const T p = std::sqrt(p2);
+      cardano_angle(cardano_ratio(p, q), c, s);
+      cardano_values(m, p, c, s, l);
+
+      // the most separated eigenvalue is simple unless all three are equal
+      const bool lo = (l[1] - l[0] > l[2] - l[1]);
+      T v[3], u[3], n2;
+      kernel_vector(a, lo? l[0] : l[2], v, n2);
+      T k = T(1) / std::sqrt(n2);
+      for (auto &x : v)
+        x *= k;
+      orthogonal(v, u, n2);
+      k = T(1) / std::sqrt(n2);
+      for (auto &x : u)
+        x *= k;
+      const T w[3] = {v[1]*u[2] - v[2]*u[1], v[2]*u[0] - v[0]*u[2], v[0]*u[1] - v[1]*u[0]};
+
+      T uu, uw, ww, mean, d, r2, x, y;
+      project(a, u, w, uu, uw, ww);
+      sym2_shift(uu, uw, ww, mean, d, r2);
+      const T r = std::sqrt(r2);
+      sym2_vector(uw, d, r, x, y, n2);
+      k = T(1) / std::sqrt(n2);
+      x *= k;
+      y *= k;
+
+      // (x, y) and (-y, x) in the basis u, w
+      const size_t i0 = lo? 0 : 2, i1 = lo? 1 : 0, i2 = lo? 2 : 1;
+      e.values[i0] = lo? l[0] : l[2];
+      e.values[i1] = mean - r;
+      e.values[i2] = mean + r;
+      for (size_t j = 0; j < 3; ++j)
+      {
+        e.vectors[i0][j] = v[j];
+        e.vectors[i1][j] = -y*u[j] + x*w[j];
+        e.vectors[i2][j] = x*u[j] + y*w[j];
+      }
+    }
+    return e;
+  }
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    constexpr Eigensystem<N, T> eigen_jacobi(const SymTensor<N, T> &A, int sweeps) noexcept
+  {
+    using namespace details::impl;
+    T a[N][N], v[N][N] = {};
+    for (size_t i = 0; i < N; ++i)
+    {
+      v[i][i] = 1;
+      for (size_t j = 0; j < N; ++j)
+        a[i][j] = A(i, j);
+    }
+
+    for (int sweep = 0; sweep < sweeps; ++sweep)
+    {
+      T off = 0, diag = 0;
+      for (size_t i = 0; i < N; ++i)
+      {
+        diag += a[i][i]*a[i][i];
+        for (size_t j = i + 1; j < N; ++j)
+          off += a[i][j]*a[i][j];
+      }
+      if (!(off > std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon() * diag))
+        break;
+
+      for (size_t k = 0; k < jacobi_pairs<N>; ++k)
+      {
+        const size_t p = jacobi_p[k], q = jacobi_q[k];
+        const T dd = a[q][q] - a[p][p];
+        const T t = jacobi_tangent(a[p][p], a[q][q], a[p][q], details::sqrt(dd*dd + 4*a[p][q]*a[p][q]));
+        const T c = T(1) / details::sqrt(t*t + 1);
+        jacobi_rotate(a, v, p, q, t, c, t*c);
+      }
+    }
+
+    // the eigenvectors are the columns of v
+    T l[N], vt[N][N];
+    for (size_t i = 0; i < N; ++i)
+    {
+      l[i] = a[i][i];
+      for (size_t j = 0; j < N; ++j)
+        vt[i][j] = v[j][i];
+    }
+    sort_eigen(l, vt);
+
+    Eigensystem<N, T> e;
+    for (size_t i = 0; i < N; ++i)
+    {
+      e.values[i] = l[i];
+      for (size_t j = 0; j < N; ++j)
+        e.vectors[i][j] = vt[i][j];
+    }
+    return e;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  namespace details::impl
+  {
+    // upper triangles of the tensors of a field, (xx, xy, yy) or (xx, xy, xz, yy, yz, zz)
+    template<size_t N, class T> auto upper_ptrs(const TensorField<N, T> &A) noexcept
+    {
+      std::array<const T*, N*(N + 1)/2> p;
+      for (size_t i = 0, k = 0; i < N; ++i)
+        for (size_t j = i; j < N; ++j)
+          p[k++] = A.component(i, j).data();
+      return p;
+    }
+
+    template<size_t N, class T> auto value_ptrs(VectorField<N, T> &values) noexcept
+    {
+      std::array<T*, N> p;
+      for (size_t i = 0; i < N; ++i)
+        p[i] = values.component(i).data();
+      return p;
+    }
+
+    template<bool Vectors, class T>
+      void batch_eigen(const TensorField<2, T> &A, VectorField<2, T> &values, TensorField<2, T> *vectors) noexcept
+    {
+      const auto a = upper_ptrs(A);
+      const auto l = value_ptrs(values);
+      T *v[4] = {};
+      if constexpr (Vectors)
+        for (size_t i = 0; i < 4; ++i)
+          v[i] = vectors->component(i / 2, i % 2).data();
+
+      alignas(simd::alignment) T mean[eigen_block], d[eigen_block], r[eigen_block];
+      alignas(simd::alignment) T x[eigen_block], y[eigen_block], k[eigen_block];
+      for (size_t first = 0; first < A.size(); first += eigen_block)
+      {
+        const size_t n = std::min(eigen_block, A.size() - first);
+        const T *a0 = a[0] + first, *a1 = a[1] + first, *a2 = a[2] + first;
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+          sym2_shift(a0[i], a1[i], a2[i], mean[i], d[i], r[i]);
+        block_sqrt(r, n);
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          l[0][first + i] = mean[i] - r[i];
+          l[1][first + i] = mean[i] + r[i];
+        }
+        if constexpr (Vectors)
+        {
+          MATH_SIMD_LOOP
+          for (size_t i = 0; i < n; ++i)
+            sym2_vector(a1[i], d[i], r[i], x[i], y[i], k[i]);
+          block_rsqrt(k, n);
+          MATH_SIMD_LOOP
+          for (size_t i = 0; i < n; ++i)
+          {
+            v[0][first + i] = -y[i]*k[i];
+            v[1][first + i] = x[i]*k[i];
+            v[2][first + i] = x[i]*k[i];
+            v[3][first + i] = y[i]*k[i];
+          }
+        }
+      }
+    }
+
+    template<bool Vectors, class T>
+      void batch_eigen(const TensorField<3, T> &A, VectorField<3, T> &values, TensorField<3, T> *vectors) noexcept
+    {
+      const auto a = upper_ptrs(A);
+      const auto l = value_ptrs(values);
+      T *pv[9] = {};
+      if constexpr (Vectors)
+        for (size_t i = 0; i < 9; ++i)
+          pv[i] = vectors->component(i / 3, i % 3).data();
+
+      // per tensor state between the stages
+      alignas(simd::alignment) T m[eigen_block], p[eigen_block], q[eigen_block];
+      alignas(simd::alignment) T c[eigen_block], s[eigen_block], n2[eigen_block];
+      alignas(simd::alignment) T v[3][eigen_block], u[3][eigen_block];
+      alignas(simd::alignment) T d[eigen_block], r[eigen_block], mean[eigen_block], uw[eigen_block];
+      size_t close[eigen_block];
+      auto load = [&](size_t first, size_t i, T (&ai)[6])
+      {
+        for (size_t j = 0; j < 6; ++j)
+          ai[j] = a[j][first + i];
+      };
+
+      for (size_t first = 0; first < A.size(); first += eigen_block)
+      {
+        const size_t n = std::min(eigen_block, A.size() - first);
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          T ai[6];
+          load(first, i, ai);
+          cardano_shift(ai, m[i], p[i], q[i]);
+        }
+        block_sqrt(p, n);
+        size_t nclose = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+          const T ri = cardano_ratio(p[i], q[i]);
+          cardano_angle(ri, c[i], s[i]);
+          if (!Vectors && cardano_close(ri))
+            close[nclose++] = i;
+        }
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          T li[3];
+          cardano_values(m[i], p[i], c[i], s[i], li);
+          for (size_t j = 0; j < 3; ++j)
+            l[j][first + i] = li[j];
+        }
+        if constexpr (!Vectors)
+        {
+          // the close pairs are rare, one by one
+          for (size_t k = 0; k < nclose; ++k)
+          {
+            T ai[6];
+            load(first, close[k], ai);
+            const auto e = eigen(SymTensor<3, T>(ai[0], ai[1], ai[2], ai[3], ai[4], ai[5]));
+            for (size_t j = 0; j < 3; ++j)
+              l[j][first + close[k]] = e.values[j];
+          }
+          continue;
+        }
+
+        // as of eigen(SymTensor) stage by stage
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          T ai[6], vi[3];
+          load(first, i, ai);
+          const T l0 = l[0][first + i], l1 = l[1][first + i], l2 = l[2][first + i];
+          kernel_vector(ai, (l1 - l0 > l2 - l1)? l0 : l2, vi, n2[i]);
+          for (size_t j = 0; j < 3; ++j)
+            v[j][i] = vi[j];
+        }
+        block_rsqrt(n2, n);
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          T vi[3], ui[3];
+          for (size_t j = 0; j < 3; ++j)
+            v[j][i] = vi[j] = v[j][i] * n2[i];
+          orthogonal(vi, ui, n2[i]);
+          for (size_t j = 0; j < 3; ++j)
+            u[j][i] = ui[j];
+        }
+        block_rsqrt(n2, n);
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          T ai[6], vi[3], ui[3], uu, ww;
+          load(first, i, ai);
+          for (size_t j = 0; j < 3; ++j)
+          {
+            vi[j] = v[j][i];
+            u[j][i] = ui[j] = u[j][i] * n2[i];
+          }
+          const T wi[3] = {vi[1]*ui[2] - vi[2]*ui[1], vi[2]*ui[0] - vi[0]*ui[2], vi[0]*ui[1] - vi[1]*ui[0]};
+          project(ai, ui, wi, uu, uw[i], ww);
+          sym2_shift(uu, uw[i], ww, mean[i], d[i], r[i]);
+        }
+        block_sqrt(r, n);
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          T x, y;
+          sym2_vector(uw[i], d[i], r[i], x, y, n2[i]);
+          c[i] = x;
+          s[i] = y;
+        }
+        block_rsqrt(n2, n);
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          const T x = c[i]*n2[i], y = s[i]*n2[i];
+          const T vi[3] = {v[0][i], v[1][i], v[2][i]}, ui[3] = {u[0][i], u[1][i], u[2][i]};
+          const T wi[3] = {vi[1]*ui[2] - vi[2]*ui[1], vi[2]*ui[0] - vi[0]*ui[2], vi[0]*ui[1] - vi[1]*ui[0]};
+          const T l0 = l[0][first + i], l1 = l[1][first + i], l2 = l[2][first + i];
+          const bool lo = (l1 - l0 > l2 - l1);
+          const T la = lo? l0 : l2, lm = mean[i] - r[i], lp = mean[i] + r[i];
+          l[0][first + i] = lo? la : lm;
+          l[1][first + i] = lo? lm : lp;
+          l[2][first + i] = lo? lp : la;
+          for (size_t j = 0; j < 3; ++j)
+          {
+            const T vm = -y*ui[j] + x*wi[j], vp = x*ui[j] + y*wi[j];
+            pv[j][first + i] = lo? vi[j] : vm;
+            pv[3 + j][first + i] = lo? vm : vp;
+            pv[6 + j][first + i] = lo? vp : vi[j];
+          }
+        }
+      }
+    }
+
+    template<size_t N, class T> void batch_jacobi(const TensorField<N, T> &A, VectorField<N, T> &values,
+      TensorField<N, T> &vectors, int sweeps) noexcept
+    {
+      const auto pa = upper_ptrs(A);
+      const auto pl = value_ptrs(values);
+      constexpr size_t M = N*(N + 1)/2;
+
+      // upper triangles of a and full v, c and t are the cosines and tangents of the rotations
+      alignas(simd::alignment) T a[M][eigen_block], v[N*N][eigen_block];
+      alignas(simd::alignment) T t[eigen_block], c[eigen_block];
+      auto index = [](size_t i, size_t j) { return (i <= j)? i*N - i*(i + 1)/2 + j : j*N - j*(j + 1)/2 + i; };
+
+      for (size_t first = 0; first < A.size(); first += eigen_block)
+      {
+        const size_t n = std::min(eigen_block, A.size() - first);
+        for (size_t k = 0; k < M; ++k)
+          std::copy_n(pa[k] + first, n, a[k]);
+        for (size_t k = 0; k < N*N; ++k)
+          std::fill_n(v[k], n, (k % (N + 1) == 0)? T(1) : T(0));
+
+        for (int sweep = 0; sweep < sweeps; ++sweep)
+          for (size_t k = 0; k < jacobi_pairs<N>; ++k)
+          {
+            const size_t p = jacobi_p[k], q = jacobi_q[k];
+            T *app = a[index(p, p)], *aqq = a[index(q, q)], *apq = a[index(p, q)];
+            MATH_SIMD_LOOP
+            for (size_t i = 0; i < n; ++i)
+              t[i] = (aqq[i] - app[i])*(aqq[i] - app[i]) + 4*apq[i]*apq[i];
+            block_sqrt(t, n);
+            MATH_SIMD_LOOP
+            for (size_t i = 0; i < n; ++i)
+            {
+              t[i] = jacobi_tangent(app[i], aqq[i], apq[i], t[i]);
+              c[i] = t[i]*t[i] + 1;
+            }
+            block_rsqrt(c, n);
+
+            // the third axis r of a 3x3 tensor, if any
+            T *arp = nullptr, *arq = nullptr;
+            if constexpr (N == 3)
+            {
+              const size_t r = 3 - p - q;
+              arp = a[index(r, p)];
+              arq = a[index(r, q)];
+            }
+            MATH_SIMD_LOOP
+            for (size_t i = 0; i < n; ++i)
+            {
+              const T ti = t[i], ci = c[i], si = t[i]*c[i], a_pq = apq[i];
+              app[i] -= ti*a_pq;
+              aqq[i] += ti*a_pq;
+              apq[i] = 0;
+              if constexpr (N == 3)
+              {
+                const T rp = arp[i], rq = arq[i];
+                arp[i] = ci*rp - si*rq;
+                arq[i] = si*rp + ci*rq;
+              }
+              for (size_t r = 0; r < N; ++r)
+              {
+                const T vrp = v[r*N + p][i], vrq = v[r*N + q][i];
+                v[r*N + p][i] = ci*vrp - si*vrq;
+                v[r*N + q][i] = si*vrp + ci*vrq;
+              }
+            }
+          }
+
+        // the eigenvectors are the columns of v
+        T *pv[N][N];
+        for (size_t i = 0; i < N; ++i)
+          for (size_t j = 0; j < N; ++j)
+            pv[i][j] = vectors.component(i, j).data() + first;
+        MATH_SIMD_LOOP
+        for (size_t i = 0; i < n; ++i)
+        {
+          T li[N], vi[N][N];
+          for (size_t j = 0; j < N; ++j)
+          {
+            li[j] = a[index(j, j)][i];
+            for (size_t k = 0; k < N; ++k)
+              vi[j][k] = v[k*N + j][i];
+          }
+          sort_eigen(li, vi);
+          for (size_t j = 0; j < N; ++j)
+          {
+            pl[j][first + i] = li[j];
+            for (size_t k = 0; k < N; ++k)
+              pv[j][k][i] = vi[j][k];
+          }
+        }
+      }
+    }
+  } // namespace details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void eigenvalues(const TensorField<N, T> &A, VectorField<N, T> &values) noexcept
+  {
+    assert(values.size() == A.size());
+    details::impl::batch_eigen<false>(A, values, static_cast<TensorField<N, T>*>(nullptr));
+  }
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void eigen(const TensorField<N, T> &A, VectorField<N, T> &values, TensorField<N, T> &vectors) noexcept
+  {
+    assert(values.size() == A.size() && vectors.size() == A.size());
+    details::impl::batch_eigen<true>(A, values, &vectors);
+  }
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void eigen_jacobi(const TensorField<N, T> &A, VectorField<N, T> &values, TensorField<N, T> &vectors,
+      int sweeps) noexcept
+  {
+    assert(values.size() == A.size() && vectors.size() == A.size());
+    details::impl::batch_jacobi(A, values, vectors, sweeps);
+  }
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::Eigensystems::tests
+{
+  // diagonal tensors are sorted, one rotation is exact for a 2x2 one with equal diagonal
+  constexpr auto e2 = eigen_jacobi(SymTensor2D(2., 1., 2.));
+  static_assert(e2.values == Vector2D(1, 3), "eigen_jacobi failed");
+  static_assert(eigen_jacobi(SymTensor3D(3., 1., 2.)).values == Vector3D(1, 2, 3), "eigen_jacobi failed");
+  static_assert(eigen_jacobi(SymTensor3D(3., 1., 2.)).vectors == Tensor3D(0, 1, 0, 0, 0, 1, 1, 0, 0),
+    "eigen_jacobi failed");
+} // namespace Math::Eigensystems::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \struct Math::Eigensystem
+  \brief Eigenvalues in ascending order and the orthonormal eigenvectors of a symmetric tensor,
+    A = ~vectors * diag(values) * vectors.
+*/
+
+/*!
+  \fn Eigensystem<N, T> eigen(const SymTensor<N, T> &A) noexcept
+  \brief Analytic eigensystem of a symmetric 2x2 or 3x3 tensor, e.g. principal stresses and axes.
+
+  The eigenvalues of a 3x3 tensor are given by Cardano's formula for the shifted and scaled
+  tensor, B = (A - m E)/p with m = tr A/3, thus they are accurate relative to the spread of
+  the eigenvalues. The eigenvector of the eigenvalue which is the most separated from the others
+  is the largest cross product of the rows of A - l E, the remaining two are those of the 2x2
+  tensor A projected on its orthogonal plane. So repeated eigenvalues (e.g. isotropic or
+  uniaxial stress) need no special treatment and give orthonormal eigenvectors as well.
+
+  Use eigen_jacobi() if the eigenvectors of close eigenvalues matter, it's accurate to the
+  rounding of A regardless of the separation, but costs several times more.
+*/
+
+/*!
+  \fn void eigen(const TensorField<N, T> &A, VectorField<N, T> &values, TensorField<N, T> &vectors) noexcept
+  \brief Batched analytic eigensystems of symmetric tensors, vectorized across the tensors.
+
+  The tensors are processed by blocks stage by stage as of eigen(const SymTensor&): the
+  arithmetic loops are vectorized, the square roots of a block are taken by Math::sqrt() and
+  Math::rsqrt(), the angles of Cardano's formula by std::acos, std::cos and std::sin.
+  \code
+  TensorField<3> stress(ncells);
+  VectorField<3> principal(ncells);
+  TensorField<3> axes(ncells);
+  eigen(stress, principal, axes); // axes.component(2, j) is the axis of the largest stress
+  \endcode
+*/
+
+/*!
+  \fn void eigen_jacobi(const TensorField<N, T> &A, VectorField<N, T> &values, TensorField<N, T> &vectors, int sweeps) noexcept
+  \brief Batched cyclic Jacobi eigensolver with the same number of sweeps for all the tensors.
+
+  Jacobi converges quadratically, 5 or 6 sweeps are enough for doubles with any 3x3 tensor.
+*/
+
+#endif // MATH_EIGENSYSTEM_H_INCLUDED
@@ -0,0 +1,373 @@
+#ifndef MATH_EXPRESSION_H_INCLUDED
+#define MATH_EXPRESSION_H_INCLUDED
+
+/*!
+  \file Expression.h
+  \author gennadiy
+  \brief Lazy (expression templates) arithmetic of vectors, definition, documentation and tests.
+*/
+
+#include "Vector.h"
+
+namespace Math::expr
+{
+  template<class> struct is_vector : std::false_type {};
+  template<size_t N, Type T, bool B, class L>
+    struct is_vector<Vector<N, T, B, L>> : std::true_type {};
+
+  template<class E> concept Expression = requires(const E &e, size_t i) {
+    typename E::value_type;
+    typename E::vector_type;
+    { E::size } -> std::convertible_to<size_t>;
+    { E::is_euclidian } -> std::convertible_to<bool>;
+    e[i];
+  };
+
+  // anything which can be an operand of a lazy operation
+  template<class E> concept Operand = Expression<E> || is_vector<E>::value;
+
+  // base of all expressions: traits and materialization into a vector
+  template<size_t N, Type T, bool B, class L> struct Node
+  {
+    using value_type = T;
+    using vector_type = Vector<N, T, B, L>; // result of materialization
+    static constexpr size_t size = N;
+    static constexpr bool is_euclidian = B;
+  };
+
+  // leaf of an expression tree, a reference to an existing vector
+  template<size_t N, Type T, bool B, class L> class Terminal : public Node<N, T, B, L>
+  {
+    const Vector<N, T, B, L> &v;
+
+  public:
+    constexpr explicit Terminal(const Vector<N, T, B, L> &vec) noexcept : v(vec) {}
+    constexpr const T& operator[](size_t i) const noexcept { return v[i]; }
+  }; // class Terminal<N, T, B, L>
+
+  // componentwise operation on two expressions
+  template<class Op, Expression L, Expression R>
+    class Binary : public Node<L::size, typename L::value_type, L::is_euclidian,
+                               typename L::vector_type::layout>
+  {
+    static_assert(L::size == R::size, "Expressions of different size");
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type>,
+      "Expressions of different types");
+    static_assert(L::is_euclidian == R::is_euclidian, "Expressions of different kinds");
+
+    L l;
+    R r;
+
+  public:
+    constexpr Binary(const L &left, const R &right) noexcept : l(left), r(right) {}
+    constexpr auto operator[](size_t i) const noexcept { return Op::apply(l[i], r[i]); }
+    constexpr operator typename L::vector_type() const noexcept;
+  }; // class Binary<Op, L, R>
+
+  // componentwise operation on an expression and a scalar
+  template<class Op, Expression E>
+    class Scalar : public Node<E::size, typename E::value_type, E::is_euclidian,
+                               typename E::vector_type::layout>
+  {
+    using T = typename E::value_type;
+    E e;
+    T a;
+
+  public:
+    constexpr Scalar(const E &expr, const T &s) noexcept : e(expr), a(s) {}
+    constexpr auto operator[](size_t i) const noexcept { return Op::apply(e[i], a); }
+    constexpr operator typename E::vector_type() const noexcept;
+  }; // class Scalar<Op, E>
+
+  // operations, only compound assignments of the components are used,
+  // in the same way as the eager operations do
+  struct Add { template<class T> static constexpr T apply(T a, const T &b) noexcept { a += b; return a; } };
+  struct Sub { template<class T> static constexpr T apply(T a, const T &b) noexcept { a -= b; return a; } };
+  struct Mul { template<class T> static constexpr T apply(T a, const T &b) noexcept { a *= b; return a; } };
+  struct Div { template<class T> static constexpr T apply(T a, const T &b) noexcept { a /= b; return a; } };
+
+/*---------------------------------------------------------------------------------------*/
+
+  // wrap a vector into a terminal, pass expressions as is
+  template<Operand E> constexpr auto as_expr(const E &e) noexcept;
+
+  // materialization
+  template<Expression E> constexpr auto eval(const E &e) noexcept;
+
+  template<size_t N, Type T, bool B, class L, Expression E>
+    constexpr auto& assign(Vector<N, T, B, L> &v, const E &e) noexcept;
+
+  template<size_t N, Type T, bool B, class L, Expression E>
+    constexpr auto& operator+=(Vector<N, T, B, L> &v, const E &e) noexcept;
+
+  template<size_t N, Type T, bool B, class L, Expression E>
+    constexpr auto& operator-=(Vector<N, T, B, L> &v, const E &e) noexcept;
+
+  // lazy arithmetic, at least one of the operands must be an expression
+  template<Operand L, Operand R> requires(Expression<L> || Expression<R>)
+    constexpr auto operator+(const L &l, const R &r) noexcept;
+
+  template<Operand L, Operand R> requires(Expression<L> || Expression<R>)
+    constexpr auto operator-(const L &l, const R &r) noexcept;
+
+  template<Expression E>
+    constexpr auto operator-(const E &e) noexcept;
+
+  template<Expression E>
+    constexpr auto operator*(const E &e, const typename E::value_type &a) noexcept;
+
+  template<Expression E>
+    constexpr auto operator*(const typename E::value_type &a, const E &e) noexcept;
+
+  template<Expression E>
+    constexpr auto operator/(const E &e, const typename E::value_type &a) noexcept;
+
+  // fused dot product of euclidian vectors
+  template<Operand L, Operand R> requires(Expression<L> || Expression<R>)
+    constexpr auto operator*(const L &l, const R &r) noexcept;
+} // namespace Math::expr
+
+namespace Math
+{
+  // entry point to the lazy arithmetic
+  template<size_t N, Type T, bool B, class L>
+    constexpr auto lazy(const Vector<N, T, B, L> &v) noexcept
+      { return expr::Terminal<N, T, B, L>(v); }
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definition ---------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::expr
+{
+  template<Operand E> constexpr auto as_expr(const E &e) noexcept
+  {
+    if constexpr (Expression<E>)
+      return e;
+    else
+      return lazy(e);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Expression E> constexpr auto eval(const E &e) noexcept
+  {
+    typename E::vector_type v;
+    for (size_t i = 0; i < E::size; ++i)
+      v[i] = e[i];
+    return v;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<class Op, Expression L, Expression R>
+    constexpr Binary<Op, L, R>::operator typename L::vector_type() const noexcept
+  {
+    return eval(*this);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<class Op, Expression E>
+    constexpr Scalar<Op, E>::operator typename E::vector_type() const noexcept
+  {
+    return eval(*this);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, bool B, class L, Expression E>
+    constexpr auto& assign(Vector<N, T, B, L> &v, const E &e) noexcept
+  {
+    static_assert(std::is_same_v<Node<N, T, B, L>,
+      Node<E::size, typename E::value_type, E::is_euclidian, L>>, "Incompatible expression");
+    for (size_t i = 0; i < N; ++i)
+      v[i] = e[i];
+    return v;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, bool B, class L, Expression E>
+    constexpr auto& operator+=(Vector<N, T, B, L> &v, const E &e) noexcept
+  {
+    static_assert(std::is_same_v<Node<N, T, B, L>,
+      Node<E::size, typename E::value_type, E::is_euclidian, L>>, "Incompatible expression");
+    for (size_t i = 0; i < N; ++i)
+      v[i] += e[i];
+    return v;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, bool B, class L, Expression E>
+    constexpr auto& operator-=(Vector<N, T, B, L> &v, const E &e) noexcept
+  {
+    static_assert(std::is_same_v<Node<N, T, B, L>,
+      Node<E::size, typename E::value_type, E::is_euclidian, L>>, "Incompatible expression");
+    for (size_t i = 0; i < N; ++i)
+      v[i] -= e[i];
+    return v;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Operand L, Operand R> requires(Expression<L> || Expression<R>)
+    constexpr auto operator+(const L &l, const R &r) noexcept
+  {
+    using LE = decltype(as_expr(l));
+    using RE = decltype(as_expr(r));
+    return Binary<Add, LE, RE>(as_expr(l), as_expr(r));
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Operand L, Operand R> requires(Expression<L> || Expression<R>)
+    constexpr auto operator-(const L &l, const R &r) noexcept
+  {
+    using LE = decltype(as_expr(l));
+    using RE = decltype(as_expr(r));
+    return Binary<Sub, LE, RE>(as_expr(l), as_expr(r));
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Expression E> constexpr auto operator-(const E &e) noexcept
+  {
+    using T = typename E::value_type;
+    return Scalar<Mul, E>(e, static_cast<T>(-1));
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Expression E>
+    constexpr auto operator*(const E &e, const typename E::value_type &a) noexcept
+  {
+    return Scalar<Mul, E>(e, a);
+  }
+
+  template<Expression E>
+    constexpr auto operator*(const typename E::value_type &a, const E &e) noexcept
+  {
+    return Scalar<Mul, E>(e, a);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Expression E>
+    constexpr auto operator/(const E &e, const typename E::value_type &a) noexcept
+  {
+    return Scalar<Div, E>(e, a);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Operand L, Operand R> requires(Expression<L> || Expression<R>)
+    constexpr auto operator*(const L &l, const R &r) noexcept
+  {
+    using LE = decltype(as_expr(l));
+    using RE = decltype(as_expr(r));
+    static_assert(LE::size == RE::size, "Expressions of different size");
+    static_assert(LE::is_euclidian && RE::is_euclidian, "Dot product of non-euclidian vectors");
+
+    const auto &a = as_expr(l);
+    const auto &b = as_expr(r);
+    auto t = Mul::apply<typename LE::value_type>(a[0], b[0]);
+    for (size_t i = 1; i < LE::size; ++i)
+      t += Mul::apply<typename LE::value_type>(a[i], b[i]);
+    return t;
+  }
+} // namespace Math::expr
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::expr::tests
+{
+  using V3i = Vector<3, int>;
+  using A3i = Array<3, int>;
+
+  constexpr V3i a(1, 2, 3), b(4, 5, 6), c(7, 8, 9);
+
+  static_assert(Expression<decltype(lazy(a))>);
+  static_assert(!Expression<V3i>);
+  static_assert(Operand<V3i>);
+
+  // same results as the eager operations
+  static_assert(eval(lazy(a) + b) == a + b, "lazy v + v failed");
+  static_assert(eval(a - lazy(b)) == a - b, "lazy v - v failed");
+  static_assert(eval(-lazy(a)) == -a, "lazy -v failed");
+  static_assert(eval(2 * lazy(a)) == 2 * a, "lazy a * v failed");
+  static_assert(eval(lazy(a) * 2) == a * 2, "lazy v * a failed");
+  static_assert(eval(lazy(c) / 2) == c / 2, "lazy v / a failed");
+  static_assert(eval(lazy(a) + 2*lazy(b) - lazy(c)/2) == a + 2*b - c/2, "lazy expression failed");
+  static_assert(lazy(a) * lazy(b) == a * b, "lazy dot product failed");
+  static_assert((lazy(a) + b) * c == (a + b) * c, "lazy dot product failed");
+
+  // implicit materialization
+  constexpr V3i d = lazy(a) + b + c;
+  static_assert(d == V3i(12, 15, 18), "implicit conversion failed");
+
+  constexpr A3i x(1, 2, 3);
+  static_assert(eval(lazy(x) + x) == x + x, "lazy array failed");
+} // namespace Math::expr::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \namespace Math::expr
+  \brief Lazy arithmetic of Math::Vector based on expression templates.
+
+  Eager operations on vectors create a new vector for each subexpression, e.g.
+  expression <tt>a + 2.*b - c/dt</tt> makes four temporary vectors and four loops.
+  For large vectors or non-trivial type of the components (e.g. Vector<N, Tensor<3>>)
+  it may be noticeable. Lazy operations build a light-weight tree of the expression
+  instead, the tree is evaluated in a single loop when it's assigned to a vector.
+
+  Lazy arithmetic is opt-in, wrap the vector operands of an expression with Math::lazy(),
+  an operation of a lazy and an eager operand is lazy too, but the eager subexpressions
+  (e.g. \c 2.*b below without lazy) are evaluated to temporary vectors as usual:
+  \code
+  Vector3D r = lazy(a) + 2.*lazy(b) - lazy(c)/dt; // one loop, no temporary vectors
+  r += lazy(a) * dt;                               // one loop
+  auto v = eval(lazy(a) - b);                      // explicit materialization
+  double ab = lazy(a) * (lazy(b) + c);             // fused dot product
+  \endcode
+
+  Each component is computed by the same compound assignment operations of
+  the components as the eager operations do, thus results are the same and all
+  operations are constexpr.
+
+  NB! Expressions keep references to the vectors, so don't store them (e.g. with
+  \c auto) beyond the lifetime of the operands. Note that direct initialization
+  <tt>Vector3D r(lazy(a) + b)</tt> doesn't compile because of the explicit
+  constructor of a vector from a single value, use <tt>r = ...</tt> or eval().
+*/
+
+/*!
+  \fn constexpr auto Math::lazy(const Vector &v) noexcept
+  \brief Start a lazy expression.
+  \param v Vector, it must outlive the expression.
+  \return Expression referencing the given vector.
+*/
+
+/*!
+  \fn constexpr auto Math::expr::eval(const Expression &e) noexcept
+  \brief Evaluate an expression into a new vector.
+  \param e Expression.
+  \return Vector with the values of the expression.
+*/
+
+/*!
+  \fn constexpr auto& Math::expr::assign(Vector &v, const Expression &e) noexcept
+  \brief Evaluate an expression directly into an existing vector.
+  \param v Vector to be assigned, it may be used in the expression itself.
+  \param e Expression.
+  \return Reference to the given vector.
+*/
+
+#endif // MATH_EXPRESSION_H_INCLUDED
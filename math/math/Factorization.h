@@ -0,0 +1,388 @@
+#ifndef MATH_FACTORIZATION_H_INCLUDED
+#define MATH_FACTORIZATION_H_INCLUDED
+
+/*!
+  \file Factorization.h
+  \author gennadiy
+  \brief LU, Cholesky and QR factorizations of tensors, definition, documentation and tests.
+*/
+
+#include "Tensor.h"
+#include <algorithm>
+#include <limits>
+
+namespace Math
+{
+  // PA = LU with partial pivoting, for any non-singular tensor
+  template<size_t N, std::floating_point T = double> class LU
+  {
+    Tensor<N, T> lu; // L (unit diagonal) below the diagonal, U on and above it
+    size_t p[N] = {}; // row i of PA is row p[i] of A
+    int sign = 0;     // det P, 0 if A is singular
+
+  public:
+    constexpr explicit LU(const Tensor<N, T> &A) noexcept;
+
+    constexpr bool singular() const noexcept { return sign == 0; }
+    constexpr T det() const noexcept;
+
+    // solutions of A x = b and A X = B, zero if A is singular as of Tensor::invert()
+    template<class layout_policy>
+      constexpr Vector<N, T, true, layout_policy> solve(const Vector<N, T, true, layout_policy> &b) const noexcept;
+    constexpr Tensor<N, T> solve(const Tensor<N, T> &B) const noexcept;
+    constexpr Tensor<N, T> invert() const noexcept { return solve(Tensor<N, T>(1)); }
+  }; // class LU<N, T>
+
+/*---------------------------------------------------------------------------------------*/
+
+  // A = L ~L for symmetric positive definite tensors, only the lower triangle of A is used
+  template<size_t N, std::floating_point T = double> class Cholesky
+  {
+    Tensor<N, T> l; // lower triangular factor, zero above the diagonal
+    bool failed = false;
+
+  public:
+    constexpr explicit Cholesky(const Tensor<N, T> &A) noexcept;
+
+    // A is not positive definite (numerically)
+    constexpr bool singular() const noexcept { return failed; }
+    constexpr T det() const noexcept;
+    constexpr const Tensor<N, T>& L() const noexcept { return l; }
+
+    // solutions of A x = b and A X = B, zero if A is not positive definite
+    template<class layout_policy>
+      constexpr Vector<N, T, true, layout_policy> solve(const Vector<N, T, true, layout_policy> &b) const noexcept;
+    constexpr Tensor<N, T> solve(const Tensor<N, T> &B) const noexcept;
+  }; // class Cholesky<N, T>
+
+/*---------------------------------------------------------------------------------------*/
+
+  // A = QR by Householder reflections, Q is orthogonal and R is upper triangular
+  template<size_t N, std::floating_point T = double> class QR
+  {
+    Tensor<N, T> qt; // ~Q
+    Tensor<N, T> r;
+    int sign = 1;    // det Q
+
+  public:
+    constexpr explicit QR(const Tensor<N, T> &A) noexcept;
+
+    // |R[k][k]| <= N*epsilon*max |R[i][i]| for some k
+    constexpr bool singular() const noexcept;
+    constexpr T det() const noexcept;
+    constexpr Tensor<N, T> Q() const noexcept { return ~qt; }
+    constexpr const Tensor<N, T>& R() const noexcept { return r; }
+
+    // solutions of A x = b and A X = B, zero if A is singular
+    template<class layout_policy>
+      constexpr Vector<N, T, true, layout_policy> solve(const Vector<N, T, true, layout_policy> &b) const noexcept;
+    constexpr Tensor<N, T> solve(const Tensor<N, T> &B) const noexcept;
+  }; // class QR<N, T>
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  constexpr Math::LU<N, T>::LU(const Tensor<N, T> &A) noexcept : lu(A)
+{
+  sign = details::impl::lu_decompose(lu, p);
+}
+
+template<size_t N, std::floating_point T>
+  constexpr T Math::LU<N, T>::det() const noexcept
+{
+  T d = static_cast<T>(sign);
+  for (size_t k = 0; k < N; ++k)
+    d *= lu[k][k];
+  return d;
+}
+
+template<size_t N, std::floating_point T>
+template<class layout_policy>
+  constexpr auto Math::LU<N, T>::solve(const Vector<N, T, true, layout_policy> &b) const noexcept
+    -> Vector<N, T, true, layout_policy>
+{
+  if (singular())
+    return Vector<N, T, true, layout_policy>();
+  return details::impl::lu_solve(lu, p, b);
+}
+
+template<size_t N, std::floating_point T>
+  constexpr auto Math::LU<N, T>::solve(const Tensor<N, T> &B) const noexcept -> Tensor<N, T>
+{
+  if (singular())
+    return Tensor<N, T>(0);
+  return details::impl::lu_solve(lu, p, B);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  constexpr Math::Cholesky<N, T>::Cholesky(const Tensor<N, T> &A) noexcept
+{
+  for (size_t j = 0; j < N; ++j)
+  {
+    T d = A[j][j];
+    for (size_t k = 0; k < j; ++k)
+      d -= l[j][k] * l[j][k];
+    if (!(d > 0))
+    {
+      failed = true;
+      return;
+    }
+    l[j][j] = details::sqrt(d);
+
+    const T r = T(1) / l[j][j];
+    for (size_t i = j + 1; i < N; ++i)
+    {
+      T s = A[i][j];
+      for (size_t k = 0; k < j; ++k)
+        s -= l[i][k] * l[j][k];
+      l[i][j] = s * r;
+    }
+  }
+}
+
+template<size_t N, std::floating_point T>
+  constexpr T Math::Cholesky<N, T>::det() const noexcept
+{
+  if (failed)
+    return 0;
+  T d = 1;
+  for (size_t k = 0; k < N; ++k)
+    d *= l[k][k];
+  return d * d;
+}
+
+template<size_t N, std::floating_point T>
+template<class layout_policy>
+  constexpr auto Math::Cholesky<N, T>::solve(const Vector<N, T, true, layout_policy> &b) const noexcept
+    -> Vector<N, T, true, layout_policy>
+{
+  Vector<N, T, true, layout_policy> x;
+  if (failed)
+    return x;
+  // L y = b
+  for (size_t i = 0; i < N; ++i)
+  {
+    T s = b[i];
+    for (size_t k = 0; k < i; ++k)
+      s -= l[i][k] * x[k];
+    x[i] = s / l[i][i];
+  }
+  // ~L x = y
+  for (size_t i = N; i-- > 0;)
+  {
+    T s = x[i];
+    for (size_t k = i + 1; k < N; ++k)
+      s -= l[k][i] * x[k];
+    x[i] = s / l[i][i];
+  }
+  return x;
+}
+
+template<size_t N, std::floating_point T>
+  constexpr auto Math::Cholesky<N, T>::solve(const Tensor<N, T> &B) const noexcept -> Tensor<N, T>
+{
+  if (failed)
+    return Tensor<N, T>(0);
+
+  // all the columns at once by row operations
+  auto X = B;
+  for (size_t i = 0; i < N; ++i)
+  {
+    for (size_t k = 0; k < i; ++k)
+      for (size_t j = 0; j < N; ++j)
+        X[i][j] -= l[i][k] * X[k][j];
+    const T r = T(1) / l[i][i];
+    for (size_t j = 0; j < N; ++j)
+      X[i][j] *= r;
+  }
+  for (size_t i = N; i-- > 0;)
+  {
+    for (size_t k = i + 1; k < N; ++k)
+      for (size_t j = 0; j < N; ++j)
+        X[i][j] -= l[k][i] * X[k][j];
+    const T r = T(1) / l[i][i];
+    for (size_t j = 0; j < N; ++j)
+      X[i][j] *= r;
+  }
+  return X;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  constexpr Math::QR<N, T>::QR(const Tensor<N, T> &A) noexcept : qt(1), r(A)
+{
+  // reflection H = E - 2 v ~v / (v v) zeroes the column k of R below the diagonal,
+  // the same reflections applied to E give ~Q
+  for (size_t k = 0; k + 1 < N; ++k)
+  {
+    T v[N] = {}, vv = 0;
+    for (size_t i = k; i < N; ++i)
+    {
+      v[i] = r[i][k];
+      vv += v[i] * v[i];
+    }
+    if (vv == 0)
+      continue;
+    const T alpha = (v[k] > 0)? -details::sqrt(vv) : details::sqrt(vv);
+    vv += (v[k] - alpha) * (v[k] - alpha) - v[k] * v[k];
+    v[k] -= alpha;
+    const T c = T(2) / vv;
+
+    auto reflect = [&](Tensor<N, T> &A)
+    {
+      for (size_t j = 0; j < N; ++j)
+      {
+        T s = 0;
+        for (size_t i = k; i < N; ++i)
+          s += v[i] * A[i][j];
+        s *= c;
+        for (size_t i = k; i < N; ++i)
+          A[i][j] -= s * v[i];
+      }
+    };
+    reflect(r);
+    reflect(qt);
+    sign = -sign;
+
+    r[k][k] = alpha;
+    for (size_t i = k + 1; i < N; ++i)
+      r[i][k] = 0;
+  }
+}
+
+template<size_t N, std::floating_point T>
+  constexpr bool Math::QR<N, T>::singular() const noexcept
+{
+  // the reflections are exact up to rounding, so is the rank deficiency
+  T rmax = 0;
+  for (size_t k = 0; k < N; ++k)
+    rmax = std::max(rmax, details::abs(r[k][k]));
+  const T eps = N * std::numeric_limits<T>::epsilon() * rmax;
+  for (size_t k = 0; k < N; ++k)
+    if (!(details::abs(r[k][k]) > eps))
+      return true;
+  return false;
+}
+
+template<size_t N, std::floating_point T>
+  constexpr T Math::QR<N, T>::det() const noexcept
+{
+  T d = static_cast<T>(sign);
+  for (size_t k = 0; k < N; ++k)
+    d *= r[k][k];
+  return d;
+}
+
+template<size_t N, std::floating_point T>
+template<class layout_policy>
+  constexpr auto Math::QR<N, T>::solve(const Vector<N, T, true, layout_policy> &b) const noexcept
+    -> Vector<N, T, true, layout_policy>
+{
+  if (singular())
+    return Vector<N, T, true, layout_policy>();
+  // R x = ~Q b
+  auto x = b;
+  x *= ~qt;
+  for (size_t i = N; i-- > 0;)
+  {
+    T s = x[i];
+    for (size_t k = i + 1; k < N; ++k)
+      s -= r[i][k] * x[k];
+    x[i] = s / r[i][i];
+  }
+  return x;
+}
+
+template<size_t N, std::floating_point T>
+  constexpr auto Math::QR<N, T>::solve(const Tensor<N, T> &B) const noexcept -> Tensor<N, T>
+{
+  if (singular())
+    return Tensor<N, T>(0);
+  auto X = qt * B;
+  for (size_t i = N; i-- > 0;)
+  {
+    for (size_t k = i + 1; k < N; ++k)
+      for (size_t j = 0; j < N; ++j)
+        X[i][j] -= r[i][k] * X[k][j];
+    const T c = T(1) / r[i][i];
+    for (size_t j = 0; j < N; ++j)
+      X[i][j] *= c;
+  }
+  return X;
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::Factorizations::tests
+{
+  // exact in binary floating point
+  constexpr Tensor2D A(2, 3, 4, 2), S(4, 2, 2, 5);
+  constexpr Vector2D b(8, 8);
+
+  constexpr LU<2> lu(A);
+  static_assert(!lu.singular() && lu.det() == -8 && lu.det() == A.det(), "LU det failed");
+  static_assert(lu.solve(b) == Vector2D(1, 2) && lu.solve(A) == Tensor2D(1.), "LU solve failed");
+  static_assert(lu.invert() == A.invert(), "LU invert failed");
+  static_assert(LU<2>(Tensor2D(1, 2, 2, 4)).singular(), "LU singular failed");
+  static_assert(LU<2>(Tensor2D(1, 2, 2, 4)).solve(b) == Vector2D(), "LU singular failed");
+
+  constexpr Cholesky<2> ch(S);
+  static_assert(!ch.singular() && ch.det() == 16 && ch.L() == Tensor2D(2, 0, 1, 2), "Cholesky failed");
+  static_assert(ch.solve(Vector2D(8, 12)) == Vector2D(1, 2), "Cholesky solve failed");
+  static_assert(ch.solve(S) == Tensor2D(1.), "Cholesky solve failed");
+  static_assert(Cholesky<2>(A).singular(), "Cholesky singular failed");
+  static_assert(Cholesky<2>(-S).solve(b) == Vector2D(), "Cholesky singular failed");
+
+  // reflection of (3, 4) to (-5, 0), the rest is rounded
+  constexpr QR<2> qr(Tensor2D(3, 1, 4, 2));
+  static_assert(qr.R()[0][0] == -5 && qr.R()[1][0] == 0, "QR failed");
+  static_assert(qr.det() > 2 - 1e-15 && qr.det() < 2 + 1e-15, "QR det failed");
+  static_assert(QR<2>(Tensor2D(1, 2, 2, 4)).singular(), "QR singular failed");
+} // namespace Math::Factorizations::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::LU
+  \brief LU decomposition with partial pivoting of a tensor, factored once, solved many times.
+  \tparam N Dimension of the tensor.
+  \tparam T Floating point type of the components.
+
+  Tensor::invert() costs O(N^3) for every use of `a / A` or `B / A`, while the solution by the
+  factors of A costs O(N^2) per right hand side (O(N^3) for a tensor one, without forming the
+  inverse). E.g. an implicit sweep with the same block Jacobian:
+  \code
+  const Math::LU<5> J(jacobian);  // factored once
+  for (auto &r : residuals)
+    r = J.solve(r);               // J^-1 r
+  \endcode
+  The division operators of Tensor.h use the same decomposition for N > 4.
+*/
+
+/*!
+  \class Math::Cholesky
+  \brief Cholesky decomposition A = L ~L of a symmetric positive definite tensor.
+
+  Half the flops of LU and no pivoting, e.g. for mass matrices or metric tensors. A tensor
+  which is not positive definite is reported by singular(), all the solutions are zero then.
+*/
+
+/*!
+  \class Math::QR
+  \brief QR decomposition of a tensor by Householder reflections.
+
+  Twice the flops of LU, but the factorization is backward stable without pivoting and Q()
+  gives an orthonormal basis, e.g. of the columns of a Jacobian.
+*/
+
+#endif // MATH_FACTORIZATION_H_INCLUDED
@@ -0,0 +1,369 @@
+#ifndef MATH_FAST_MATH_H_INCLUDED
+#define MATH_FAST_MATH_H_INCLUDED
+
+/*!
+  \file FastMath.h
+  \author gennadiy
+  \brief Batched square roots over arrays of floats and doubles and angle kernels over
+    arrays of vectors, definition, documentation and tests.
+*/
+
+#include "Vector.h"
+#include "details.h"
+#include <span>
+#include <cassert>
+#include <ranges>
+
+namespace Math
+{
+  // r[i] = sqrt(x[i])
+  inline void sqrt(std::span<const float> x, std::span<float> r) noexcept;
+  inline void sqrt(std::span<const double> x, std::span<double> r) noexcept;
+
+  // r[i] = 1/sqrt(x[i])
+  inline void rsqrt(std::span<const float> x, std::span<float> r) noexcept;
+  inline void rsqrt(std::span<const double> x, std::span<double> r) noexcept;
+
+  // r[i] = sqrt(x[i]*x[i] + y[i]*y[i])
+  inline void hypot(std::span<const float> x, std::span<const float> y, std::span<float> r) noexcept;
+  inline void hypot(std::span<const double> x, std::span<const double> y, std::span<double> r) noexcept;
+
+  // c[i], s[i] = cos and sin of the angle between a[i] and b[i]
+  template<std::ranges::contiguous_range R, std::ranges::contiguous_range RC, std::ranges::contiguous_range RS>
+    void cos_sin(const R &a, const R &b, RC &&c, RS &&s) noexcept;
+
+  // r[i] = a[i] / |a[i]|, r may coincide with a
+  template<std::ranges::contiguous_range R, std::ranges::contiguous_range RR>
+    void normalize(const R &a, RR &&r) noexcept;
+
+  // r[i] = angle between a[i] and b[i]
+  template<std::ranges::contiguous_range R, std::ranges::contiguous_range RR>
+    void angle(const R &a, const R &b, RR &&r) noexcept;
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+#if defined(MATH_SIMD_SSE2)
+  template<class T> void batch_sqrt(std::span<const T> x, std::span<T> r) noexcept
+  {
+    using P = simd::packed<T>;
+    size_t i = 0;
+    for (; i + P::width <= x.size(); i += P::width)
+      P::store(r.data() + i, P::sqrt(P::load(x.data() + i)));
+    for (; i < x.size(); ++i)
+      r[i] = std::sqrt(x[i]);
+  }
+
+  template<class T> void batch_rsqrt(std::span<const T> x, std::span<T> r) noexcept
+  {
+    using P = simd::packed<T>;
+    size_t i = 0;
+    if constexpr (std::is_same_v<T, float>)
+    {
+      // estimate with one Newton-Raphson step for normal values, exact value for the rest
+      const auto lo = P::set1(std::numeric_limits<float>::min());
+      const auto hi = P::set1(std::numeric_limits<float>::max());
+      const auto half = P::set1(0.5f), three_halves = P::set1(1.5f), one = P::set1(1.f);
+      for (; i + P::width <= x.size(); i += P::width)
+      {
+        auto a = P::load(x.data() + i);
+        auto y = P::rsqrt(a);
+        y = P::mul(y, P::sub(three_halves, P::mul(P::mul(half, a), P::mul(y, y))));
+        auto exact = P::div(one, P::sqrt(a));
+        P::store(r.data() + i, P::select(P::in_range(a, lo, hi), y, exact));
+      }
+    }
+    else
+    {
+      const auto one = P::set1(1.);
+      for (; i + P::width <= x.size(); i += P::width)
+        P::store(r.data() + i, P::div(one, P::sqrt(P::load(x.data() + i))));
+    }
+    for (; i < x.size(); ++i)
+      r[i] = details::rsqrt(x[i]);
+  }
+
+  template<class T> void batch_hypot(std::span<const T> x, std::span<const T> y, std::span<T> r) noexcept
+  {
+    using P = simd::packed<T>;
+    size_t i = 0;
+    for (; i + P::width <= x.size(); i += P::width)
+    {
+      auto a = P::load(x.data() + i), b = P::load(y.data() + i);
+      P::store(r.data() + i, P::sqrt(P::add(P::mul(a, a), P::mul(b, b))));
+    }
+    for (; i < x.size(); ++i)
+      r[i] = std::sqrt(x[i]*x[i] + y[i]*y[i]);
+  }
+#else
+  template<class T> void batch_sqrt(std::span<const T> x, std::span<T> r) noexcept
+  {
+    for (size_t i = 0; i < x.size(); ++i)
+      r[i] = std::sqrt(x[i]);
+  }
+
+  template<class T> void batch_rsqrt(std::span<const T> x, std::span<T> r) noexcept
+  {
+    for (size_t i = 0; i < x.size(); ++i)
+      r[i] = T{1} / std::sqrt(x[i]);
+  }
+
+  template<class T> void batch_hypot(std::span<const T> x, std::span<const T> y, std::span<T> r) noexcept
+  {
+    for (size_t i = 0; i < x.size(); ++i)
+      r[i] = std::sqrt(x[i]*x[i] + y[i]*y[i]);
+  }
+#endif
+} // namespace Math::details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+inline void Math::sqrt(std::span<const float> x, std::span<float> r) noexcept
+{
+  assert(x.size() == r.size());
+  details::impl::batch_sqrt(x, r);
+}
+
+inline void Math::sqrt(std::span<const double> x, std::span<double> r) noexcept
+{
+  assert(x.size() == r.size());
+  details::impl::batch_sqrt(x, r);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+inline void Math::rsqrt(std::span<const float> x, std::span<float> r) noexcept
+{
+  assert(x.size() == r.size());
+  details::impl::batch_rsqrt(x, r);
+}
+
+inline void Math::rsqrt(std::span<const double> x, std::span<double> r) noexcept
+{
+  assert(x.size() == r.size());
+  details::impl::batch_rsqrt(x, r);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+inline void Math::hypot(
+  std::span<const float> x, std::span<const float> y, std::span<float> r) noexcept
+{
+  assert(x.size() == r.size() && y.size() == r.size());
+  details::impl::batch_hypot(x, y, r);
+}
+
+inline void Math::hypot(
+  std::span<const double> x, std::span<const double> y, std::span<double> r) noexcept
+{
+  assert(x.size() == r.size() && y.size() == r.size());
+  details::impl::batch_hypot(x, y, r);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+  // angle kernels work on blocks of vectors, the loops over vectors are vectorized and
+  // the (reciprocal) square roots of a block are taken at once
+  inline constexpr size_t angle_block = 256;
+
+  // dot product, product of the squared norms and |a x b|^2 (or its equivalent for N > 3)
+  template<class V, class T> constexpr void pair_products(const V &a, const V &b, T &d, T &q, T &x) noexcept
+  {
+    constexpr size_t N = V::ncomps;
+    T aa = 0, bb = 0;
+    d = 0;
+    for (size_t k = 0; k < N; ++k)
+    {
+      d += a[k] * b[k];
+      aa += a[k] * a[k];
+      bb += b[k] * b[k];
+    }
+    q = aa * bb;
+    if constexpr (N == 2)
+      x = (a[0]*b[1] - a[1]*b[0]) * (a[0]*b[1] - a[1]*b[0]);
+    else if constexpr (N == 3)
+    {
+      T x0 = a[1]*b[2] - a[2]*b[1], x1 = a[2]*b[0] - a[0]*b[2], x2 = a[0]*b[1] - a[1]*b[0];
+      x = x0*x0 + x1*x1 + x2*x2;
+    }
+    else
+    {
+      x = q - d * d;
+      x = (x < T(0))? T(0) : x;
+    }
+  }
+
+  template<class V, class T> void batch_cos_sin(const V *a, const V *b, T *c, T *s, size_t n) noexcept
+  {
+    alignas(simd::alignment) T q[angle_block], x[angle_block];
+    for (size_t first = 0; first < n; first += angle_block)
+    {
+      const size_t m = std::min(angle_block, n - first);
+      MATH_SIMD_LOOP
+      for (size_t i = 0; i < m; ++i)
+        pair_products(a[first + i], b[first + i], c[first + i], q[i], x[i]);
+      Math::rsqrt(std::span<const T>(q, m), std::span<T>(q, m));
+      Math::sqrt(std::span<const T>(x, m), std::span<T>(x, m));
+      MATH_SIMD_LOOP
+      for (size_t i = 0; i < m; ++i)
+      {
+        c[first + i] *= q[i];
+        s[first + i] = x[i] * q[i];
+      }
+    }
+  }
+
+  template<class V, class T> void batch_normalize(const V *a, V *r, size_t n) noexcept
+  {
+    constexpr size_t N = V::ncomps;
+    alignas(simd::alignment) T q[angle_block];
+    for (size_t first = 0; first < n; first += angle_block)
+    {
+      const size_t m = std::min(angle_block, n - first);
+      MATH_SIMD_LOOP
+      for (size_t i = 0; i < m; ++i)
+      {
+        T aa = 0;
+        for (size_t k = 0; k < N; ++k)
+          aa += a[first + i][k] * a[first + i][k];
+        q[i] = aa;
+      }
+      Math::rsqrt(std::span<const T>(q, m), std::span<T>(q, m));
+      MATH_SIMD_LOOP
+      for (size_t i = 0; i < m; ++i)
+        for (size_t k = 0; k < N; ++k)
+          r[first + i][k] = a[first + i][k] * q[i];
+    }
+  }
+
+  template<class V, class T> void batch_angle(const V *a, const V *b, T *r, size_t n) noexcept
+  {
+    alignas(simd::alignment) T q[angle_block], x[angle_block];
+    for (size_t first = 0; first < n; first += angle_block)
+    {
+      const size_t m = std::min(angle_block, n - first);
+      MATH_SIMD_LOOP
+      for (size_t i = 0; i < m; ++i)
+        pair_products(a[first + i], b[first + i], r[first + i], q[i], x[i]);
+      Math::sqrt(std::span<const T>(x, m), std::span<T>(x, m));
+      for (size_t i = 0; i < m; ++i)
+        r[first + i] = std::atan2(x[i], r[first + i]);
+    }
+  }
+
+  // components of euclidian vectors of floating point types
+  template<class V> struct real_vector {};
+  template<size_t N, std::floating_point T, class L> struct real_vector<Vector<N, T, true, L>>
+  {
+    using type = T;
+  };
+  template<class R> using real_vector_t = typename real_vector<std::ranges::range_value_t<R>>::type;
+} // namespace Math::details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::contiguous_range R, std::ranges::contiguous_range RC, std::ranges::contiguous_range RS>
+  void Math::cos_sin(const R &a, const R &b, RC &&c, RS &&s) noexcept
+{
+  using T = details::impl::real_vector_t<R>;
+  static_assert(std::same_as<T, std::ranges::range_value_t<RC>> && std::same_as<T, std::ranges::range_value_t<RS>>,
+    "Results must be of the vectors' components type.");
+  const auto n = static_cast<size_t>(std::ranges::size(a));
+  assert(std::ranges::size(b) == n && std::ranges::size(c) == n && std::ranges::size(s) == n);
+  details::impl::batch_cos_sin(
+    std::ranges::data(a), std::ranges::data(b), std::ranges::data(c), std::ranges::data(s), n);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::contiguous_range R, std::ranges::contiguous_range RR>
+  void Math::normalize(const R &a, RR &&r) noexcept
+{
+  using V = std::ranges::range_value_t<R>;
+  static_assert(std::same_as<V, std::ranges::range_value_t<RR>>, "Results must be of the same type.");
+  const auto n = static_cast<size_t>(std::ranges::size(a));
+  assert(std::ranges::size(r) == n);
+  details::impl::batch_normalize<V, details::impl::real_vector_t<R>>(
+    std::ranges::data(a), std::ranges::data(r), n);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::contiguous_range R, std::ranges::contiguous_range RR>
+  void Math::angle(const R &a, const R &b, RR &&r) noexcept
+{
+  static_assert(std::same_as<details::impl::real_vector_t<R>, std::ranges::range_value_t<RR>>,
+    "Results must be of the vectors' components type.");
+  const auto n = static_cast<size_t>(std::ranges::size(a));
+  assert(std::ranges::size(b) == n && std::ranges::size(r) == n);
+  details::impl::batch_angle(std::ranges::data(a), std::ranges::data(b), std::ranges::data(r), n);
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ documentation ------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \fn void Math::sqrt(std::span<const double> x, std::span<double> r) noexcept
+  \brief Batched square root, r[i] = sqrt(x[i]).
+  \param x Arguments.
+  \param r Results, must have the same size as the arguments, may coincide with them.
+
+  Packed hardware instructions are used (SSE2 or AVX). Unlike Math::details::sqrt,
+  negative arguments give NaN as std::sqrt does.
+*/
+
+/*!
+  \fn void Math::rsqrt(std::span<const float> x, std::span<float> r) noexcept
+  \brief Batched reciprocal square root, r[i] = 1/sqrt(x[i]).
+  \param x Arguments.
+  \param r Results, must have the same size as the arguments, may coincide with them.
+
+  For floats the hardware estimate refined by a single Newton-Raphson step is used,
+  relative error is less than 5e-7 (i.e. a few ulps). Zero, subnormal, infinite and negative
+  arguments are processed exactly, i.e. they give infinity, exact value, zero and NaN
+  correspondingly. For doubles there is no fast estimate, 1/sqrt(x) is computed in packed form.
+*/
+
+/*!
+  \fn void Math::hypot(std::span<const double> x, std::span<const double> y, std::span<double> r) noexcept
+  \brief Batched length of hypotenuse, r[i] = sqrt(x[i]*x[i] + y[i]*y[i]).
+  \param x Legs.
+  \param y Other legs.
+  \param r Results, must have the same size as the arguments, may coincide with them.
+
+  NB! There is no protection against overflow/underflow of the squares unlike std::hypot,
+  i.e. the arguments should be less than sqrt(std::numeric_limits<T>::max()).
+*/
+
+/*!
+  \fn void Math::cos_sin(const R &a, const R &b, RC &&c, RS &&s) noexcept
+  \brief Batched cosines and sines of the angles between pairs of vectors.
+  \param a Contiguous range of euclidian vectors, e.g. std::vector<Vector3D>.
+  \param b Other vectors of the pairs, the same size and type.
+  \param c Cosines, contiguous range of the components' type.
+  \param s Sines, the same.
+
+  Fused version of Math::cos and Math::sin: per pair, one reciprocal square root of the product
+  of the squared norms and one square root of |a x b|^2, both batched (see Math::rsqrt).
+  The sine is computed from the cross product in 2D and 3D, so it is accurate for small angles.
+  NB! As for Math::hypot, the product |a|^2 |b|^2 must not overflow.
+*/
+
+/*!
+  \fn void Math::angle(const R &a, const R &b, RR &&r) noexcept
+  \brief Batched angles in [0, pi] between pairs of vectors, atan2(|a x b|, a b).
+  \param a Contiguous range of euclidian vectors.
+  \param b Other vectors of the pairs, the same size and type.
+  \param r Angles, contiguous range of the components' type.
+
+  Vectors need not be normalized, only the cross product's magnitude takes a square root.
+*/
+
+#endif // MATH_FAST_MATH_H_INCLUDED
@@ -0,0 +1,317 @@
+#ifndef MATH_HALF_H_INCLUDED
+#define MATH_HALF_H_INCLUDED
+
+/*!
+  \file Half.h
+  \author gennadiy
+  \brief 16-bit floating point storage types, definition, documentation and tests.
+*/
+
+#include "Tensor.h"
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <ranges>
+
+namespace Math
+{
+  // bit formats of 16-bit floats, conversions round to nearest even
+  namespace Float16Format
+  {
+    // IEEE 754 binary16: 5 bits of exponent, 10 bits of mantissa
+    struct IEEE
+    {
+      static constexpr uint16_t encode(float x) noexcept;
+      static constexpr float decode(uint16_t h) noexcept;
+    };
+
+    // bfloat16: upper half of binary32, 8 bits of exponent, 7 bits of mantissa
+    struct Brain
+    {
+      static constexpr uint16_t encode(float x) noexcept;
+      static constexpr float decode(uint16_t h) noexcept;
+    };
+  } // namespace Float16Format
+
+  // 16-bit floating point number, arithmetic is done in float
+  template<class format_policy> class Float16
+  {
+    uint16_t h = 0;
+
+  public:
+    using format = format_policy;
+
+    // ctors
+    constexpr Float16() noexcept = default;
+    template<class A> requires std::is_arithmetic_v<A>
+      constexpr Float16(A x) noexcept : h(format::encode(static_cast<float>(x))) {}
+
+    static constexpr Float16 from_bits(uint16_t b) noexcept { Float16 r; r.h = b; return r; }
+    constexpr uint16_t bits() const noexcept { return h; }
+
+    // converters, double ones go through float
+    constexpr explicit operator float() const noexcept { return format::decode(h); }
+
+    // unary ops
+    constexpr Float16 operator+() const noexcept { return *this; }
+    constexpr Float16 operator-() const noexcept { return from_bits(h ^ 0x8000); }
+
+    // assign-ops
+    constexpr Float16& operator+=(Float16 a) noexcept { return *this = float(*this) + float(a); }
+    constexpr Float16& operator-=(Float16 a) noexcept { return *this = float(*this) - float(a); }
+    constexpr Float16& operator*=(Float16 a) noexcept { return *this = float(*this) * float(a); }
+    constexpr Float16& operator/=(Float16 a) noexcept { return *this = float(*this) / float(a); }
+
+    // arithmetic ops
+    friend constexpr Float16 operator+(Float16 a, Float16 b) noexcept { return a += b; }
+    friend constexpr Float16 operator-(Float16 a, Float16 b) noexcept { return a -= b; }
+    friend constexpr Float16 operator*(Float16 a, Float16 b) noexcept { return a *= b; }
+    friend constexpr Float16 operator/(Float16 a, Float16 b) noexcept { return a /= b; }
+
+    // comparison ops, as floats: -0 == +0, NaN is unordered
+    friend constexpr bool operator==(Float16 a, Float16 b) noexcept { return float(a) == float(b); }
+    friend constexpr auto operator<=>(Float16 a, Float16 b) noexcept { return float(a) <=> float(b); }
+
+    // functions in float, found by ADL, e.g. for fabs and normalize of vectors
+    friend constexpr Float16 abs(Float16 a) noexcept { return details::abs(float(a)); }
+    friend constexpr Float16 sqrt(Float16 a) noexcept { return details::sqrt(float(a)); }
+
+    // IO ops
+    friend std::ostream& operator<<(std::ostream &out, Float16 a) { return out << float(a); }
+    friend std::istream& operator>>(std::istream &in, Float16 &a)
+    {
+      float x;
+      if (in >> x)
+        a = x;
+      return in;
+    }
+  }; // class Float16<format_policy>
+
+  using Half = Float16<Float16Format::IEEE>;       //! IEEE half precision
+  using BFloat16 = Float16<Float16Format::Brain>;  //! brain floating point
+
+/*---------------------------------------------------------------------------------------*/
+
+  // bulk conversion of numbers, vectors or tensors between 16-bit floats and float or double,
+  // ranges must be contiguous and have the same size
+  template<std::ranges::contiguous_range R1, std::ranges::contiguous_range R2>
+    void convert(const R1 &from, R2 &&to) noexcept;
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+constexpr uint16_t Math::Float16Format::IEEE::encode(float x) noexcept
+{
+  uint32_t f = std::bit_cast<uint32_t>(x);
+  const auto sign = static_cast<uint16_t>((f >> 16) & 0x8000);
+  f &= 0x7fffffff;
+
+  // NaN stays quiet NaN, too large values including the ones rounded up to 65520 become Inf
+  if (f >= 0x7f800000)
+    return sign | ((f > 0x7f800000)? 0x7e00 : 0x7c00);
+  if (f >= 0x477ff000)
+    return sign | 0x7c00;
+
+  // subnormals are rounded by the addition of 0.5 whose ulp is the one of the subnormals
+  if (f < 0x38800000)
+    return sign | static_cast<uint16_t>(std::bit_cast<uint32_t>(std::bit_cast<float>(f) + 0.5f) - 0x3f000000);
+
+  // normals: exponent is rebiased, the mantissa is rounded to nearest even
+  f += 0xc8000fff + ((f >> 13) & 1);
+  return sign | static_cast<uint16_t>(f >> 13);
+}
+
+constexpr float Math::Float16Format::IEEE::decode(uint16_t h) noexcept
+{
+  const uint32_t sign = uint32_t(h & 0x8000) << 16;
+  const uint32_t e = (h >> 10) & 0x1f, m = h & 0x3ff;
+  if (e == 0) // zeros and subnormals
+    return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(static_cast<float>(m) * 0x1p-24f));
+  if (e == 0x1f) // Inf and NaN
+    return std::bit_cast<float>(sign | 0x7f800000 | (m << 13));
+  return std::bit_cast<float>(sign | ((e + 112) << 23) | (m << 13));
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+constexpr uint16_t Math::Float16Format::Brain::encode(float x) noexcept
+{
+  uint32_t f = std::bit_cast<uint32_t>(x);
+  if ((f & 0x7fffffff) > 0x7f800000)
+    return static_cast<uint16_t>((f >> 16) | 0x40); // quiet NaN
+  f += 0x7fff + ((f >> 16) & 1);
+  return static_cast<uint16_t>(f >> 16);
+}
+
+constexpr float Math::Float16Format::Brain::decode(uint16_t h) noexcept
+{
+  return std::bit_cast<float>(uint32_t(h) << 16);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+  // numbers, vectors and tensors as arrays of components
+  template<class E> struct components
+  {
+    using type = E;
+    static constexpr size_t count = 1;
+  };
+  template<size_t N, class T, bool B, class L> struct components<Vector<N, T, B, L>>
+  {
+    using type = T;
+    static constexpr size_t count = Vector<N, T, B, L>::nlanes; // padding lanes are zeros
+  };
+  template<size_t N, class T> struct components<Tensor<N, T>>
+  {
+    using type = T;
+    static constexpr size_t count = N*N;
+  };
+
+  template<class T> inline constexpr bool is_float16 = false;
+  template<class F> inline constexpr bool is_float16<Float16<F>> = true;
+
+  template<class From, class To>
+    concept float16_conversion =
+      components<From>::count == components<To>::count
+      && sizeof(From) == components<From>::count * sizeof(typename components<From>::type)
+      && sizeof(To) == components<To>::count * sizeof(typename components<To>::type)
+      && ((is_float16<typename components<From>::type> && std::floating_point<typename components<To>::type>)
+        || (std::floating_point<typename components<From>::type> && is_float16<typename components<To>::type>));
+
+  template<class F, class T> void convert_n(const Float16<F> *x, T *r, size_t n) noexcept
+  {
+    size_t i = 0;
+#if defined(MATH_SIMD_F16C)
+    if constexpr (std::is_same_v<F, Float16Format::IEEE>)
+    {
+      for (const size_t m = n - n % 8; i < m; i += 8)
+      {
+        auto a = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        if constexpr (std::is_same_v<T, float>)
+          _mm256_storeu_ps(r + i, a);
+        else
+        {
+          _mm256_storeu_pd(r + i, _mm256_cvtps_pd(_mm256_castps256_ps128(a)));
+          _mm256_storeu_pd(r + i + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)));
+        }
+      }
+    }
+#endif
+    MATH_SIMD_LOOP
+    for (; i < n; ++i)
+      r[i] = static_cast<T>(static_cast<float>(x[i]));
+  }
+
+  template<class T, class F> void convert_n(const T *x, Float16<F> *r, size_t n) noexcept
+  {
+    size_t i = 0;
+#if defined(MATH_SIMD_F16C)
+    if constexpr (std::is_same_v<F, Float16Format::IEEE>)
+    {
+      for (const size_t m = n - n % 8; i < m; i += 8)
+      {
+        __m256 a;
+        if constexpr (std::is_same_v<T, float>)
+          a = _mm256_loadu_ps(x + i);
+        else
+          a = _mm256_set_m128(_mm256_cvtpd_ps(_mm256_loadu_pd(x + i + 4)), _mm256_cvtpd_ps(_mm256_loadu_pd(x + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), _mm256_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT));
+      }
+    }
+#endif
+    MATH_SIMD_LOOP
+    for (; i < n; ++i)
+      r[i] = Float16<F>(static_cast<float>(x[i]));
+  }
+} // namespace Math::details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::contiguous_range R1, std::ranges::contiguous_range R2>
+  void Math::convert(const R1 &from, R2 &&to) noexcept
+{
+  using From = std::ranges::range_value_t<R1>;
+  using To = std::ranges::range_value_t<R2>;
+  using C1 = details::impl::components<From>;
+  using C2 = details::impl::components<To>;
+  static_assert(details::impl::float16_conversion<From, To>,
+    "Conversion is between 16-bit floats and float or double only, vectors must have the same layout.");
+
+  const auto n = static_cast<size_t>(std::ranges::size(from));
+  assert(n == static_cast<size_t>(std::ranges::size(to)));
+  details::impl::convert_n(
+    reinterpret_cast<const typename C1::type*>(std::ranges::data(from)),
+    reinterpret_cast<typename C2::type*>(std::ranges::data(to)), n * C1::count);
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::Float16s::tests
+{
+  static_assert(Type<Half> && Type<BFloat16>, "Type failed");
+  static_assert(sizeof(Half) == 2 && sizeof(Vector<3, Half>) == 6 && sizeof(PaddedVector<3, Half>) == 8, "size failed");
+
+  static_assert(Half(1).bits() == 0x3c00 && Half(-2.).bits() == 0xc000, "encoding failed");
+  static_assert(Half(65504).bits() == 0x7bff && Half(65519.f).bits() == 0x7bff, "max failed");
+  static_assert(Half(65520.f).bits() == 0x7c00 && Half(-1e10).bits() == 0xfc00, "overflow failed");
+  static_assert(Half(0x1p-24f).bits() == 1 && Half(0x1p-25f).bits() == 0 && Half(0x1.8p-24f).bits() == 2, "subnormals failed");
+  static_assert(Half(1.f + 0x1p-11f).bits() == 0x3c00 && Half(1.f + 0x3p-11f).bits() == 0x3c02, "rounding failed");
+  static_assert(float(Half::from_bits(1)) == 0x1p-24f && float(Half::from_bits(0x7bff)) == 65504.f, "decoding failed");
+  static_assert(Half::from_bits(0x7e00) != Half::from_bits(0x7e00) && Half(0.) == -Half(0.), "comparison failed");
+
+  static_assert(BFloat16(1).bits() == 0x3f80 && BFloat16(-2.f).bits() == 0xc000, "encoding failed");
+  static_assert(BFloat16(1.f + 0x1p-8f).bits() == 0x3f80 && BFloat16(1.f + 0x3p-8f).bits() == 0x3f82, "rounding failed");
+  static_assert(float(BFloat16(3e38f)) > 2.99e38f, "range failed");
+
+  static_assert(Half(1) + Half(2) == Half(3) && Half(3) / 2 == Half(1.5) && Half(1) < Half(2), "arithmetic failed");
+  static_assert(Vector<3, Half>(1, 2, 3) * Vector<3, Half>(4, 5, 6) == Half(32), "vector failed");
+  static_assert(sqrt(Half(2.25)) == Half(1.5) && abs(BFloat16(-3)) == BFloat16(3), "functions failed");
+  static_assert(fabs(Vector<3, Half>(1, 2, 2)) == Half(3), "fabs failed");
+  static_assert(normalize(Vector<3, Half>(0, -4, 0)) == Vector<3, Half>(0, -1, 0), "normalize failed");
+  static_assert(Tensor<2, Half>(1, 2, 3, 4).det() == Half(-2), "tensor failed");
+} // namespace Math::Float16s::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::Float16
+  \brief 16-bit floating point number for storage of the data tolerating lower precision.
+  \tparam format_policy Bit format: Float16Format::IEEE (Math::Half, 11 significant bits,
+    range 6e-8...65504) or Float16Format::Brain (Math::BFloat16, 8 significant bits,
+    range of float).
+
+  Satisfies Math::Type, thus vectors and tensors of 16-bit floats store old time levels
+  or output-only fields in a half of the memory of floats and a quarter of doubles.
+  Every operation converts to float, computes and rounds the result back to nearest even,
+  hence long computations should be done in float or double after Math::convert.
+  Conversions from double go through float, i.e. may be rounded twice.
+*/
+
+/*!
+  \fn void Math::convert(const R1 &from, R2 &&to) noexcept
+  \brief Converts an array of 16-bit floats to float or double or back.
+  \param from Contiguous range of numbers, Math::Vector or Math::Tensor.
+  \param to Contiguous range of the same size with the other type of the components.
+
+  Vectors must have the same number of lanes, i.e. both packed or both padded.
+  Half precision is converted by F16C instructions 8 numbers at a time if they are enabled
+  (e.g. \c -mf16c or \c -march=native), other conversions are vectorized by the compiler.
+  \code
+  std::vector<Vector3D> u(n);
+  std::vector<Vector<3, Half>> u_old(n);
+  Math::convert(u, u_old);
+  \endcode
+*/
+
+#endif // MATH_HALF_H_INCLUDED
@@ -0,0 +1,367 @@
+#ifndef MATH_KD_TREE_H_INCLUDED
+#define MATH_KD_TREE_H_INCLUDED
+
+/*!
+  \file KdTree.h
+  \author gennadiy
+  \brief Implicit k-d tree over point sets with batched neighbour queries, definition and documentation.
+*/
+
+#include "SpaceCurves.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Math
+{
+  // point found by a query
+  template<std::floating_point T> struct Neighbour
+  {
+    size_t index = std::numeric_limits<size_t>::max(); // in the range the tree is built of
+    T sqr_distance = std::numeric_limits<T>::infinity();
+
+    friend constexpr bool operator==(const Neighbour&, const Neighbour&) = default;
+  }; // struct Neighbour<T>
+
+  // balanced k-d tree without pointers, nodes are implied by the median splits
+  template<size_t N, std::floating_point T = double> class KdTree
+  {
+  public:
+    using point_type = Vector<N, T>;
+    using neighbour_type = Neighbour<T>;
+
+    KdTree() = default;
+    template<std::ranges::random_access_range R> explicit KdTree(const R &points, size_t leaf_size = 8);
+
+    size_t size() const noexcept { return pts.size(); }
+    bool empty() const noexcept { return pts.empty(); }
+
+    // points in the tree order and their indices in the original range
+    std::span<const point_type> points() const noexcept { return pts; }
+    std::span<const size_t> indices() const noexcept { return idx; }
+
+    // single queries, the nearest point of an empty tree is neighbour_type(), i.e. none at infinity
+    neighbour_type nearest(const point_type &q) const;
+    std::vector<neighbour_type> knn(const point_type &q, size_t k) const;
+    std::vector<size_t> radius(const point_type &q, T r) const;
+
+    // batched queries: k nearest of queries[j] are result[j*k, (j + 1)*k),
+    // points within r of queries[j] are result[offsets[j], offsets[j + 1])
+    void knn(std::span<const point_type> queries, size_t k, std::span<neighbour_type> result) const;
+    void radius(std::span<const point_type> queries, T r,
+                std::vector<size_t> &offsets, std::vector<size_t> &result) const;
+
+  private:
+    // number of queries sharing a traversal
+    static constexpr size_t packet = 8;
+
+    std::vector<point_type> pts; // points in the tree order
+    std::vector<size_t> idx;     // their original indices
+    std::vector<T> split;        // split values of internal nodes, children of node i are 2i + 1 and 2i + 2
+    std::vector<uint8_t> axis;   // split axes of internal nodes
+    size_t depth = 0;            // all the leaves have this depth
+
+    std::vector<size_t> query_order(std::span<const point_type> queries) const;
+
+    template<class Worst, class Leaf>
+      void search(const point_type *q, uint32_t mask, size_t node, size_t level,
+                  size_t first, size_t last, const Worst &worst, Leaf &leaf) const;
+  }; // class KdTree<N, T>
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+template<std::ranges::random_access_range R>
+  Math::KdTree<N, T>::KdTree(const R &points, size_t leaf_size)
+{
+  assert(leaf_size > 0);
+  const auto n = static_cast<size_t>(std::ranges::distance(points));
+  while (((n - 1) >> depth) + 1 > leaf_size && n > 0)
+    ++depth;
+
+  // points are permuted together with their indices
+  std::vector<std::pair<point_type, size_t>> items(n);
+  auto it = std::ranges::begin(points);
+  Parallel::for_each(n, 1 << 14, [&](size_t i) { items[i] = {point_type(it[i]), i}; });
+
+  // level by level, nodes of a level are independent; the node range is split at the middle,
+  // so that the ranges of the nodes are known w/o storing them
+  split.resize((size_t(1) << depth) - 1);
+  axis.resize(split.size());
+  std::vector<size_t> bounds = {0, n}, next;
+  for (size_t level = 0; level < depth; ++level)
+  {
+    const size_t nodes = size_t(1) << level;
+    next.resize(2*nodes + 1);
+    Parallel::for_each(nodes, 1, [&](size_t j)
+    {
+      const size_t first = bounds[j], last = bounds[j + 1], mid = first + (last - first)/2;
+
+      // axis of the largest extent of the node
+      point_type lo = items[first].first, hi = lo;
+      for (size_t i = first + 1; i < last; ++i)
+        for (size_t c = 0; c < N; ++c)
+        {
+          lo[c] = std::min(lo[c], items[i].first[c]);
+          hi[c] = std::max(hi[c], items[i].first[c]);
+        }
+      size_t a = 0;
+      for (size_t c = 1; c < N; ++c)
+        a = (hi[a] - lo[a] < hi[c] - lo[c])? c : a;
+
+      std::nth_element(items.begin() + first, items.begin() + mid, items.begin() + last,
+        [a](const auto &x, const auto &y) { return x.first[a] < y.first[a]; });
+      axis[nodes - 1 + j] = static_cast<uint8_t>(a);
+      split[nodes - 1 + j] = items[mid].first[a];
+      next[2*j] = first;
+      next[2*j + 1] = mid;
+    });
+    next[2*nodes] = n;
+    bounds.swap(next);
+  }
+
+  pts.resize(n);
+  idx.resize(n);
+  Parallel::for_each(n, 1 << 14, [&](size_t i) { std::tie(pts[i], idx[i]) = items[i]; });
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+template<class Worst, class Leaf>
+  void Math::KdTree<N, T>::search(const point_type *q, uint32_t mask, size_t node, size_t level,
+                                  size_t first, size_t last, const Worst &worst, Leaf &leaf) const
+{
+  if (level == depth)
+  {
+    // each point of the leaf is loaded once for all the queries
+    for (size_t i = first; i < last; ++i)
+      for (uint32_t m = mask; m; m &= m - 1)
+      {
+        auto j = static_cast<unsigned>(std::countr_zero(m));
+        auto d = pts[i] - q[j];
+        leaf(j, i, d * d);
+      }
+    return;
+  }
+
+  const size_t mid = first + (last - first)/2;
+  const size_t a = axis[node];
+  const T s = split[node];
+
+  // the side where most of the queries are goes first
+  uint32_t left = 0;
+  for (uint32_t m = mask; m; m &= m - 1)
+  {
+    auto j = static_cast<unsigned>(std::countr_zero(m));
+    left |= (q[j][a] < s)? (1u << j) : 0u;
+  }
+  const bool left_first = 2*std::popcount(left) >= std::popcount(mask);
+
+  for (bool go_left : {left_first, !left_first})
+  {
+    // the far side is visited by the queries whose balls cross the split plane
+    uint32_t sub = go_left? left : mask & ~left;
+    for (uint32_t m = mask & ~sub; m; m &= m - 1)
+    {
+      auto j = static_cast<unsigned>(std::countr_zero(m));
+      T d = q[j][a] - s;
+      sub |= (d * d <= worst(j))? (1u << j) : 0u;
+    }
+    if (sub)
+    {
+      if (go_left)
+        search(q, sub, 2*node + 1, level + 1, first, mid, worst, leaf);
+      else
+        search(q, sub, 2*node + 2, level + 1, mid, last, worst, leaf);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  std::vector<size_t> Math::KdTree<N, T>::query_order(std::span<const point_type> queries) const
+{
+  // nearby queries in the same packet visit mostly the same nodes
+  if constexpr (N == 2 || N == 3)
+    if (queries.size() > packet)
+      return hilbert_order(queries);
+
+  std::vector<size_t> order(queries.size());
+  std::iota(order.begin(), order.end(), size_t(0));
+  return order;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  void Math::KdTree<N, T>::knn(std::span<const point_type> queries, size_t k,
+                               std::span<neighbour_type> result) const
+{
+  assert(k <= size() && result.size() == queries.size() * k);
+  if (k == 0)
+    return;
+
+  auto farther = [](const neighbour_type &a, const neighbour_type &b)
+    { return a.sqr_distance < b.sqr_distance; };
+  auto order = query_order(queries);
+  const size_t nq = queries.size(), npackets = (nq + packet - 1)/packet;
+  Parallel::for_each(npackets, 16, [&](size_t b)
+  {
+    // k nearest points are collected in max-heaps placed right in the result
+    const size_t m = std::min(packet, nq - b*packet);
+    point_type q[packet];
+    neighbour_type *heap[packet];
+    size_t count[packet] = {};
+    for (size_t j = 0; j < m; ++j)
+    {
+      q[j] = queries[order[b*packet + j]];
+      heap[j] = result.data() + order[b*packet + j]*k;
+    }
+
+    auto worst = [&](unsigned j)
+      { return (count[j] < k)? std::numeric_limits<T>::infinity() : heap[j][0].sqr_distance; };
+    auto leaf = [&](unsigned j, size_t i, T d)
+    {
+      if (count[j] < k)
+      {
+        heap[j][count[j]++] = {i, d};
+        std::push_heap(heap[j], heap[j] + count[j], farther);
+      }
+      else if (d < heap[j][0].sqr_distance)
+      {
+        std::pop_heap(heap[j], heap[j] + k, farther);
+        heap[j][k - 1] = {i, d};
+        std::push_heap(heap[j], heap[j] + k, farther);
+      }
+    };
+    search(q, (1u << m) - 1, 0, 0, 0, size(), worst, leaf);
+
+    for (size_t j = 0; j < m; ++j)
+    {
+      std::sort_heap(heap[j], heap[j] + k, farther);
+      for (size_t i = 0; i < k; ++i)
+        heap[j][i].index = idx[heap[j][i].index];
+    }
+  });
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  void Math::KdTree<N, T>::radius(std::span<const point_type> queries, T r,
+                                  std::vector<size_t> &offsets, std::vector<size_t> &result) const
+{
+  const T r2 = r * r;
+  auto order = query_order(queries);
+  const size_t nq = queries.size(), npackets = (nq + packet - 1)/packet;
+  std::vector<std::vector<size_t>> found(nq);
+  Parallel::for_each(npackets, 16, [&](size_t b)
+  {
+    const size_t m = std::min(packet, nq - b*packet);
+    point_type q[packet];
+    std::vector<size_t> *f[packet];
+    for (size_t j = 0; j < m; ++j)
+    {
+      q[j] = queries[order[b*packet + j]];
+      f[j] = &found[order[b*packet + j]];
+    }
+
+    auto worst = [r2](unsigned) { return r2; };
+    auto leaf = [&](unsigned j, size_t i, T d)
+    {
+      if (d <= r2)
+        f[j]->push_back(idx[i]);
+    };
+    search(q, (1u << m) - 1, 0, 0, 0, size(), worst, leaf);
+  });
+
+  offsets.resize(nq + 1);
+  offsets[0] = 0;
+  for (size_t j = 0; j < nq; ++j)
+    offsets[j + 1] = offsets[j] + found[j].size();
+  result.resize(offsets[nq]);
+  Parallel::for_each(nq, 1 << 10, [&](size_t j)
+    { std::copy(found[j].begin(), found[j].end(), result.begin() + offsets[j]); });
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  auto Math::KdTree<N, T>::nearest(const point_type &q) const -> neighbour_type
+{
+  neighbour_type r;
+  if (!empty())
+    knn(std::span(&q, 1), 1, std::span(&r, 1));
+  return r;
+}
+
+template<size_t N, std::floating_point T>
+  auto Math::KdTree<N, T>::knn(const point_type &q, size_t k) const -> std::vector<neighbour_type>
+{
+  std::vector<neighbour_type> r(k);
+  knn(std::span(&q, 1), k, std::span(r));
+  return r;
+}
+
+template<size_t N, std::floating_point T>
+  std::vector<size_t> Math::KdTree<N, T>::radius(const point_type &q, T r) const
+{
+  std::vector<size_t> offsets, result;
+  radius(std::span(&q, 1), r, offsets, result);
+  return result;
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::KdTree
+  \brief Static k-d tree over a set of points for nearest neighbour and radius queries.
+  \tparam N Number of dimensions.
+  \tparam T Floating point type of the coordinates.
+
+  The tree is balanced: each node is split at the median along the axis of its largest extent,
+  and all the leaves have the same depth. Thus the nodes are implied by their numbers and
+  only split values and axes are stored, the points are copied in the tree order, so that
+  the points of a leaf are contiguous. Nodes of a level are built in parallel.
+
+  The tree keeps copies of the points, the range it was built of may be destroyed.
+*/
+
+/*!
+  \fn void Math::KdTree::knn(std::span<const point_type> queries, size_t k, std::span<neighbour_type> result) const
+  \brief k nearest neighbours of many points at once.
+  \param queries Query points.
+  \param k Number of neighbours, no more than the size of the tree.
+  \param result k neighbours of each query ordered by distance, must have size queries.size() * k.
+
+  The queries are ordered along the Hilbert curve (in 2D/3D) and traverse the tree by packets
+  of 8 nearby queries, so that the nodes and leaf points are loaded once per packet. Packets
+  are processed in parallel by Parallel::concurrency() threads. Ties between equidistant points
+  are broken arbitrarily.
+*/
+
+/*!
+  \fn void Math::KdTree::radius(std::span<const point_type> queries, T r, std::vector<size_t> &offsets, std::vector<size_t> &result) const
+  \brief Points within a distance of many points at once.
+  \param queries Query points.
+  \param r Distance, points at exactly r are included.
+  \param offsets Resized to queries.size() + 1, points near queries[j] are result[offsets[j], offsets[j + 1]).
+  \param result Indices of the found points (in the range the tree was built of), not sorted.
+*/
+
+#endif // MATH_KD_TREE_H_INCLUDED
@@ -0,0 +1,240 @@
+#ifndef MATH_OCT_NORMAL_H_INCLUDED
+#define MATH_OCT_NORMAL_H_INCLUDED
+
+/*!
+  \file OctNormal.h
+  \author gennadiy
+  \brief Octahedral encoding of unit vectors into 2 integers, definition, documentation and tests.
+*/
+
+#include "FastMath.h"
+#include "Vector.h"
+#include <cassert>
+#include <cstdint>
+#include <span>
+
+namespace Math
+{
+  // unit 3D vector compressed to 2 unsigned integers
+  template<std::unsigned_integral U> class OctNormal
+  {
+    U u = 0, v = 0;
+
+  public:
+    static constexpr int bits = 8 * sizeof(U);      // per component
+    static constexpr U max = static_cast<U>(~U(0) - 1); // largest code, even for exact axes
+
+    // upper bound of the angle (in radians) between a unit vector and its decoded value
+    static constexpr double max_error = 4.25 / static_cast<double>(max);
+
+    // ctors
+    constexpr OctNormal() noexcept = default;
+    constexpr OctNormal(U x, U y) noexcept : u(x), v(y) {}
+    template<std::floating_point T, class L>
+      constexpr explicit OctNormal(const Vector<3, T, true, L> &n) noexcept;
+
+    // decoded unit vector
+    template<std::floating_point T = double>
+      constexpr Vector<3, T> vector() const noexcept;
+
+    // codes
+    constexpr U x() const noexcept { return u; }
+    constexpr U y() const noexcept { return v; }
+
+    constexpr bool operator==(const OctNormal &) const noexcept = default;
+
+    // bulk conversions, spans must have the same size
+    static void encode(std::span<const Vector<3, double>> n, std::span<OctNormal> r) noexcept;
+    static void encode(std::span<const Vector<3, float>> n, std::span<OctNormal> r) noexcept;
+    static void decode(std::span<const OctNormal> e, std::span<Vector<3, double>> r) noexcept;
+    static void decode(std::span<const OctNormal> e, std::span<Vector<3, float>> r) noexcept;
+  }; // class OctNormal<U>
+
+  using OctNormal16 = OctNormal<uint16_t>; //! 4 bytes per normal
+  using OctNormal32 = OctNormal<uint32_t>; //! 8 bytes per normal
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+  // projection onto the octahedron |x| + |y| + |z| = 1 with its lower half unfolded
+  // onto the corners of the square [-1, 1]^2, quantized to the codes
+  template<class U, class T> constexpr OctNormal<U> oct_encode(T x, T y, T z) noexcept
+  {
+    T l1 = abs(x) + abs(y) + abs(z);
+    T s = (l1 > T())? T(1) / l1 : T(); // zero vector gives (0, 0, 1)
+    T px = x * s, py = y * s;
+    T fx = (T(1) - abs(py)) * ((px >= T())? T(1) : T(-1));
+    T fy = (T(1) - abs(px)) * ((py >= T())? T(1) : T(-1));
+    px = (z < T())? fx : px;
+    py = (z < T())? fy : py;
+
+    // rounded in double, floats don't have enough bits for 32-bit codes
+    constexpr double m = OctNormal<U>::max;
+    auto quantize = [m](T p)
+    {
+      double q = (static_cast<double>(p) + 1) * (0.5 * m) + 0.5;
+      q = (q > 0)? q : 0;
+      return static_cast<U>((q < m)? q : m);
+    };
+    return OctNormal<U>(quantize(px), quantize(py));
+  }
+
+  // not normalized vector of the codes, its magnitude is in [1/sqrt(3), 1]
+  template<class T, class U> constexpr void oct_decode(U u, U v, T &x, T &y, T &z) noexcept
+  {
+    constexpr double scale = 2. / static_cast<double>(OctNormal<U>::max);
+    x = static_cast<T>(static_cast<double>(u) * scale - 1);
+    y = static_cast<T>(static_cast<double>(v) * scale - 1);
+    z = T(1) - abs(x) - abs(y);
+
+    // corners are folded back to the lower half
+    T t = (z < T())? -z : T();
+    x += (x >= T())? -t : t;
+    y += (y >= T())? -t : t;
+  }
+
+  template<class U, class T>
+    void oct_encode(std::span<const Vector<3, T>> n, std::span<OctNormal<U>> r) noexcept
+  {
+    assert(n.size() == r.size());
+    for (size_t i = 0; i < n.size(); ++i)
+      r[i] = oct_encode<U>(n[i][0], n[i][1], n[i][2]);
+  }
+
+  template<class U, class T>
+    void oct_decode(std::span<const OctNormal<U>> e, std::span<Vector<3, T>> r) noexcept
+  {
+    assert(e.size() == r.size());
+
+    // blocks are decoded to separate components and normalized by the batched reciprocal
+    // square root, interleaving them only at the end is about twice faster
+    constexpr size_t block = 256;
+    alignas(simd::alignment) T x[block], y[block], z[block], q[block];
+    for (size_t first = 0; first < e.size(); first += block)
+    {
+      const size_t n = std::min(block, e.size() - first);
+      const OctNormal<U> *c = e.data() + first;
+      Vector<3, T> *v = r.data() + first;
+
+      MATH_SIMD_LOOP
+      for (size_t i = 0; i < n; ++i)
+      {
+        oct_decode(c[i].x(), c[i].y(), x[i], y[i], z[i]);
+        q[i] = x[i]*x[i] + y[i]*y[i] + z[i]*z[i];
+      }
+      Math::rsqrt(std::span<const T>(q, n), std::span<T>(q, n));
+      MATH_SIMD_LOOP
+      for (size_t i = 0; i < n; ++i)
+        v[i] = Vector<3, T>(x[i] * q[i], y[i] * q[i], z[i] * q[i]);
+    }
+  }
+} // namespace Math::details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::unsigned_integral U>
+template<std::floating_point T, class L>
+  constexpr Math::OctNormal<U>::OctNormal(const Vector<3, T, true, L> &n) noexcept
+    : OctNormal(details::impl::oct_encode<U>(n[0], n[1], n[2]))
+{
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::unsigned_integral U>
+template<std::floating_point T>
+  constexpr Math::Vector<3, T> Math::OctNormal<U>::vector() const noexcept
+{
+  T x, y, z;
+  details::impl::oct_decode(u, v, x, y, z);
+  return Vector<3, T>(x, y, z) / details::sqrt(x*x + y*y + z*z);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::unsigned_integral U>
+  void Math::OctNormal<U>::encode(std::span<const Vector<3, double>> n, std::span<OctNormal> r) noexcept
+{
+  details::impl::oct_encode<U>(n, r);
+}
+
+template<std::unsigned_integral U>
+  void Math::OctNormal<U>::encode(std::span<const Vector<3, float>> n, std::span<OctNormal> r) noexcept
+{
+  details::impl::oct_encode<U>(n, r);
+}
+
+template<std::unsigned_integral U>
+  void Math::OctNormal<U>::decode(std::span<const OctNormal> e, std::span<Vector<3, double>> r) noexcept
+{
+  details::impl::oct_decode<U>(e, r);
+}
+
+template<std::unsigned_integral U>
+  void Math::OctNormal<U>::decode(std::span<const OctNormal> e, std::span<Vector<3, float>> r) noexcept
+{
+  details::impl::oct_decode<U>(e, r);
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::OctNormals::tests
+{
+  static_assert(sizeof(OctNormal16) == 4 && sizeof(OctNormal32) == 8, "size failed");
+
+  // axes are exact
+  static_assert(OctNormal16(Vector3D(0, 0, 1)).vector() == Vector3D(0, 0, 1), "+z failed");
+  static_assert(OctNormal16(Vector3D(0, 0, -2)).vector() == Vector3D(0, 0, -1), "-z failed");
+  static_assert(OctNormal32(Vector3D(1, 0, 0)).vector() == Vector3D(1, 0, 0), "+x failed");
+  static_assert(OctNormal32(Vector3D(0, -1, 0)).vector() == Vector3D(0, -1, 0), "-y failed");
+  static_assert(OctNormal16(Vector3D(0, 0, 1)) == OctNormal16(32767, 32767), "codes failed");
+
+  // vectors need not be unit, zero one gives +z
+  static_assert(OctNormal16(Vector3D(3, 4, 5)) == OctNormal16(Vector3D(0.3, 0.4, 0.5)), "scaling failed");
+  static_assert(OctNormal16(Vector3D()).vector() == Vector3D(0, 0, 1), "zero vector failed");
+
+  constexpr Vector3D n(2, -3, -6); // |n| = 7
+  constexpr auto d = OctNormal32(n).vector();
+  static_assert(details::abs(d[0] - 2./7) < 1e-9 && details::abs(d[2] + 6./7) < 1e-9, "round trip failed");
+} // namespace Math::OctNormals::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::OctNormal
+  \brief Unit 3D vector compressed by the octahedral encoding to 2 unsigned integers.
+  \tparam U Type of the codes: uint16_t (4 bytes per normal, Math::OctNormal16)
+    or uint32_t (8 bytes per normal, Math::OctNormal32).
+
+  The vector is projected onto the octahedron |x| + |y| + |z| = 1, the lower half (z < 0)
+  is unfolded onto the corners of the square [-1, 1]^2 and both coordinates are quantized
+  to [0, 2^bits - 2] uniformly, so that the axes are encoded exactly. See Z. Cigolle et al.,
+  A Survey of Efficient Representations for Independent Unit Vectors, JCGT 3(2), 2014.
+
+  Since the projection scales distances by at most sqrt(3) and the octahedron has no more than
+  sqrt(6) times longer steps than the codes, the angle between a vector and its decoded value
+  is less than OctNormal::max_error = 4.25 / (2^bits - 2) radians, i.e. 6.5e-5 rad (0.0037 deg)
+  for 16-bit codes and 1e-9 rad for 32-bit ones (float vectors add their rounding ~1e-7).
+
+  Vectors to encode need not be unit, zero vector is encoded as (0, 0, 1).
+*/
+
+/*!
+  \fn static void Math::OctNormal::decode(std::span<const OctNormal> e, std::span<Vector<3, double>> r) noexcept
+  \brief Decodes an array of normals.
+  \param e Encoded normals.
+  \param r Unit vectors, must have the same size.
+
+  The loops are vectorized across normals, blocks of them are decoded to separate components
+  in L1 and normalized by the batched Math::rsqrt. Math::OctNormal::encode is the inverse operation.
+*/
+
+#endif // MATH_OCT_NORMAL_H_INCLUDED
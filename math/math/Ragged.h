@@ -0,0 +1,189 @@
+#ifndef MATH_RAGGED_H_INCLUDED
+#define MATH_RAGGED_H_INCLUDED
+
+/*!
+  \file Ragged.h
+  \author gennadiy
+  \brief Compressed ragged arrays (rows of different lengths in one buffer), definition and documentation.
+*/
+
+#include "common/Parallel.h"
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Math
+{
+  // offsets of the rows of a ragged array, row i holds the values [first(i), last(i))
+  class RaggedIndex
+  {
+    std::vector<size_t> start = {0};
+
+  public:
+    RaggedIndex() = default;
+    // rows of the given lengths, the offsets are computed by a parallel scan
+    template<std::ranges::random_access_range R> requires std::integral<std::ranges::range_value_t<R>>
+      explicit RaggedIndex(const R &counts);
+
+    size_t size() const noexcept { return start.size() - 1; }
+    bool empty() const noexcept { return size() == 0; }
+    size_t nvalues() const noexcept { return start.back(); }
+
+    size_t first(size_t i) const noexcept { assert(i < size()); return start[i]; }
+    size_t last(size_t i) const noexcept { assert(i < size()); return start[i + 1]; }
+    size_t row_size(size_t i) const noexcept { return last(i) - first(i); }
+
+    // size() + 1 offsets, i.e. the row pointers of CSR
+    std::span<const size_t> offsets() const noexcept { return start; }
+
+    // appends a row of n values
+    void push_back(size_t n) { start.push_back(start.back() + n); }
+    void clear() noexcept { start.assign(1, 0); }
+    void reserve(size_t nrows) { start.reserve(nrows + 1); }
+
+    friend bool operator==(const RaggedIndex &, const RaggedIndex &) = default;
+  }; // class RaggedIndex
+
+/*---------------------------------------------------------------------------------------*/
+
+  // rows of different lengths stored one after another in a single contiguous buffer
+  template<class E> class Ragged
+  {
+    RaggedIndex idx;
+    std::vector<E> data;
+
+  public:
+    using value_type = E;
+
+    Ragged() = default;
+    // default initialized values in the rows of the index
+    explicit Ragged(RaggedIndex index) : idx(std::move(index)), data(idx.nvalues()) {}
+    template<std::ranges::random_access_range R> requires std::integral<std::ranges::range_value_t<R>>
+      explicit Ragged(const R &counts) : Ragged(RaggedIndex(counts)) {}
+
+    // copy of a range of ranges, e.g. std::vector<std::vector<Vector3D>>, rows are copied in parallel
+    template<std::ranges::random_access_range R> requires std::ranges::sized_range<std::ranges::range_value_t<R>>
+      static Ragged from_rows(const R &rows);
+
+    // sizes
+    size_t size() const noexcept { return idx.size(); }
+    bool empty() const noexcept { return idx.empty(); }
+    size_t nvalues() const noexcept { return data.size(); }
+    size_t row_size(size_t i) const noexcept { return idx.row_size(i); }
+    const RaggedIndex& index() const noexcept { return idx; }
+
+    // access to the rows, no allocations
+    std::span<E> operator[](size_t i) noexcept { return {data.data() + idx.first(i), idx.row_size(i)}; }
+    std::span<const E> operator[](size_t i) const noexcept { return {data.data() + idx.first(i), idx.row_size(i)}; }
+    auto rows() noexcept
+      { return std::views::iota(size_t(0), size()) | std::views::transform([this](size_t i) { return (*this)[i]; }); }
+    auto rows() const noexcept
+      { return std::views::iota(size_t(0), size()) | std::views::transform([this](size_t i) { return (*this)[i]; }); }
+
+    // all values in the row order
+    std::span<E> values() noexcept { return data; }
+    std::span<const E> values() const noexcept { return data; }
+
+    // appends a row, amortized O(row size)
+    template<std::ranges::input_range R> void push_back(const R &row);
+    void clear() noexcept { idx.clear(); data.clear(); }
+    void reserve(size_t nrows, size_t nvals) { idx.reserve(nrows); data.reserve(nvals); }
+
+    friend bool operator==(const Ragged &, const Ragged &) = default;
+  }; // class Ragged<E>
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::random_access_range R> requires std::integral<std::ranges::range_value_t<R>>
+  Math::RaggedIndex::RaggedIndex(const R &counts)
+    : start(static_cast<size_t>(std::ranges::distance(counts)) + 1, 0)
+{
+  const size_t n = size();
+  auto it = std::ranges::begin(counts);
+
+  // sums of the chunks, their serial scan, then the scans of the chunks from their offsets
+  auto part = Parallel::partition(n, 1 << 14);
+  std::vector<size_t> sums(part.nchunks + 1, 0);
+  Parallel::run(part, [&](size_t ch, size_t first, size_t last)
+  {
+    size_t s = 0;
+    for (size_t i = first; i < last; ++i)
+      s += static_cast<size_t>(it[i]);
+    sums[ch + 1] = s;
+  });
+  for (size_t ch = 0; ch < part.nchunks; ++ch)
+    sums[ch + 1] += sums[ch];
+  Parallel::run(part, [&](size_t ch, size_t first, size_t last)
+  {
+    size_t s = sums[ch];
+    for (size_t i = first; i < last; ++i)
+      start[i + 1] = s += static_cast<size_t>(it[i]);
+  });
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<class E>
+template<std::ranges::random_access_range R> requires std::ranges::sized_range<std::ranges::range_value_t<R>>
+  auto Math::Ragged<E>::from_rows(const R &rows) -> Ragged
+{
+  auto it = std::ranges::begin(rows);
+  auto sizes = std::views::iota(size_t(0), static_cast<size_t>(std::ranges::distance(rows)))
+    | std::views::transform([&it](size_t i) { return static_cast<size_t>(std::ranges::size(it[i])); });
+  Ragged r{RaggedIndex(sizes)};
+  Parallel::for_each(r.size(), 1 << 10, [&](size_t i)
+  {
+    std::ranges::copy(it[i], r[i].begin());
+  });
+  return r;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<class E>
+template<std::ranges::input_range R>
+  void Math::Ragged<E>::push_back(const R &row)
+{
+  const size_t n = data.size();
+  std::ranges::copy(row, std::back_inserter(data));
+  idx.push_back(data.size() - n);
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::Ragged
+  \brief Compressed ragged array: rows of different lengths in one contiguous buffer.
+  \tparam E Type of the values, e.g. Vector3D for the vertices of polygons.
+
+  The values of all rows are stored one after another in the row order, the offsets of the
+  rows (Math::RaggedIndex) are the row pointers of the compressed sparse row format. Thus
+  there are two allocations instead of one per row of std::vector<std::vector<E>>, and
+  the geometry kernels walk the memory linearly. Rows are std::span's, access and iteration
+  allocate nothing:
+  \code
+  Math::Ragged<Vector3D> cells(counts);        // rows of counts[i] vertices, built in parallel
+  Parallel::for_each(cells.size(), 1024, [&](size_t i) { fill(cells[i]); });
+  for (auto polygon : cells.rows())
+    centroid(polygon);                          // std::span<Vector3D>
+  \endcode
+  For the structure-of-arrays payload, the same RaggedIndex addresses a Math::VectorField
+  of index.nvalues() vectors, row i being [index.first(i), index.last(i)).
+*/
+
+/*!
+  \class Math::RaggedIndex
+  \brief Offsets of the rows of a ragged array, shared by payloads of different types.
+*/
+
+#endif // MATH_RAGGED_H_INCLUDED
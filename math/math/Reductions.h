@@ -0,0 +1,333 @@
+#ifndef MATH_REDUCTIONS_H_INCLUDED
+#define MATH_REDUCTIONS_H_INCLUDED
+
+/*!
+  \file Reductions.h
+  \author gennadiy
+  \brief Single-pass parallel reductions over ranges of vectors, definition, documentation and tests.
+*/
+
+#include "Vector.h"
+#include "common/Parallel.h"
+#include <cstdint>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace Math
+{
+  // sum, bounding box and magnitudes of a set of vectors
+  template<size_t N, Type T = double> struct Aggregate
+  {
+    // integers are summed (and squared) in 64 bits, e.g. the squares of int components overflow early
+    using sum_type = std::conditional_t<std::integral<T>,
+                                        std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>, T>;
+
+    size_t count = 0;
+    Vector<N, sum_type> sum; // sum of the vectors
+    Vector<N, T> lo, hi;     // bounding box, i.e. componentwise min and max
+    sum_type sqs = {};       // sum of the squared magnitudes
+    sum_type max_sqs = {};   // max squared magnitude
+
+    constexpr auto max_fabs() const noexcept { return details::sqrt(max_sqs); }
+    constexpr Vector<N, T> centroid() const noexcept
+      { return Vector<N, T>(sum / static_cast<sum_type>(count)); }
+
+    // merge with aggregate of another set of vectors
+    constexpr Aggregate& operator+=(const Aggregate &a) noexcept;
+  }; // struct Aggregate<N, T>
+
+  // all fields of Aggregate in a single pass over a range of euclidian vectors
+  template<std::ranges::random_access_range R>
+    constexpr auto aggregate(R &&r) noexcept;
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+  template<class> struct aggregate_of;
+  template<size_t N, Type T, class L> struct aggregate_of<Vector<N, T, true, L>>
+  {
+    using type = Aggregate<N, T>;
+    using value_type = T;
+  };
+
+  // generic loop, used in compile-time and for non-contiguous ranges
+  template<std::random_access_iterator It>
+    constexpr auto aggregate_serial(It first, size_t n) noexcept
+  {
+    using V = std::iter_value_t<It>;
+    using A = typename aggregate_of<V>::type;
+    A a;
+    if (n == 0)
+      return a;
+
+    a.count = n;
+    a.lo = a.hi = decltype(a.lo)(first[0]);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const V &v = first[i];
+      const auto w = decltype(a.sum)(v);
+      a.sum += w;
+      for (size_t k = 0; k < V::ncomps; ++k)
+      {
+        a.lo[k] = (v[k] < a.lo[k])? v[k] : a.lo[k];
+        a.hi[k] = (a.hi[k] < v[k])? v[k] : a.hi[k];
+      }
+      auto q = w * w;
+      a.sqs += q;
+      a.max_sqs = (a.max_sqs < q)? q : a.max_sqs;
+    }
+    return a;
+  }
+
+  // vectors of arithmetic types are processed as a flat array of lanes W at once,
+  // i.e. K vectors of M lanes fill a whole number of packed registers
+  template<class T, size_t M> struct aggregate_step
+  {
+    static constexpr size_t width = []
+    {
+      if constexpr (simd::packed<T>::enabled)
+        return simd::packed<T>::width;
+      else
+        return size_t(4);
+    }();
+    static constexpr size_t W = std::lcm(M, width);
+    static constexpr size_t K = W / M;
+  };
+
+#if defined(MATH_SIMD_SSE2)
+  // main loop with packed registers, returns the number of processed vectors
+  template<size_t N, size_t M, class T, size_t W = aggregate_step<T, M>::W, size_t K = W / M>
+    size_t aggregate_packed(const T *p, size_t n, T (&s)[W], T (&q)[W],
+                            T (&lo)[W], T (&hi)[W], T (&mx)[K]) noexcept
+  {
+    using P = simd::packed<T>;
+    constexpr size_t R = W / P::width; // registers per step
+    typename P::reg rs[R], rq[R], rlo[R], rhi[R];
+    for (size_t r = 0; r < R; ++r)
+    {
+      rs[r] = P::load(s + r*P::width);
+      rq[r] = P::load(q + r*P::width);
+      rlo[r] = P::load(lo + r*P::width);
+      rhi[r] = P::load(hi + r*P::width);
+    }
+
+    size_t i = 0;
+    T sq[W];
+    for (; i + K <= n; i += K)
+    {
+      const T *b = p + i*M;
+      for (size_t r = 0; r < R; ++r)
+      {
+        auto x = P::load(b + r*P::width);
+        auto x2 = P::mul(x, x);
+        rs[r] = P::add(rs[r], x);
+        rq[r] = P::add(rq[r], x2);
+        rlo[r] = P::min(x, rlo[r]);
+        rhi[r] = P::max(x, rhi[r]);
+        P::store(sq + r*P::width, x2);
+      }
+      // magnitudes need horizontal sums, they are done in scalar lanes
+      for (size_t k = 0; k < K; ++k)
+      {
+        T m = sq[k*M];
+        for (size_t c = 1; c < N; ++c)
+          m += sq[k*M + c];
+        mx[k] = (mx[k] < m)? m : mx[k];
+      }
+    }
+
+    for (size_t r = 0; r < R; ++r)
+    {
+      P::store(s + r*P::width, rs[r]);
+      P::store(q + r*P::width, rq[r]);
+      P::store(lo + r*P::width, rlo[r]);
+      P::store(hi + r*P::width, rhi[r]);
+    }
+    return i;
+  }
+#endif
+
+  template<size_t N, size_t M, class T>
+    Aggregate<N, T> aggregate_lanes(const T *p, size_t n) noexcept
+  {
+    constexpr size_t W = aggregate_step<T, M>::W;
+    constexpr size_t K = aggregate_step<T, M>::K;
+    using S = typename Aggregate<N, T>::sum_type;
+    Aggregate<N, T> a;
+    if (n == 0)
+      return a;
+
+    // packed registers are used for floating point types only, thus S is T there
+    S s[W] = {}, q[W] = {}, mx[K] = {};
+    T lo[W], hi[W];
+    for (size_t j = 0; j < W; ++j)
+      lo[j] = hi[j] = p[j % M];
+
+    size_t i = 0;
+#if defined(MATH_SIMD_SSE2)
+    if constexpr (simd::packed<T>::enabled)
+      i = aggregate_packed<N, M>(p, n, s, q, lo, hi, mx);
+#endif
+    // the rest (or everything w/o packed registers) vector by vector
+    for (; i < n; ++i)
+    {
+      const T *b = p + i*M;
+      S m = S();
+      for (size_t c = 0; c < M; ++c)
+      {
+        const S x = b[c];
+        s[c] += x;
+        q[c] += x * x;
+        lo[c] = (b[c] < lo[c])? b[c] : lo[c];
+        hi[c] = (hi[c] < b[c])? b[c] : hi[c];
+        m += x * x;
+      }
+      mx[0] = (mx[0] < m)? m : mx[0];
+    }
+
+    // horizontal reduction of the lanes, padding lanes (if any) are zero
+    a.count = n;
+    for (size_t c = 0; c < N; ++c)
+      a.lo[c] = a.hi[c] = p[c];
+    for (size_t k = 0; k < K; ++k)
+    {
+      for (size_t c = 0; c < N; ++c)
+      {
+        a.sum[c] += s[k*M + c];
+        a.lo[c] = (lo[k*M + c] < a.lo[c])? lo[k*M + c] : a.lo[c];
+        a.hi[c] = (a.hi[c] < hi[k*M + c])? hi[k*M + c] : a.hi[c];
+      }
+      for (size_t c = 0; c < M; ++c)
+        a.sqs += q[k*M + c];
+      a.max_sqs = (a.max_sqs < mx[k])? mx[k] : a.max_sqs;
+    }
+    return a;
+  }
+
+  // number of vectors processed by a thread at least
+  inline constexpr size_t aggregate_grain = 1 << 15;
+} // namespace Math::details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, Math::Type T>
+  constexpr auto Math::Aggregate<N, T>::operator+=(const Aggregate &a) noexcept -> Aggregate&
+{
+  if (a.count == 0)
+    return *this;
+  if (count == 0)
+    return *this = a;
+
+  count += a.count;
+  sum += a.sum;
+  for (size_t k = 0; k < N; ++k)
+  {
+    lo[k] = (a.lo[k] < lo[k])? a.lo[k] : lo[k];
+    hi[k] = (hi[k] < a.hi[k])? a.hi[k] : hi[k];
+  }
+  sqs += a.sqs;
+  max_sqs = (max_sqs < a.max_sqs)? a.max_sqs : max_sqs;
+  return *this;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::random_access_range R>
+  constexpr auto Math::aggregate(R &&r) noexcept
+{
+  using V = std::ranges::range_value_t<R>;
+  using A = typename details::impl::aggregate_of<V>::type;
+  using T = typename details::impl::aggregate_of<V>::value_type;
+  constexpr size_t M = V::nlanes;
+  auto n = static_cast<size_t>(std::ranges::distance(r));
+
+  if (!std::is_constant_evaluated())
+  {
+    auto merge = [](A a, const A &b) { a += b; return a; };
+    if constexpr (std::ranges::contiguous_range<R> && std::is_arithmetic_v<T>
+                  && std::is_standard_layout_v<V> && sizeof(V) == M * sizeof(T))
+    {
+      // vector is standard-layout, thus its address is the address of its storage
+      const T *p = reinterpret_cast<const T*>(std::ranges::data(r));
+      return Parallel::reduce(n, details::impl::aggregate_grain, A(),
+        [p](size_t first, size_t last)
+          { return details::impl::aggregate_lanes<V::ncomps, M>(p + first*M, last - first); },
+        merge);
+    }
+    else
+    {
+      auto it = std::ranges::begin(r);
+      return Parallel::reduce(n, details::impl::aggregate_grain, A(),
+        [it](size_t first, size_t last)
+          { return details::impl::aggregate_serial(it + first, last - first); },
+        merge);
+    }
+  }
+  return details::impl::aggregate_serial(std::ranges::begin(r), n);
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::Reductions::tests
+{
+  using V2i = Vector<2, int>;
+
+  constexpr V2i v[] = {V2i(1, -2), V2i(3, 4), V2i(-5, 0)};
+  constexpr auto a = aggregate(v);
+  static_assert(a.count == 3, "count failed");
+  static_assert(a.sum == Vector<2, int64_t>(-1, 2) && a.centroid() == V2i(0, 0), "sum failed");
+  static_assert(a.lo == V2i(-5, -2) && a.hi == V2i(3, 4), "bounding box failed");
+  static_assert(a.sqs == 55, "sum of squares failed");
+  static_assert(a.max_sqs == 25 && a.max_fabs() == 5, "max magnitude failed");
+
+  constexpr auto merged = [] { auto b = aggregate(std::span(v, 1)); b += aggregate(std::span(v + 1, 2)); return b; }();
+  static_assert(merged.sum == a.sum && merged.lo == a.lo && merged.hi == a.hi, "merge failed");
+  static_assert(merged.sqs == a.sqs && merged.max_sqs == a.max_sqs, "merge failed");
+
+  // squares of int components beyond 46340 don't fit int
+  constexpr V2i big[] = {V2i(50000, -50000), V2i(1, 1)};
+  static_assert(aggregate(big).max_sqs == 5000000000 && aggregate(big).sqs == 5000000002, "int64 sums failed");
+} // namespace Math::Reductions::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \struct Math::Aggregate
+  \brief Sum, bounding box, sum of squared magnitudes and max magnitude of a set of vectors.
+  \tparam N Number of components.
+  \tparam T Type of the components.
+
+  Typical uses are centroids, bounding boxes and CFL conditions (max |v|) of particles
+  or mesh nodes. Aggregates of two sets can be merged with +=, the bounding box
+  of an empty set (count == 0) is meaningless. Integral components are squared and summed
+  in 64 bits (Aggregate::sum_type), the results are exact while they fit it.
+*/
+
+/*!
+  \fn constexpr auto Math::aggregate(R &&r) noexcept
+  \brief Computes all fields of Math::Aggregate in a single pass over a range.
+  \param r Random access range of euclidian vectors of any layout.
+  \return Math::Aggregate<N, T> of the vectors.
+
+  In runtime the range is split into chunks processed by Parallel::concurrency() threads
+  (small ranges are processed by the calling thread only). If the range is contiguous
+  and the components are of arithmetic type, its storage is processed as a flat array
+  of lanes several vectors at once, so that the compiler vectorizes the loops.
+  Otherwise (and in compile-time) a generic serial loop with vector operations is used.
+
+  NB! Floating point sums depend on the number of threads since the partial sums
+  are added in a different order. Use Parallel::set_concurrency(1) for bitwise
+  reproducible results, or Math::compensated_sum for accurate ones.
+*/
+
+#endif // MATH_REDUCTIONS_H_INCLUDED
@@ -0,0 +1,429 @@
+#ifndef MATH_SPACE_CURVES_H_INCLUDED
+#define MATH_SPACE_CURVES_H_INCLUDED
+
+/*!
+  \file SpaceCurves.h
+  \author gennadiy
+  \brief Morton and Hilbert keys of 2D/3D points and spatial ordering, definition, documentation and tests.
+*/
+
+#include "Reductions.h"
+#include "common/Parallel.h"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Math
+{
+  // number of bits per coordinate in 64-bit keys
+  template<size_t N> requires(N == 2 || N == 3)
+    inline constexpr unsigned curve_bits = 64 / N;
+
+  // maps points of a box onto the integer grid of the keys, the same scale for all axes
+  template<size_t N, std::floating_point T> class Quantizer
+  {
+    Vector<N, T> lo;
+    T scale = T();
+
+  public:
+    static constexpr uint32_t max = (1ull << curve_bits<N>) - 1;
+
+    constexpr Quantizer(const Vector<N, T> &lo, const Vector<N, T> &hi) noexcept;
+    constexpr explicit Quantizer(const Aggregate<N, T> &a) noexcept : Quantizer(a.lo, a.hi) {}
+
+    constexpr Vector<N, uint32_t> operator()(const Vector<N, T> &v) const noexcept;
+  }; // class Quantizer<N, T>
+
+  // keys of the points of the integer grid [0, 2^curve_bits<N>)^N
+  template<size_t N> constexpr uint64_t morton_key(const Vector<N, uint32_t> &g) noexcept;
+  template<size_t N> constexpr uint64_t hilbert_key(const Vector<N, uint32_t> &g) noexcept;
+
+  // keys of integer points, coordinates are biased by 2^(curve_bits<N> - 1)
+  template<size_t N> constexpr uint64_t morton_key(const Vector<N, int> &v) noexcept;
+  template<size_t N> constexpr uint64_t hilbert_key(const Vector<N, int> &v) noexcept;
+
+  // keys of real points quantized to a box
+  template<size_t N, std::floating_point T>
+    constexpr uint64_t morton_key(const Vector<N, T> &v, const Quantizer<N, T> &q) noexcept;
+  template<size_t N, std::floating_point T>
+    constexpr uint64_t hilbert_key(const Vector<N, T> &v, const Quantizer<N, T> &q) noexcept;
+
+  // stable parallel radix sort, returns permutation p such that keys[p[i]] <= keys[p[i + 1]]
+  inline std::vector<size_t> sort_permutation(std::span<const uint64_t> keys);
+
+  // permutation of the points along the curve within their bounding box
+  template<std::ranges::random_access_range R> std::vector<size_t> morton_order(const R &points);
+  template<std::ranges::random_access_range R> std::vector<size_t> hilbert_order(const R &points);
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+  // mask of the bits of the first coordinate in a Morton key
+  template<size_t N> inline constexpr uint64_t morton_mask =
+    (N == 2)? 0x5555555555555555ull : 0x1249249249249249ull;
+
+  // spreads the lower bits of x over the Morton key, N - 1 zero bits between them
+  template<size_t N> constexpr uint64_t spread(uint64_t x) noexcept
+  {
+#if defined(__BMI2__)
+    if (!std::is_constant_evaluated())
+      return _pdep_u64(x, morton_mask<N>);
+#endif
+    if constexpr (N == 2)
+    {
+      x &= 0xffffffffull;
+      x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+      x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+      x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+      x = (x | (x << 2)) & 0x3333333333333333ull;
+      x = (x | (x << 1)) & 0x5555555555555555ull;
+    }
+    else
+    {
+      x &= 0x1fffffull;
+      x = (x | (x << 32)) & 0x001f00000000ffffull;
+      x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+      x = (x | (x << 8)) & 0x100f00f00f00f00full;
+      x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+      x = (x | (x << 2)) & 0x1249249249249249ull;
+    }
+    return x;
+  }
+
+  // interleaves the bits, g[0] goes to the least significant position
+  template<size_t N> constexpr uint64_t interleave(const std::array<uint64_t, N> &g) noexcept
+  {
+    uint64_t key = 0;
+    for (size_t i = 0; i < N; ++i)
+      key |= spread<N>(g[i]) << i;
+    return key;
+  }
+
+  // Skilling's transform of the coordinates into the "transposed" Hilbert index,
+  // see J. Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707 (2004)
+  template<size_t N> constexpr uint64_t hilbert(std::array<uint64_t, N> x) noexcept
+  {
+    constexpr uint64_t m = 1ull << (curve_bits<N> - 1);
+    for (uint64_t q = m; q > 1; q >>= 1)
+    {
+      uint64_t p = q - 1;
+      for (size_t i = 0; i < N; ++i)
+      {
+        // invert low bits of x[0] if bit q of x[i] is set, otherwise exchange them;
+        // the bits are random, so it's done without branches
+        uint64_t set = uint64_t(0) - ((x[i] & q) != 0);
+        uint64_t t = (x[0] ^ x[i]) & p & ~set;
+        x[0] ^= (p & set) | t;
+        x[i] ^= t;
+      }
+    }
+
+    // Gray encoding
+    for (size_t i = 1; i < N; ++i)
+      x[i] ^= x[i - 1];
+    uint64_t t = 0;
+    for (uint64_t q = m; q > 1; q >>= 1)
+      t ^= (q - 1) & (uint64_t(0) - ((x[N - 1] & q) != 0));
+    for (size_t i = 0; i < N; ++i)
+      x[i] ^= t;
+
+    // x[0] holds the most significant bit of each group
+    std::array<uint64_t, N> r;
+    for (size_t i = 0; i < N; ++i)
+      r[i] = x[N - 1 - i];
+    return interleave<N>(r);
+  }
+
+  template<size_t N> constexpr std::array<uint64_t, N> grid(const Vector<N, uint32_t> &g) noexcept
+  {
+    std::array<uint64_t, N> r;
+    for (size_t i = 0; i < N; ++i)
+      r[i] = g[i];
+    return r;
+  }
+
+  template<size_t N> constexpr Vector<N, uint32_t> biased(const Vector<N, int> &v) noexcept
+  {
+    constexpr int64_t bias = int64_t(1) << (curve_bits<N> - 1);
+    Vector<N, uint32_t> g;
+    for (size_t i = 0; i < N; ++i)
+    {
+      assert(v[i] >= -bias && v[i] < bias);
+      g[i] = static_cast<uint32_t>(v[i] + bias);
+    }
+    return g;
+  }
+
+  // keys of all points in parallel and their order
+  template<class R, class Key> std::vector<size_t> curve_order(const R &points, Key key)
+  {
+    using V = std::ranges::range_value_t<R>;
+    using T = std::remove_cvref_t<decltype(V()[0])>;
+    constexpr size_t N = V::ncomps;
+
+    auto n = static_cast<size_t>(std::ranges::distance(points));
+    auto first = std::ranges::begin(points);
+    std::vector<uint64_t> keys(n);
+    if constexpr (std::floating_point<T>)
+    {
+      Quantizer<N, T> q(aggregate(points));
+      Parallel::for_each(n, 1 << 14, [&](size_t i) { keys[i] = key(Vector<N, T>(first[i]), q); });
+    }
+    else
+      Parallel::for_each(n, 1 << 14, [&](size_t i) { keys[i] = key(Vector<N, int>(first[i])); });
+    return sort_permutation(keys);
+  }
+} // namespace Math::details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  constexpr Math::Quantizer<N, T>::Quantizer(const Vector<N, T> &lo, const Vector<N, T> &hi) noexcept
+    : lo(lo)
+{
+  T extent = T();
+  for (size_t i = 0; i < N; ++i)
+    extent = (extent < hi[i] - lo[i])? hi[i] - lo[i] : extent;
+  scale = (extent > T())? static_cast<T>(max) / extent : T();
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  constexpr Math::Vector<N, uint32_t> Math::Quantizer<N, T>::operator()(const Vector<N, T> &v) const noexcept
+{
+  Vector<N, uint32_t> g;
+  for (size_t i = 0; i < N; ++i)
+  {
+    T x = (v[i] - lo[i]) * scale; // points outside the box are clamped
+    g[i] = (x > T())? ((x < static_cast<T>(max))? static_cast<uint32_t>(x) : max) : 0;
+  }
+  return g;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N>
+  constexpr uint64_t Math::morton_key(const Vector<N, uint32_t> &g) noexcept
+{
+  return details::impl::interleave<N>(details::impl::grid(g));
+}
+
+template<size_t N>
+  constexpr uint64_t Math::hilbert_key(const Vector<N, uint32_t> &g) noexcept
+{
+  return details::impl::hilbert<N>(details::impl::grid(g));
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N>
+  constexpr uint64_t Math::morton_key(const Vector<N, int> &v) noexcept
+{
+  return morton_key(details::impl::biased(v));
+}
+
+template<size_t N>
+  constexpr uint64_t Math::hilbert_key(const Vector<N, int> &v) noexcept
+{
+  return hilbert_key(details::impl::biased(v));
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  constexpr uint64_t Math::morton_key(const Vector<N, T> &v, const Quantizer<N, T> &q) noexcept
+{
+  return morton_key(q(v));
+}
+
+template<size_t N, std::floating_point T>
+  constexpr uint64_t Math::hilbert_key(const Vector<N, T> &v, const Quantizer<N, T> &q) noexcept
+{
+  return hilbert_key(q(v));
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+inline std::vector<size_t> Math::sort_permutation(std::span<const uint64_t> keys)
+{
+  constexpr unsigned digit_bits = 11;
+  constexpr size_t radix = size_t(1) << digit_bits;
+
+  // keys travel with their indices, so that scattering writes a single stream per digit
+  struct item
+  {
+    uint64_t key;
+    size_t index;
+  };
+
+  const size_t n = keys.size();
+  std::vector<item> a(n), b(n);
+  for (size_t i = 0; i < n; ++i)
+    a[i] = {keys[i], i};
+
+  // the same partition for histograms and scattering keeps the sort stable
+  auto part = Parallel::partition(n, 1 << 16);
+  std::vector<std::array<size_t, radix>> offsets(part.nchunks);
+  for (unsigned shift = 0; shift < 64; shift += digit_bits)
+  {
+    Parallel::run(part, [&](size_t c, size_t first, size_t last)
+    {
+      auto &h = offsets[c];
+      h.fill(0);
+      for (size_t i = first; i < last; ++i)
+        ++h[(a[i].key >> shift) & (radix - 1)];
+    });
+
+    // exclusive prefix sums ordered by digit then by chunk,
+    // the pass is skipped if all the keys have the same digit
+    bool trivial = false;
+    for (size_t d = 0, total = 0; d < radix; ++d)
+    {
+      size_t count = 0;
+      for (auto &h : offsets)
+      {
+        count += h[d];
+        total += std::exchange(h[d], total);
+      }
+      trivial = trivial || (count == n);
+    }
+    if (trivial)
+      continue;
+
+    Parallel::run(part, [&](size_t c, size_t first, size_t last)
+    {
+      auto &o = offsets[c];
+      for (size_t i = first; i < last; ++i)
+        b[o[(a[i].key >> shift) & (radix - 1)]++] = a[i];
+    });
+    a.swap(b);
+  }
+
+  std::vector<size_t> p(n);
+  for (size_t i = 0; i < n; ++i)
+    p[i] = a[i].index;
+  return p;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::random_access_range R>
+  std::vector<size_t> Math::morton_order(const R &points)
+{
+  return details::impl::curve_order(points, [](const auto &... args) { return morton_key(args...); });
+}
+
+template<std::ranges::random_access_range R>
+  std::vector<size_t> Math::hilbert_order(const R &points)
+{
+  return details::impl::curve_order(points, [](const auto &... args) { return hilbert_key(args...); });
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::SpaceCurves::tests
+{
+  using G2 = Vector<2, uint32_t>;
+  using G3 = Vector<3, uint32_t>;
+
+  // Morton
+  static_assert(morton_key(G2(1, 0)) == 1 && morton_key(G2(0, 1)) == 2, "2D morton failed");
+  static_assert(morton_key(G2(3, 3)) == 15, "2D morton failed");
+  static_assert(morton_key(G2(0xffffffff, 0xffffffff)) == ~0ull, "2D morton failed");
+  static_assert(morton_key(G3(1, 0, 0)) == 1 && morton_key(G3(0, 0, 1)) == 4, "3D morton failed");
+  static_assert(morton_key(G3(0x1fffff, 0x1fffff, 0x1fffff)) == (~0ull >> 1), "3D morton failed");
+
+  // integer points keep the order
+  static_assert(morton_key(Vector<2, int>(-1, -1)) < morton_key(Vector<2, int>(0, 0)), "bias failed");
+  static_assert(morton_key(Vector<3, int>(-5, -5, -5)) < morton_key(Vector<3, int>(5, 5, 5)), "bias failed");
+
+  // Hilbert: the first cells of 2x2 grid go around the square, the ones of 2x2x2 grid
+  // around the cube, by steps to the adjacent cells
+  static_assert(hilbert_key(G2(0, 0)) == 0 && hilbert_key(G2(1, 0)) == 1 &&
+                hilbert_key(G2(1, 1)) == 2 && hilbert_key(G2(0, 1)) == 3, "2D hilbert failed");
+  static_assert(hilbert_key(G3(0, 0, 0)) == 0 && hilbert_key(G3(1, 0, 0)) == 1 &&
+                hilbert_key(G3(1, 0, 1)) == 2 && hilbert_key(G3(0, 0, 1)) == 3 &&
+                hilbert_key(G3(0, 1, 1)) == 4 && hilbert_key(G3(1, 1, 1)) == 5 &&
+                hilbert_key(G3(1, 1, 0)) == 6 && hilbert_key(G3(0, 1, 0)) == 7, "3D hilbert failed");
+
+  // quantization
+  constexpr Quantizer<2, double> q(Vector2D(-1, -1), Vector2D(1, 0));
+  static_assert(q(Vector2D(-1, -1)) == G2(0, 0), "quantization failed");
+  static_assert(q(Vector2D(1, 1)) == G2(q.max, q.max), "quantization failed");
+  static_assert(q(Vector2D(-2, 0)) == G2(0, q.max / 2), "quantization failed");
+} // namespace Math::SpaceCurves::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::Quantizer
+  \brief Maps points of a bounding box onto the integer grid of the space-filling curves.
+  \tparam N Number of dimensions, 2 or 3.
+  \tparam T Floating point type of the coordinates.
+
+  All axes use the same scale (the largest extent of the box), so that the grid cells
+  are squares or cubes and the curve keeps its locality along all axes. Points
+  outside the box are clamped to its boundary.
+*/
+
+/*!
+  \fn constexpr uint64_t Math::morton_key(const Vector<N, uint32_t> &g) noexcept
+  \brief Morton (Z-order) key of a point of the integer grid.
+  \param g Grid coordinates, only lower Math::curve_bits<N> (32 for 2D and 21 for 3D) bits are used.
+  \return Key with the bits of the coordinates interleaved, x in the least significant position.
+
+  With BMI2 (e.g. NUMKIT_NATIVE_ARCH=ON on Haswell and newer) the bits are deposited
+  by a single pdep instruction per coordinate, otherwise by the magic-number shifts.
+*/
+
+/*!
+  \fn constexpr uint64_t Math::hilbert_key(const Vector<N, uint32_t> &g) noexcept
+  \brief Hilbert key of a point of the integer grid.
+  \param g Grid coordinates, only lower Math::curve_bits<N> bits are used.
+  \return Index along the Hilbert curve which fills the whole grid.
+
+  Unlike Morton order, consecutive keys are always neighbour cells, so that
+  ordering by Hilbert keys gives better locality at a slightly higher cost of encoding.
+*/
+
+/*!
+  \fn inline std::vector<size_t> Math::sort_permutation(std::span<const uint64_t> keys)
+  \brief Stable LSD radix sort of 64-bit keys (11 bits per pass).
+  \param keys Keys to be sorted, they are not modified.
+  \return Permutation p such that keys[p[0]] <= keys[p[1]] <= ... and equal keys keep their order.
+
+  Histograms and scattering of each pass run in parallel over Parallel::concurrency() chunks,
+  passes where all keys have the same digit (e.g. high bits of 3D keys or keys of a small box)
+  are skipped.
+*/
+
+/*!
+  \fn std::vector<size_t> Math::hilbert_order(const R &points)
+  \brief Spatial order of the points for better cache locality.
+  \param points Range of 2D/3D vectors with floating point or int components.
+  \return Permutation p of the points, i.e. points[p[0]], points[p[1]], ... follow the curve.
+
+  Real points are quantized to their bounding box (see Math::aggregate), integer points
+  are used as is. Typical use is to renumber nodes or cells of a mesh, or particles:
+  \code
+  auto p = hilbert_order(nodes);
+  std::vector<Vector3D> sorted(nodes.size());
+  for (size_t i = 0; i < p.size(); ++i)
+    sorted[i] = nodes[p[i]];
+  \endcode
+*/
+
+#endif // MATH_SPACE_CURVES_H_INCLUDED
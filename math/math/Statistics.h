@@ -0,0 +1,294 @@
+#ifndef MATH_STATISTICS_H_INCLUDED
+#define MATH_STATISTICS_H_INCLUDED
+
+/*!
+  \file Statistics.h
+  \author gennadiy
+  \brief Streaming mergeable statistics of vectors and tensors, definition, documentation and tests.
+*/
+
+#include "Tensor.h"
+#include "common/Parallel.h"
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace Math
+{
+  // running statistics of samples of type V
+  template<class V> class Statistics;
+
+  // mean and covariance of vectors
+  template<size_t N, std::floating_point T, class L> class Statistics<Vector<N, T, true, L>>
+  {
+  public:
+    using sample_type = Vector<N, T, true, L>;
+
+  private:
+    size_t n = 0;
+    sample_type m;  // mean
+    Tensor<N, T> s; // sum of (x - mean) ^ (x - mean)
+
+  public:
+    constexpr Statistics() noexcept = default;
+
+    // accumulation of a sample (Welford) and merge with statistics of another set of samples (Chan)
+    constexpr Statistics& operator+=(const sample_type &x) noexcept;
+    constexpr Statistics& operator+=(const Statistics &a) noexcept { return merge(a); }
+    constexpr Statistics& merge(const Statistics &a) noexcept;
+    // accumulation of count samples at once, by two passes over them
+    template<std::random_access_iterator It> constexpr Statistics& add(It first, size_t count) noexcept;
+
+    // results, the variances of an empty set are meaningless, the sample ones need 2 samples at least
+    constexpr size_t count() const noexcept { return n; }
+    constexpr const sample_type& mean() const noexcept { return m; }
+    constexpr Tensor<N, T> covariance() const noexcept { return s / static_cast<T>(n); }
+    constexpr Tensor<N, T> sample_covariance() const noexcept { return s / static_cast<T>(n - 1); }
+    constexpr sample_type variance() const noexcept;
+  }; // class Statistics<Vector<N, T, true, L>>
+
+  // mean and variance of tensors, componentwise
+  template<size_t N, std::floating_point T> class Statistics<Tensor<N, T>>
+  {
+  public:
+    using sample_type = Tensor<N, T>;
+
+  private:
+    size_t n = 0;
+    sample_type m; // mean
+    sample_type s; // sum of (x - mean)^2 of the components
+
+  public:
+    constexpr Statistics() noexcept = default;
+
+    // accumulation of a sample (Welford) and merge with statistics of another set of samples (Chan)
+    constexpr Statistics& operator+=(const sample_type &x) noexcept;
+    constexpr Statistics& operator+=(const Statistics &a) noexcept { return merge(a); }
+    constexpr Statistics& merge(const Statistics &a) noexcept;
+    // accumulation of count samples at once, by two passes over them
+    template<std::random_access_iterator It> constexpr Statistics& add(It first, size_t count) noexcept;
+
+    // results, the variances of an empty set are meaningless, the sample ones need 2 samples at least
+    constexpr size_t count() const noexcept { return n; }
+    constexpr const sample_type& mean() const noexcept { return m; }
+    constexpr sample_type variance() const noexcept { return s / static_cast<T>(n); }
+    constexpr sample_type sample_variance() const noexcept { return s / static_cast<T>(n - 1); }
+  }; // class Statistics<Tensor<N, T>>
+
+  // statistics of a range of vectors or tensors, the chunks are accumulated in parallel and merged
+  template<std::ranges::random_access_range R>
+    constexpr auto statistics(R &&r) noexcept;
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+// NB! the covariance is updated by (n - 1)/n d ^ d, d = x - old mean, rather than d ^ (x - new mean),
+// its upper triangle is computed and mirrored to keep it symmetric exactly
+
+template<size_t N, std::floating_point T, class L>
+  constexpr auto Math::Statistics<Math::Vector<N, T, true, L>>::operator+=(const sample_type &x) noexcept
+    -> Statistics&
+{
+  ++n;
+  const T r = T(1) / static_cast<T>(n), c = static_cast<T>(n - 1) * r;
+  const sample_type d = x - m;
+  m += d * r;
+  for (size_t i = 0; i < N; ++i)
+    for (size_t j = i; j < N; ++j)
+      s[j][i] = s[i][j] += c * d[i] * d[j];
+  return *this;
+}
+
+template<size_t N, std::floating_point T, class L>
+  constexpr auto Math::Statistics<Math::Vector<N, T, true, L>>::merge(const Statistics &a) noexcept
+    -> Statistics&
+{
+  if (a.n == 0)
+    return *this;
+  if (n == 0)
+    return *this = a;
+
+  const T na = static_cast<T>(n), nb = static_cast<T>(a.n), r = T(1) / (na + nb);
+  const sample_type d = a.m - m;
+  n += a.n;
+  m += d * (nb * r);
+  const T c = na * nb * r;
+  for (size_t i = 0; i < N; ++i)
+    for (size_t j = i; j < N; ++j)
+      s[j][i] = s[i][j] += a.s[i][j] + c * d[i] * d[j];
+  return *this;
+}
+
+template<size_t N, std::floating_point T, class L>
+  constexpr auto Math::Statistics<Math::Vector<N, T, true, L>>::variance() const noexcept -> sample_type
+{
+  sample_type v;
+  for (size_t i = 0; i < N; ++i)
+    v[i] = s[i][i] / static_cast<T>(n);
+  return v;
+}
+
+template<size_t N, std::floating_point T, class L>
+template<std::random_access_iterator It>
+  constexpr auto Math::Statistics<Math::Vector<N, T, true, L>>::add(It first, size_t count) noexcept
+    -> Statistics&
+{
+  if (count == 0)
+    return *this;
+
+  Statistics b;
+  b.n = count;
+  for (size_t k = 0; k < count; ++k)
+    b.m += first[k];
+  b.m *= T(1) / static_cast<T>(count);
+  for (size_t k = 0; k < count; ++k)
+  {
+    const sample_type d = first[k] - b.m;
+    b.s += d ^ d; // symmetric, as d[i] * d[j] == d[j] * d[i]
+  }
+  return merge(b);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<size_t N, std::floating_point T>
+  constexpr auto Math::Statistics<Math::Tensor<N, T>>::operator+=(const sample_type &x) noexcept
+    -> Statistics&
+{
+  ++n;
+  const T r = T(1) / static_cast<T>(n), c = static_cast<T>(n - 1) * r;
+  for (size_t i = 0; i < N; ++i)
+    for (size_t j = 0; j < N; ++j)
+    {
+      const T d = x[i][j] - m[i][j];
+      m[i][j] += d * r;
+      s[i][j] += c * d * d;
+    }
+  return *this;
+}
+
+template<size_t N, std::floating_point T>
+  constexpr auto Math::Statistics<Math::Tensor<N, T>>::merge(const Statistics &a) noexcept
+    -> Statistics&
+{
+  if (a.n == 0)
+    return *this;
+  if (n == 0)
+    return *this = a;
+
+  const T na = static_cast<T>(n), nb = static_cast<T>(a.n), r = T(1) / (na + nb);
+  const T w = nb * r, c = na * nb * r;
+  n += a.n;
+  for (size_t i = 0; i < N; ++i)
+    for (size_t j = 0; j < N; ++j)
+    {
+      const T d = a.m[i][j] - m[i][j];
+      m[i][j] += d * w;
+      s[i][j] += a.s[i][j] + c * d * d;
+    }
+  return *this;
+}
+
+template<size_t N, std::floating_point T>
+template<std::random_access_iterator It>
+  constexpr auto Math::Statistics<Math::Tensor<N, T>>::add(It first, size_t count) noexcept
+    -> Statistics&
+{
+  if (count == 0)
+    return *this;
+
+  Statistics b;
+  b.n = count;
+  for (size_t k = 0; k < count; ++k)
+    b.m += first[k];
+  b.m *= T(1) / static_cast<T>(count);
+  for (size_t k = 0; k < count; ++k)
+  {
+    const sample_type &x = first[k];
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        b.s[i][j] += (x[i][j] - b.m[i][j]) * (x[i][j] - b.m[i][j]);
+  }
+  return merge(b);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+  // number of samples accumulated by a thread at least and by two passes at once (in L1)
+  inline constexpr size_t statistics_grain = 1 << 14;
+  inline constexpr size_t statistics_block = 256;
+} // namespace Math::details::impl
+
+template<std::ranges::random_access_range R>
+  constexpr auto Math::statistics(R &&r) noexcept
+{
+  using S = Statistics<std::ranges::range_value_t<R>>;
+  const auto n = static_cast<size_t>(std::ranges::distance(r));
+  auto accumulate = [it = std::ranges::begin(r)](size_t first, size_t last)
+  {
+    S a;
+    for (size_t i = first; i < last; i += details::impl::statistics_block)
+      a.add(it + i, std::min(details::impl::statistics_block, last - i));
+    return a;
+  };
+
+  if (!std::is_constant_evaluated())
+    return Parallel::reduce(n, details::impl::statistics_grain, S(), accumulate,
+      [](S a, const S &b) { a += b; return a; });
+  return accumulate(0, n);
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::Accumulators::tests
+{
+  constexpr Vector2D v[] = {Vector2D(1, 2), Vector2D(3, 6), Vector2D(5, 4), Vector2D(3, 0)};
+  constexpr auto a = statistics(v);
+  static_assert(a.count() == 4 && a.mean() == Vector2D(3, 3), "mean failed");
+  static_assert(a.covariance() == Tensor2D(2, 1, 1, 5), "covariance failed");
+  static_assert(a.variance() == Vector2D(2, 5), "variance failed");
+  static_assert(a.sample_covariance() * 3. == a.covariance() * 4., "sample covariance failed");
+
+  constexpr auto merged = [] { auto b = statistics(std::span(v, 2)); b += statistics(std::span(v + 2, 2)); return b; }();
+  static_assert(merged.mean() == a.mean() && merged.covariance() == a.covariance(), "merge failed");
+
+  constexpr Tensor2D t[] = {Tensor2D(1, 0, 2, 4), Tensor2D(3, 0, -2, 4)};
+  constexpr auto b = statistics(t);
+  static_assert(b.mean() == Tensor2D(2, 0, 0, 4) && b.variance() == Tensor2D(1, 0, 4, 0), "tensor failed");
+} // namespace Math::Accumulators::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::Statistics
+  \brief Running mean and (co)variance of a stream of vectors or tensors.
+  \tparam V Type of the samples: Vector<N, T> (covariance is a Tensor<N, T>) or Tensor<N, T>
+  (variance per component).
+
+  Samples are accumulated by Welford's updates of the mean and of the sum of squared
+  deviations from it, thus there is no cancellation of the naive sum of squares minus squared
+  sum, and a single pass over the data is enough. Statistics of two sets of samples are
+  merged by the formulas of Chan, Golub and LeVeque, so per-thread accumulators are combined
+  without a second pass:
+  \code
+  Math::Statistics<Vector3D> u_stats;   // e.g. a member of a monitor updated every step
+  u_stats += u;
+  u_stats += Math::statistics(velocities);  // range accumulated in parallel
+  auto R = u_stats.covariance();            // Reynolds stresses <u'u'>
+  \endcode
+  Math::statistics of a range accumulates blocks of samples by two passes over each (the block
+  is in L1, and there is no division per sample) and merges the blocks and the threads, the
+  result is deterministic for the given Parallel::concurrency().
+*/
+
+#endif // MATH_STATISTICS_H_INCLUDED
@@ -0,0 +1,347 @@
+#ifndef MATH_SUMMATION_H_INCLUDED
+#define MATH_SUMMATION_H_INCLUDED
+
+/*!
+  \file Summation.h
+  \author gennadiy
+  \brief Accurate summation of ranges of scalars, vectors and arrays, definition, documentation and tests.
+*/
+
+#include "Vector.h"
+#include <cmath>
+#include <concepts>
+#include <iterator>
+#include <limits>
+#include <ranges>
+
+namespace Math
+{
+  // running sum with compensation of the rounding errors
+  template<class T> class CompensatedSum
+  {
+    T s = T(); // sum
+    T c = T(); // accumulated rounding errors
+
+  public:
+    // ctors
+    constexpr CompensatedSum() noexcept = default;
+    constexpr explicit CompensatedSum(const T &x) noexcept : s(x) {}
+
+    // accumulation
+    constexpr CompensatedSum& operator+=(const T &x) noexcept;
+    constexpr CompensatedSum& operator+=(const CompensatedSum &x) noexcept;
+    constexpr CompensatedSum& add_product(const T &x, const T &y) noexcept;
+
+    // result
+    constexpr T value() const noexcept;
+    constexpr const T& sum() const noexcept { return s; }
+    constexpr const T& error() const noexcept { return c; }
+  }; // class CompensatedSum<T>
+
+  // sum of the elements by recursive halving of the range
+  template<std::ranges::random_access_range R>
+    constexpr auto pairwise_sum(R &&r) noexcept;
+
+  // sum of the elements with compensation of the rounding errors
+  template<std::ranges::input_range R>
+    constexpr auto compensated_sum(R &&r) noexcept;
+
+  // sum of x[i]*y[i] (dot products for vectors) with compensation of the rounding errors
+  template<std::ranges::input_range R1, std::ranges::input_range R2>
+    constexpr auto compensated_dot(R1 &&x, R2 &&y) noexcept;
+} // namespace Math
+
+namespace Math::details
+{
+  // error-free transformations: a + b = s + e and a * b = p + e exactly
+  template<std::floating_point T> constexpr T two_sum(T a, T b, T &e) noexcept;
+  template<std::floating_point T> constexpr T two_prod(T a, T b, T &e) noexcept;
+} // namespace Math::details
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definitions --------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::details::impl
+{
+  // uniform access to the components of scalars, vectors and arrays
+  template<class T> inline constexpr size_t ncomps_of = 1;
+  template<class T> requires requires { T::ncomps; }
+    inline constexpr size_t ncomps_of<T> = T::ncomps;
+
+  template<class T> constexpr decltype(auto) comp(T &x, size_t i) noexcept
+  {
+    if constexpr (requires { T::ncomps; })
+      return (x[i]);
+    else
+      return (x);
+  }
+
+  // FMA is used for exact products only if it's done in hardware
+  template<class T> inline constexpr bool fast_fma = false;
+#if defined(FP_FAST_FMAF)
+  template<> inline constexpr bool fast_fma<float> = true;
+#endif
+#if defined(FP_FAST_FMA)
+  template<> inline constexpr bool fast_fma<double> = true;
+#endif
+
+  // Veltkamp's splitting of a into two halves with non-overlapping bits, a = h + l
+  template<std::floating_point T> constexpr T split(T a, T &l) noexcept
+  {
+    constexpr T factor = static_cast<T>((1ull << ((std::numeric_limits<T>::digits + 1) / 2)) + 1);
+    T c = factor * a;
+    T h = c - (c - a);
+    l = a - h;
+    return h;
+  }
+
+  // number of elements summed naively at the bottom of the pairwise recursion
+  inline constexpr size_t pairwise_block = 16;
+
+  template<std::random_access_iterator It>
+    constexpr auto pairwise_sum(It first, size_t n) noexcept
+  {
+    if (n <= pairwise_block)
+    {
+      auto s = first[0];
+      for (size_t i = 1; i < n; ++i)
+        s += first[i];
+      return s;
+    }
+    auto h = n / 2;
+    auto s = pairwise_sum(first, h);
+    s += pairwise_sum(first + h, n - h);
+    return s;
+  }
+} // namespace Math::details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::floating_point T>
+  constexpr T Math::details::two_sum(T a, T b, T &e) noexcept
+{
+  // Knuth's branch-free version, the same result as Neumaier's comparison of magnitudes
+  T s = a + b;
+  T z = s - a;
+  e = (a - (s - z)) + (b - z);
+  return s;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::floating_point T>
+  constexpr T Math::details::two_prod(T a, T b, T &e) noexcept
+{
+  T p = a * b;
+  if constexpr (impl::fast_fma<T>)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      e = std::fma(a, b, -p);
+      return p;
+    }
+  }
+  // Dekker's product, exact unless the split halves overflow
+  T al, bl;
+  T ah = impl::split(a, al), bh = impl::split(b, bl);
+  e = ((ah*bh - p) + ah*bl + al*bh) + al*bl;
+  return p;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<class T>
+  constexpr auto Math::CompensatedSum<T>::operator+=(const T &x) noexcept -> CompensatedSum&
+{
+  for (size_t i = 0; i < details::impl::ncomps_of<T>; ++i)
+  {
+    auto &si = details::impl::comp(s, i);
+    auto e = si;
+    si = details::two_sum(si, details::impl::comp(x, i), e);
+    details::impl::comp(c, i) += e;
+  }
+  return *this;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<class T>
+  constexpr auto Math::CompensatedSum<T>::operator+=(const CompensatedSum &x) noexcept
+    -> CompensatedSum&
+{
+  *this += x.s;
+  c += x.c;
+  return *this;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<class T>
+  constexpr auto Math::CompensatedSum<T>::add_product(const T &x, const T &y) noexcept
+    -> CompensatedSum&
+{
+  for (size_t i = 0; i < details::impl::ncomps_of<T>; ++i)
+  {
+    auto &si = details::impl::comp(s, i);
+    auto q = si, e = si;
+    auto p = details::two_prod(details::impl::comp(x, i), details::impl::comp(y, i), q);
+    si = details::two_sum(si, p, e);
+    details::impl::comp(c, i) += e + q;
+  }
+  return *this;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<class T>
+  constexpr T Math::CompensatedSum<T>::value() const noexcept
+{
+  auto r = s;
+  r += c;
+  return r;
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::random_access_range R>
+  constexpr auto Math::pairwise_sum(R &&r) noexcept
+{
+  using T = std::ranges::range_value_t<R>;
+  auto n = static_cast<size_t>(std::ranges::distance(r));
+  return (n == 0)? T() : details::impl::pairwise_sum(std::ranges::begin(r), n);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::input_range R>
+  constexpr auto Math::compensated_sum(R &&r) noexcept
+{
+  CompensatedSum<std::ranges::range_value_t<R>> s;
+  for (const auto &x : r)
+    s += x;
+  return s.value();
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+template<std::ranges::input_range R1, std::ranges::input_range R2>
+  constexpr auto Math::compensated_dot(R1 &&x, R2 &&y) noexcept
+{
+  using T = std::ranges::range_value_t<R1>;
+  static_assert(std::is_same_v<T, std::ranges::range_value_t<R2>>, "Ranges of different types");
+
+  // dot product of vectors is the sum of all componentwise products
+  using S = std::remove_cvref_t<decltype(details::impl::comp(std::declval<T&>(), 0))>;
+  CompensatedSum<S> s;
+  auto j = std::ranges::begin(y);
+  for (auto i = std::ranges::begin(x); i != std::ranges::end(x); ++i, ++j)
+    for (size_t k = 0; k < details::impl::ncomps_of<T>; ++k)
+      s.add_product(details::impl::comp(*i, k), details::impl::comp(*j, k));
+  return s.value();
+}
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::Summation::tests
+{
+  // error-free transformations
+  constexpr double e1 = [] { double e = 0; details::two_sum(1., 1e-20, e); return e; }();
+  static_assert(e1 == 1e-20, "two_sum failed");
+
+  constexpr float e2 = [] { float e = 0; details::two_prod(1.f + 0x1p-20f, 1.f + 0x1p-20f, e); return e; }();
+  static_assert(e2 == 0x1p-40f, "two_prod failed");
+
+  // sums
+  constexpr double x[] = {1., 1e100, 1., -1e100};
+  static_assert(compensated_sum(x) == 2., "compensated sum failed");
+
+  constexpr int n[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+  static_assert(pairwise_sum(n) == 210, "pairwise sum failed");
+
+  constexpr Vector<2, float> v[] = {Vector<2, float>(1.f, 1e8f), Vector<2, float>(1e8f, 1.f),
+                                    Vector<2, float>(-1e8f, -1e8f)};
+  static_assert(compensated_sum(v) == Vector<2, float>(1.f, 1.f), "compensated vector sum failed");
+
+  // (1 + 2^-12)^2 - 1 = 2^-11 + 2^-24, the naive dot product loses 2^-24
+  constexpr Vector<2, float> p[] = {Vector<2, float>(1.f + 0x1p-12f, 1.f)},
+                             q[] = {Vector<2, float>(1.f + 0x1p-12f, -1.f)};
+  static_assert(p[0] * q[0] == 0x1p-11f, "naive dot failed");
+  static_assert(compensated_dot(p, q) == 0x1p-11f + 0x1p-24f, "compensated dot failed");
+} // namespace Math::Summation::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::CompensatedSum
+  \brief Running sum of scalars, vectors or arrays of floating point numbers
+    with compensation of the rounding errors.
+  \tparam T Type of the terms: floating point or Math::Vector of them.
+
+  Each addition is transformed into the rounded sum and its exact rounding error
+  (Knuth's TwoSum, i.e. Neumaier's variant of Kahan summation w/o branches),
+  the errors are accumulated separately and added to the sum at the end.
+  The result is as accurate as if the sum was computed in twice the working
+  precision and then rounded, i.e. the error doesn't grow with the number of terms
+  for well-conditioned sums. The unevaluated pair sum() + error() keeps about twice
+  as many correct bits as the working precision, e.g. for floats it can be added up in double
+  (the relative error is about 1e-10 for a million of terms):
+  \code
+  CompensatedSum<Vector<3, float>> s;
+  for (auto &v : velocities)
+    s += v;
+  auto total = Vector<3, double>(s.sum()) + Vector<3, double>(s.error());
+  \endcode
+
+  For vectors and arrays the compensation is done componentwise.
+  NB! Don't compile it with -ffast-math or similar options, they allow the compiler
+  to simplify the error terms to zero.
+*/
+
+/*!
+  \fn constexpr CompensatedSum& Math::CompensatedSum::add_product(const T &x, const T &y) noexcept
+  \brief Adds componentwise product of x and y, the rounding error of the product
+    is compensated too (Ogita-Rump-Oishi's Dot2 algorithm).
+*/
+
+/*!
+  \fn constexpr auto Math::pairwise_sum(R &&r) noexcept
+  \brief Sum of the elements of a random access range computed by recursive halving.
+  \param r Range of scalars, vectors or arrays.
+  \return Sum of the elements, zero for an empty range.
+
+  Worst-case error grows as O(log n) instead of O(n) for the naive loop,
+  with almost the same speed. Works for any type with +=, incl. integers.
+*/
+
+/*!
+  \fn constexpr auto Math::compensated_sum(R &&r) noexcept
+  \brief Sum of the elements of a range with compensation of the rounding errors.
+  \param r Range of floating point numbers, vectors or arrays of them.
+  \return Sum of the elements as accurate as if computed in twice the working precision.
+
+  Makes accumulation of float data as accurate as in double, e.g. the components
+  of Math::VectorField<N, float> can be summed up without loss of accuracy:
+  \code
+  float sx = compensated_sum(field.component(0));
+  \endcode
+  \see Math::CompensatedSum
+*/
+
+/*!
+  \fn constexpr auto Math::compensated_dot(R1 &&x, R2 &&y) noexcept
+  \brief Sum of products x[i]*y[i] with compensation of the rounding errors.
+  \param x Range of floating point numbers, vectors or arrays of them.
+  \param y Range of the same type, must have at least as many elements as x.
+  \return Sum of the products (dot products for vectors) as accurate as if computed
+    in twice the working precision.
+
+  Products are split exactly with FMA if it is fast on the target (FP_FAST_FMA),
+  otherwise with Dekker's algorithm.
+*/
+
+#endif // MATH_SUMMATION_H_INCLUDED
@@ -0,0 +1,446 @@
+#ifndef MATH_SYM_TENSOR_H_INCLUDED
+#define MATH_SYM_TENSOR_H_INCLUDED
+
+/*!
+  \file SymTensor.h
+  \author gennadiy
+  \brief Symmetric tensor of rank 2 with packed storage, definition, documentation and tests.
+*/
+
+#include "Tensor.h"
+
+namespace Math
+{
+  template<size_t N, Type T = double> class SymTensor
+  {
+    static constexpr size_t M = N*(N + 1)/2;
+
+    // upper triangle row by row, e.g. xx, xy, xz, yy, yz, zz
+    T data[M] = {};
+    static_assert(N != 0, "Tensor of zero size is meaningless.");
+
+    static constexpr size_t index(size_t i, size_t j) noexcept
+      { return (i <= j)? i*N - i*(i + 1)/2 + j : j*N - j*(j + 1)/2 + i; }
+
+  public:
+    // traits
+    static constexpr int ncomps = M;
+
+    constexpr auto* begin() noexcept { return data; }
+    constexpr auto* end() noexcept { return data + M; }
+    constexpr auto* begin() const noexcept { return data; }
+    constexpr auto* end() const noexcept { return data + M; }
+
+    // ctors: a single value gives a*E, N values the diagonal, N(N+1)/2 values the upper triangle
+    constexpr SymTensor() noexcept = default;
+    template<class U> requires std::constructible_from<T, const U&>
+      constexpr explicit SymTensor(const U &a) noexcept;
+    template<class... Ts> requires (sizeof...(Ts) > 1)
+      constexpr explicit SymTensor(const Ts&... as) noexcept;
+
+    // converters, from Tensor takes its symmetric part (A + ~A)/2
+    template<Type U> constexpr explicit SymTensor(const SymTensor<N, U> &t) noexcept;
+    constexpr explicit SymTensor(const Tensor<N, T> &A) noexcept;
+    constexpr explicit operator Tensor<N, T>() const noexcept;
+
+    // access, (i, j) and (j, i) are the same component
+    constexpr T& operator()(size_t i, size_t j) noexcept { assert(i < N && j < N); return data[index(i, j)]; }
+    constexpr const T& operator()(size_t i, size_t j) const noexcept { assert(i < N && j < N); return data[index(i, j)]; }
+
+    // unary ops (NB! returns a copy!)
+    constexpr SymTensor operator-() const noexcept;
+    constexpr SymTensor operator+() const noexcept { return *this; }
+    constexpr SymTensor operator~() const noexcept { return *this; }
+
+    // assign with op, the product of symmetric tensors is symmetrized: A*B = (AB + BA)/2
+    constexpr SymTensor& operator*=(const T &a) noexcept;
+    constexpr SymTensor& operator/=(const T &a) noexcept;
+    constexpr SymTensor& operator+=(const SymTensor &A) noexcept;
+    constexpr SymTensor& operator-=(const SymTensor &A) noexcept;
+    constexpr SymTensor& operator*=(const SymTensor &A) noexcept;
+    constexpr SymTensor& operator/=(const SymTensor &A) noexcept { return *this *= A.invert(); }
+
+    // comparison ops, all the lanes of SIMD packs must be equal
+    constexpr bool operator==(const SymTensor &A) const noexcept;
+
+    // other useful ops
+    constexpr T det() const noexcept;
+    constexpr T trace() const noexcept;
+    constexpr SymTensor invert() const noexcept;
+    constexpr SymTensor transpose() const noexcept { return *this; }
+  }; // class SymTensor<N, T>
+
+  using SymTensor2D = SymTensor<2>;
+  using SymTensor3D = SymTensor<3>;
+
+/*---------------------------------------------------------------------------------------*/
+
+  // arithmetic ops
+  template<size_t N, Type T>
+    constexpr auto operator+(SymTensor<N, T> A, const SymTensor<N, T> &B) noexcept { A += B; return A; }
+
+  template<size_t N, Type T>
+    constexpr auto operator-(SymTensor<N, T> A, const SymTensor<N, T> &B) noexcept { A -= B; return A; }
+
+  template<size_t N, Type T>
+    constexpr auto operator*(SymTensor<N, T> A, const SymTensor<N, T> &B) noexcept { A *= B; return A; }
+
+  template<size_t N, Type T>
+    constexpr auto operator*(SymTensor<N, T> A, const T &a) noexcept { A *= a; return A; }
+
+  template<size_t N, Type T>
+    constexpr auto operator*(const T &a, SymTensor<N, T> A) noexcept { A *= a; return A; }
+
+  template<size_t N, Type T>
+    constexpr auto operator/(SymTensor<N, T> A, const T &a) noexcept { A /= a; return A; }
+
+  template<size_t N, Type T>
+    constexpr auto operator/(SymTensor<N, T> A, const SymTensor<N, T> &B) noexcept { A /= B; return A; }
+
+  // full contraction A:B = sum of A[i][j]*B[i][j]
+  template<size_t N, Type T>
+    constexpr T contract(const SymTensor<N, T> &A, const SymTensor<N, T> &B) noexcept;
+
+  template<size_t N, Type T>
+    constexpr T contract(const SymTensor<N, T> &A, const Tensor<N, T> &B) noexcept;
+
+  // io ops
+  template<size_t N, Type T>
+    std::istream& operator>>(std::istream &in, SymTensor<N, T> &A);
+
+  template<size_t N, Type T>
+    std::ostream& operator<<(std::ostream &out, const SymTensor<N, T> &A);
+
+  // ops with vectors, A*a == a*A
+  template<size_t N, Type T, class L>
+    constexpr auto operator*(const SymTensor<N, T> &A, const Vector<N, T, true, L> &a) noexcept;
+
+  template<size_t N, Type T, class L>
+    constexpr auto operator*(const Vector<N, T, true, L> &a, const SymTensor<N, T> &A) noexcept
+      { return A * a; }
+
+  template<size_t N, Type T, class L>
+    constexpr auto& operator*=(Vector<N, T, true, L> &a, const SymTensor<N, T> &A) noexcept
+      { return a = A * a; }
+
+  // a ^ a as a symmetric tensor
+  template<size_t N, Type T, class L>
+    constexpr SymTensor<N, T> sqr(const Vector<N, T, true, L> &a) noexcept;
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definition ---------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T> template<class U> requires std::constructible_from<T, const U&>
+    constexpr SymTensor<N, T>::SymTensor(const U &a) noexcept
+  {
+    for (size_t i = 0; i < N; ++i)
+      data[index(i, i)] = static_cast<T>(a);
+  }
+
+  template<size_t N, Type T> template<class... Ts> requires (sizeof...(Ts) > 1)
+    constexpr SymTensor<N, T>::SymTensor(const Ts&... as) noexcept
+  {
+    constexpr auto n = sizeof...(Ts);
+    static_assert(n == N || n == M, "Ambiguous number of arguments.");
+    const T values[] = {static_cast<T>(as)...};
+    if constexpr (n == M)
+      for (size_t k = 0; k < n; ++k)
+        data[k] = values[k];
+    else
+      for (size_t i = 0; i < N; ++i)
+        data[index(i, i)] = values[i];
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    template<Type U> constexpr SymTensor<N, T>::SymTensor(const SymTensor<N, U> &t) noexcept
+  {
+    for (size_t k = 0; k < M; ++k)
+      data[k] = static_cast<T>(t.begin()[k]);
+  }
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T>::SymTensor(const Tensor<N, T> &A) noexcept
+  {
+    for (size_t i = 0; i < N; ++i)
+    {
+      data[index(i, i)] = A[i][i];
+      for (size_t j = i + 1; j < N; ++j)
+        data[index(i, j)] = (A[i][j] + A[j][i]) / static_cast<T>(2);
+    }
+  }
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T>::operator Tensor<N, T>() const noexcept
+  {
+    Tensor<N, T> A;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        A[i][j] = data[index(i, j)];
+    return A;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T> SymTensor<N, T>::operator-() const noexcept
+  {
+    SymTensor<N, T> A;
+    for (size_t k = 0; k < M; ++k)
+      A.data[k] = -data[k];
+    return A;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T>& SymTensor<N, T>::operator*=(const T &a) noexcept
+  {
+    for (size_t k = 0; k < M; ++k)
+      data[k] *= a;
+    return *this;
+  }
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T>& SymTensor<N, T>::operator/=(const T &a) noexcept
+  {
+    for (size_t k = 0; k < M; ++k)
+      data[k] /= a;
+    return *this;
+  }
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T>& SymTensor<N, T>::operator+=(const SymTensor<N, T> &A) noexcept
+  {
+    for (size_t k = 0; k < M; ++k)
+      data[k] += A.data[k];
+    return *this;
+  }
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T>& SymTensor<N, T>::operator-=(const SymTensor<N, T> &A) noexcept
+  {
+    for (size_t k = 0; k < M; ++k)
+      data[k] -= A.data[k];
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr SymTensor<N, T>& SymTensor<N, T>::operator*=(const SymTensor<N, T> &A) noexcept
+  {
+    // (AB + BA)[i][j] = sum of A[i][k]*B[k][j] + A[j][k]*B[k][i], i.e. symmetric in i, j
+    auto B = *this;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = i; j < N; ++j)
+      {
+        T s = 0;
+        for (size_t k = 0; k < N; ++k)
+          s += B(i, k)*A(k, j) + B(j, k)*A(k, i);
+        data[index(i, j)] = s / static_cast<T>(2);
+      }
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr bool SymTensor<N, T>::operator==(const SymTensor<N, T> &A) const noexcept
+  {
+    for (size_t k = 0; k < M; ++k)
+      if (!details::all(data[k] == A.data[k]))
+        return false;
+    return true;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T> constexpr T SymTensor<N, T>::trace() const noexcept
+  {
+    T tr = 0;
+    for (size_t i = 0; i < N; ++i)
+      tr += data[index(i, i)];
+    return tr;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr T SymTensor<N, T>::det() const noexcept
+  {
+    const T *a = data;
+    if constexpr (N == 1)
+      return a[0];
+    else if constexpr (N == 2) // xx xy yy
+      return a[0]*a[2] - a[1]*a[1];
+    else if constexpr (N == 3) // xx xy xz yy yz zz
+      return a[0] * (a[3]*a[5] - a[4]*a[4]) +
+             a[1] * (a[4]*a[2] - a[1]*a[5]) +
+             a[2] * (a[1]*a[4] - a[3]*a[2]);
+    else
+      return Tensor<N, T>(*this).det();
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T> constexpr SymTensor<N, T> SymTensor<N, T>::invert() const noexcept
+  {
+    if constexpr (N == 2 || N == 3)
+    {
+      // the adjugate of a symmetric tensor is symmetric, 3 (2D) or 6 (3D) cofactors instead of 4 or 9
+      T d = det();
+      auto singular = (d == static_cast<T>(0));
+      if (details::all(singular))
+        return SymTensor<N, T>(0); // inverse matrix doesn't exist, return 0
+
+      // lanes of SIMD packs are inverted independently, singular ones give 0 as above
+      T c = details::select(singular, static_cast<T>(0), static_cast<T>(1) / d);
+      const T *a = data;
+      if constexpr (N == 2)
+        return SymTensor<N, T>(c*a[2], -c*a[1], c*a[0]);
+      else
+        return SymTensor<N, T>(c*(a[3]*a[5] - a[4]*a[4]), c*(a[2]*a[4] - a[1]*a[5]), c*(a[1]*a[4] - a[2]*a[3]),
+                               c*(a[0]*a[5] - a[2]*a[2]), c*(a[1]*a[2] - a[0]*a[4]),
+                               c*(a[0]*a[3] - a[1]*a[1]));
+    }
+    else
+      return SymTensor<N, T>(Tensor<N, T>(*this).invert());
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr T contract(const SymTensor<N, T> &A, const SymTensor<N, T> &B) noexcept
+  {
+    // off-diagonal components are counted twice
+    T d = 0, o = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+      d += A(i, i) * B(i, i);
+      for (size_t j = i + 1; j < N; ++j)
+        o += A(i, j) * B(i, j);
+    }
+    return d + o + o;
+  }
+
+  template<size_t N, Type T>
+    constexpr T contract(const SymTensor<N, T> &A, const Tensor<N, T> &B) noexcept
+  {
+    T s = 0;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        s += A(i, j) * B[i][j];
+    return s;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type U>
+    std::istream& operator>>(std::istream &in, SymTensor<N, U> &A)
+  {
+    IO::read_values(in, A, '[', ']');
+    return in;
+  }
+
+  template<size_t N, Type U>
+    std::ostream& operator<<(std::ostream &out, const SymTensor<N, U> &A)
+  {
+    IO::write_values(out, A, '[', ']');
+    return out;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, class L>
+    constexpr auto operator*(const SymTensor<N, T> &A, const Vector<N, T, true, L> &a) noexcept
+  {
+    Vector<N, T, true, L> b;
+    for (size_t i = 0; i < N; ++i)
+    {
+      T s = 0;
+      for (size_t j = 0; j < N; ++j)
+        s += A(i, j) * a[j];
+      b[i] = s;
+    }
+    return b;
+  }
+
+  template<size_t N, Type T, class L>
+    constexpr SymTensor<N, T> sqr(const Vector<N, T, true, L> &a) noexcept
+  {
+    SymTensor<N, T> A;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = i; j < N; ++j)
+        A(i, j) = a[i] * a[j];
+    return A;
+  }
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::SymTensors::tests
+{
+  static_assert(Type<SymTensor3D>, "Type failed");
+  static_assert(sizeof(SymTensor3D) == 6 * sizeof(double), "storage failed");
+
+  using S2i = SymTensor<2, int>;
+  using S3i = SymTensor<3, int>;
+  using T3i = Tensor<3, int>;
+  using V3i = Vector<3, int>;
+
+  // init & access
+  constexpr S3i Z, E(1), D(1, 2, 3), A(1, 2, 3, 4, 5, 6);
+  static_assert(Z.trace() == 0 && E.trace() == 3 && D.trace() == 6 && A.trace() == 11, "trace failed");
+  static_assert(A(0, 1) == 2 && A(1, 0) == 2 && A(2, 1) == 5 && A(2, 2) == 6, "access failed");
+  static_assert(D(1, 1) == 2 && D(0, 2) == 0, "diagonal init failed");
+
+  // conversions
+  constexpr T3i a = T3i(A);
+  static_assert(a == T3i(1, 2, 3, 2, 4, 5, 3, 5, 6), "to tensor failed");
+  static_assert(S3i(a) == A && S3i(T3i(1, 2, 0, 4, 5, 0, 0, 0, 1)) == S3i(1, 3, 0, 5, 0, 1), "from tensor failed");
+
+  // ops
+  static_assert(A + A == 2 * A && A - A == Z && -A == Z - A && A * E == A, "arithmetic failed");
+  static_assert(T3i(A * D) == (a * T3i(D) + T3i(D) * a) / 2, "symmetrized product failed");
+  static_assert(A.det() == a.det() && D.det() == 6, "|A| failed");
+  static_assert(S2i(2, 1, 1).invert() == S2i(1, -1, 2) && S2i(1, 1, 1).invert() == S2i(0), "A^-1 failed");
+  static_assert(T3i(S3i(1, 2, 3, 5, 4, 14).invert()) == T3i(1, 2, 3, 2, 5, 4, 3, 4, 14).invert(), "A^-1 failed");
+  static_assert(contract(A, D) == 1 + 8 + 18 && contract(A, A) == contract(A, a), "contraction failed");
+  static_assert(A * V3i(1, 0, -1) == a * V3i(1, 0, -1) && V3i(1, 0, -1) * A == A * V3i(1, 0, -1), "A*v failed");
+  static_assert(T3i(sqr(V3i(1, 2, 3))) == (V3i(1, 2, 3) ^ V3i(1, 2, 3)), "a^a failed");
+} // namespace Math::SymTensors::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::SymTensor
+  \brief Symmetric tensor of rank 2 with packed storage.
+  \tparam N Spatial dimension (the tensor stores N*(N+1)/2 components).
+  \tparam T Type of the components.
+
+  Stress, strain or metric tensors: the upper triangle is stored row by row (xx, xy, xz, yy,
+  yz, zz in 3D), i.e. 6 components instead of 9, and the arithmetic, determinant, inverse
+  (by 6 cofactors), contraction and products with vectors touch only them. Conversion from
+  Math::Tensor takes its symmetric part, conversion to it is explicit.
+
+  The product of two symmetric tensors is not symmetric in general, so \c * and \c /
+  of SymTensor's are the symmetrized ones: A*B = (AB + BA)/2, A/B = A*B^-1. They coincide
+  with the usual products for commuting tensors (e.g. A*A, A*E or A/A), and make SymTensor
+  a Math::Type, so it can be a component of Quantities::State.
+*/
+
+/*!
+  \fn constexpr SymTensor SymTensor::invert() const noexcept
+  \brief Get the inverse tensor.
+  \return The inverse tensor to the given one, or zero tensor if it is singular
+    (lane by lane for Math::Pack components).
+*/
+
+#endif // MATH_SYM_TENSOR_H_INCLUDED
@@ -8,6 +8,9 @@
 */
 
 #include "Vector.h"
+#include <concepts>
+#include <type_traits>
+#include <utility>
 
 namespace Math
 {
@@ -28,8 +31,10 @@ namespace Math
 
     // ctors
     constexpr Tensor() noexcept = default;
-    template<class U> constexpr explicit Tensor(const U &a) noexcept;
-    template<class... Ts> constexpr explicit Tensor(const Ts&... as) noexcept;
+    template<class U> requires std::constructible_from<T, const U&>
+      constexpr explicit Tensor(const U &a) noexcept;
+    template<class... Ts> requires (sizeof...(Ts) > 1)
+      constexpr explicit Tensor(const Ts&... as) noexcept;
 
     // converters
     template<Type U> constexpr explicit Tensor(const Tensor<N, U> &t) noexcept;
@@ -51,10 +56,10 @@ namespace Math
     constexpr Tensor& operator+=(const Tensor &A) noexcept;
     constexpr Tensor& operator-=(const Tensor &A) noexcept;
     constexpr Tensor& operator*=(const Tensor &A) noexcept;
-    constexpr Tensor& operator/=(const Tensor &A) noexcept { return *this *= A.invert(); }
+    constexpr Tensor& operator/=(const Tensor &A) noexcept;
 
-    // comparison ops
-    constexpr bool operator==(const Tensor &) const noexcept = default;
+    // comparison ops, all the lanes of SIMD packs must be equal
+    constexpr bool operator==(const Tensor &A) const noexcept;
 
     // other useful ops
     constexpr T det() const noexcept;
@@ -99,6 +104,10 @@ namespace Math
   template<size_t N, Type T>
     constexpr auto operator/(Tensor<N, T> A, const Tensor<N, T> &B) noexcept { A /= B; return A; }
 
+  // componentwise equality, i.e. the mask of equal lanes for SIMD packs
+  template<size_t N, Type T>
+    constexpr auto equal(const Tensor<N, T> &A, const Tensor<N, T> &B) noexcept;
+
   // io ops
   // TODO: error-handling: throw an exception in case of unexpected symbols, ...
   template<size_t N, Type T>
@@ -108,55 +117,60 @@ namespace Math
     std::ostream& operator<<(std::ostream &out, const Tensor<N, T> &A);
 
   // ops with vectors
-  template<size_t N, Type T>
-    constexpr auto& operator*=(Vector<N, T> &a, const Tensor<N, T> &A) noexcept;
+  template<size_t N, Type T, class L>
+    constexpr auto& operator*=(Vector<N, T, true, L> &a, const Tensor<N, T> &A) noexcept;
 
-  template<size_t N, Type T>
-    constexpr auto operator*(Vector<N, T> a, const Tensor<N, T> &A) noexcept { a *= A; return a; }
+  template<size_t N, Type T, class L>
+    constexpr auto operator*(Vector<N, T, true, L> a, const Tensor<N, T> &A) noexcept
+      { a *= A; return a; }
 
-  template<size_t N, Type T>
-    constexpr auto operator*(const Tensor<N, T> &A, Vector<N, T> a) noexcept { a *= ~A; return a; }
+  template<size_t N, Type T, class L>
+    constexpr auto operator*(const Tensor<N, T> &A, Vector<N, T, true, L> a) noexcept
+      { a *= ~A; return a; }
 
-  template<size_t N, Type T>
-    constexpr auto& operator/=(Vector<N, T> &a, const Tensor<N, T> &A) noexcept { return a *= A.invert(); }
+  template<size_t N, Type T, class L>
+    constexpr auto& operator/=(Vector<N, T, true, L> &a, const Tensor<N, T> &A) noexcept;
 
-  template<size_t N, Type T>
-    constexpr auto operator/(Vector<N, T> a, const Tensor<N, T> &A) noexcept { a /= A; return a; }
+  template<size_t N, Type T, class L>
+    constexpr auto operator/(Vector<N, T, true, L> a, const Tensor<N, T> &A) noexcept
+      { a /= A; return a; }
 
-  template<size_t N, Type T>
-    constexpr auto operator^(const Vector<N, T> &a, const Vector<N, T> &b) noexcept;
+  template<size_t N, Type T, class L>
+    constexpr auto operator^(
+      const Vector<N, T, true, L> &a, const Vector<N, T, true, L> &b) noexcept;
 
   // ops with 2D vectors
-  template<Type T>
-    constexpr auto operator%(const Tensor<2, T> &A, const Vector<2, T> &a) noexcept;
+  template<Type T, class L>
+    constexpr auto operator%(const Tensor<2, T> &A, const Vector<2, T, true, L> &a) noexcept;
 
-  template<Type T>
-    constexpr auto operator%(const Vector<2, T> &a, const Tensor<2, T> &A) noexcept;
+  template<Type T, class L>
+    constexpr auto operator%(const Vector<2, T, true, L> &a, const Tensor<2, T> &A) noexcept;
 
   template<Type T>
     constexpr auto operator%(const Tensor<2, T> &A, const Tensor<2, T> &B) noexcept;
 
   // ops with 3D vectors
-  template<Type T> constexpr Tensor<3, T> operator~(const Vector<3, T> &a) noexcept;
+  template<Type T, class L>
+    constexpr Tensor<3, T> operator~(const Vector<3, T, true, L> &a) noexcept;
 
-  template<Type T>
-    constexpr auto operator%(const Tensor<3, T> &A, const Vector<3, T> &a) noexcept;
+  template<Type T, class L>
+    constexpr auto operator%(const Tensor<3, T> &A, const Vector<3, T, true, L> &a) noexcept;
 
-  template<Type T>
-    constexpr auto operator%(const Vector<3, T> &a, const Tensor<3, T> &A) noexcept;
+  template<Type T, class L>
+    constexpr auto operator%(const Vector<3, T, true, L> &a, const Tensor<3, T> &A) noexcept;
 
 /*---------------------------------------------------------------------------------------*/
 /*------------------------------------ definition ---------------------------------------*/
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T> template<class U>
+  template<size_t N, Type T> template<class U> requires std::constructible_from<T, const U&>
     constexpr Tensor<N, T>::Tensor(const U &a) noexcept
   {
     for (size_t i = 0; i < N; ++i)
       data[i][i] = static_cast<T>(a);
   }
 
-  template<size_t N, Type T> template<class... Ts>
+  template<size_t N, Type T> template<class... Ts> requires (sizeof...(Ts) > 1)
     constexpr Tensor<N, T>::Tensor(const Ts&... as) noexcept
   {
     constexpr auto n = sizeof...(Ts);
@@ -241,11 +255,102 @@ namespace Math
     return *this;
   }
 
+/*---------------------------------------------------------------------------------------*/
+
+  namespace details::impl
+  {
+    // tensors of this size and larger are multiplied by register tiles in runtime
+    inline constexpr size_t tiled_multiply_min = 12;
+
+    // number of T in the packed registers, 1 if there are none
+    template<class T> constexpr size_t packed_width() noexcept
+    {
+      if constexpr (simd::packed<T>::enabled)
+        return simd::packed<T>::width;
+      else
+        return 1;
+    }
+
+    // C[I..I+R)[J..J+L) = B[I..I+R)[:] * A[:][J..J+L), the R x L sums are kept in registers,
+    // the rows of A are loaded by L contiguous components and each B[i][k] is broadcast to them
+    template<size_t R, size_t L, size_t N, class T>
+      void multiply_tile(const Tensor<N, T> &B, const Tensor<N, T> &A, Tensor<N, T> &C,
+        size_t I, size_t J) noexcept
+    {
+      using P = simd::packed<T>;
+      if constexpr (packed_width<T>() > 1 && L % packed_width<T>() == 0)
+      {
+        constexpr size_t W = L / P::width;
+        typename P::reg c[R][W];
+        for (size_t r = 0; r < R; ++r)
+          for (size_t w = 0; w < W; ++w)
+            c[r][w] = P::zero();
+        for (size_t k = 0; k < N; ++k)
+        {
+          typename P::reg a[W];
+          for (size_t w = 0; w < W; ++w)
+            a[w] = P::load(A[k] + J + w*P::width);
+          for (size_t r = 0; r < R; ++r)
+          {
+            const auto b = P::set1(B[I + r][k]);
+            for (size_t w = 0; w < W; ++w)
+              c[r][w] = P::add(c[r][w], P::mul(b, a[w]));
+          }
+        }
+        for (size_t r = 0; r < R; ++r)
+          for (size_t w = 0; w < W; ++w)
+            P::store(C[I + r] + J + w*P::width, c[r][w]);
+      }
+      else
+      {
+        T c[R][L] = {};
+        for (size_t k = 0; k < N; ++k)
+          for (size_t r = 0; r < R; ++r)
+          {
+            const T b = B[I + r][k];
+            for (size_t l = 0; l < L; ++l)
+              c[r][l] += b * A[k][J + l];
+          }
+        for (size_t r = 0; r < R; ++r)
+          for (size_t l = 0; l < L; ++l)
+            C[I + r][J + l] = c[r][l];
+      }
+    }
+
+    // C = B * A by tiles, the panel of L columns of A stays in L1 cache while it is multiplied
+    // by all the rows of B, the remainders of the rows and columns are tiles of smaller sizes
+    template<size_t N, class T>
+      void tiled_multiply(const Tensor<N, T> &B, const Tensor<N, T> &A, Tensor<N, T> &C) noexcept
+    {
+      constexpr size_t R = 4, L = std::max<size_t>(2 * packed_width<T>(), 4);
+      constexpr size_t NR = N - N % R, NL = N - N % L;
+      auto panel = [&]<size_t W>(size_t J)
+      {
+        for (size_t I = 0; I < NR; I += R)
+          multiply_tile<R, W>(B, A, C, I, J);
+        if constexpr (N % R != 0)
+          multiply_tile<N % R, W>(B, A, C, NR, J);
+      };
+      for (size_t J = 0; J < NL; J += L)
+        panel.template operator()<L>(J);
+      if constexpr (N % L != 0)
+        panel.template operator()<N % L>(NL);
+    }
+  } // namespace details::impl
+
 /*---------------------------------------------------------------------------------------*/
 
   template<size_t N, Type T>
     constexpr Tensor<N, T>& Tensor<N, T>::operator*=(const Tensor<N, T> &A) noexcept
   {
+    if constexpr (N >= details::impl::tiled_multiply_min && std::floating_point<T>)
+      if (!std::is_constant_evaluated())
+      {
+        Tensor<N, T> C;
+        details::impl::tiled_multiply(*this, A, C);
+        return *this = C;
+      }
+
     auto B = *this;
     for (size_t i = 0; i < N; ++i)
       for (size_t j = 0; j < N; ++j)
@@ -257,6 +362,29 @@ namespace Math
     return *this;
   }
 
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr bool Tensor<N, T>::operator==(const Tensor<N, T> &A) const noexcept
+  {
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        if (!details::all(data[i][j] == A[i][j]))
+          return false;
+    return true;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr auto equal(const Tensor<N, T> &A, const Tensor<N, T> &B) noexcept
+  {
+    auto r = (*A.begin() == *B.begin());
+    for (size_t k = 1; k < N*N; ++k)
+      r = r && (A.begin()[k] == B.begin()[k]);
+    return r;
+  }
+
 /*---------------------------------------------------------------------------------------*/
 
   template<size_t N, Type T> constexpr T Tensor<N, T>::trace() const noexcept
@@ -267,6 +395,169 @@ namespace Math
     return tr;
   }
 
+/*---------------------------------------------------------------------------------------*/
+
+  namespace details::impl
+  {
+    // LU decomposition with partial pivoting in place: PA = LU, L (unit diagonal) and U are stored
+    // in A, p[i] is the row of the original A in the row i, returns the sign of P or 0 if A is singular
+    template<size_t N, std::floating_point T>
+      constexpr int lu_decompose(Tensor<N, T> &A, size_t (&p)[N]) noexcept
+    {
+      int sign = 1;
+      for (size_t i = 0; i < N; ++i)
+        p[i] = i;
+
+      for (size_t k = 0; k < N; ++k)
+      {
+        size_t m = k;
+        T amax = (A[k][k] < 0)? -A[k][k] : A[k][k];
+        for (size_t i = k + 1; i < N; ++i)
+        {
+          T a = (A[i][k] < 0)? -A[i][k] : A[i][k];
+          if (amax < a)
+          {
+            amax = a;
+            m = i;
+          }
+        }
+        if (amax == 0)
+          return 0;
+        if (m != k)
+        {
+          for (size_t j = 0; j < N; ++j)
+            std::swap(A[k][j], A[m][j]);
+          std::swap(p[k], p[m]);
+          sign = -sign;
+        }
+
+        const T r = T(1) / A[k][k];
+        for (size_t i = k + 1; i < N; ++i)
+        {
+          const T l = A[i][k] *= r;
+          for (size_t j = k + 1; j < N; ++j)
+            A[i][j] -= l * A[k][j];
+        }
+      }
+      return sign;
+    }
+
+    template<size_t N, std::floating_point T> constexpr T lu_det(Tensor<N, T> A) noexcept
+    {
+      size_t p[N];
+      T d = lu_decompose(A, p);
+      for (size_t k = 0; k < N; ++k)
+        d *= A[k][k];
+      return d;
+    }
+
+    // solves A X = B by the decomposition above, all the columns of X at once by row operations,
+    // i.e. contiguous loops
+    template<size_t N, std::floating_point T>
+      constexpr Tensor<N, T> lu_solve(const Tensor<N, T> &A, const size_t (&p)[N], const Tensor<N, T> &B) noexcept
+    {
+      Tensor<N, T> X;
+      for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < N; ++j)
+          X[i][j] = B[p[i]][j];
+      // L Y = P B
+      for (size_t i = 1; i < N; ++i)
+        for (size_t k = 0; k < i; ++k)
+        {
+          const T l = A[i][k];
+          for (size_t j = 0; j < N; ++j)
+            X[i][j] -= l * X[k][j];
+        }
+      // U X = Y
+      for (size_t i = N; i-- > 0;)
+      {
+        for (size_t k = i + 1; k < N; ++k)
+        {
+          const T u = A[i][k];
+          for (size_t j = 0; j < N; ++j)
+            X[i][j] -= u * X[k][j];
+        }
+        const T r = T(1) / A[i][i];
+        for (size_t j = 0; j < N; ++j)
+          X[i][j] *= r;
+      }
+      return X;
+    }
+
+    // the same for A x = b
+    template<size_t N, std::floating_point T, class L>
+      constexpr Vector<N, T, true, L> lu_solve(
+        const Tensor<N, T> &A, const size_t (&p)[N], const Vector<N, T, true, L> &b) noexcept
+    {
+      Vector<N, T, true, L> x;
+      for (size_t i = 0; i < N; ++i)
+      {
+        T s = b[p[i]];
+        for (size_t k = 0; k < i; ++k)
+          s -= A[i][k] * x[k];
+        x[i] = s;
+      }
+      for (size_t i = N; i-- > 0;)
+      {
+        T s = x[i];
+        for (size_t k = i + 1; k < N; ++k)
+          s -= A[i][k] * x[k];
+        x[i] = s / A[i][i];
+      }
+      return x;
+    }
+
+    template<size_t N, std::floating_point T> constexpr Tensor<N, T> lu_invert(Tensor<N, T> A) noexcept
+    {
+      size_t p[N];
+      if (lu_decompose(A, p) == 0)
+        return Tensor<N, T>(0); // inverse matrix doesn't exist, return 0
+      return lu_solve(A, p, Tensor<N, T>(1));
+    }
+
+    // solves x A = b by the decomposition above: x P^-1 L U = b, i.e. z U = b, y L = z and
+    // x P^-1 = y, the sweeps are axpy over the rows of U and L
+    template<size_t N, std::floating_point T, class V>
+      constexpr void lu_solve_right(const Tensor<N, T> &A, const size_t (&p)[N], V &x) noexcept
+    {
+      T y[N];
+      for (size_t j = 0; j < N; ++j)
+      {
+        y[j] = x[j] / A[j][j];
+        for (size_t k = j + 1; k < N; ++k)
+          x[k] -= y[j] * A[j][k];
+      }
+      for (size_t j = N; j-- > 0;)
+        for (size_t k = 0; k < j; ++k)
+          y[k] -= y[j] * A[j][k];
+      for (size_t j = 0; j < N; ++j)
+        x[p[j]] = y[j];
+    }
+
+    // X = B A^-1 without the inverse, i.e. ~A ~X = ~B, zero if A is singular as of invert(),
+    // all the rows of X at once by lu_solve() are faster than one by one by lu_solve_right()
+    template<size_t N, std::floating_point T>
+      constexpr Tensor<N, T> lu_divide(const Tensor<N, T> &B, const Tensor<N, T> &A) noexcept
+    {
+      size_t p[N];
+      auto At = ~A;
+      if (lu_decompose(At, p) == 0)
+        return Tensor<N, T>(0);
+      return ~lu_solve(At, p, ~B);
+    }
+
+    template<size_t N, std::floating_point T, class L>
+      constexpr Vector<N, T, true, L> lu_divide(const Vector<N, T, true, L> &b, Tensor<N, T> A) noexcept
+    {
+      size_t p[N];
+      if (lu_decompose(A, p) == 0)
+        return Vector<N, T, true, L>();
+      auto x = b;
+      lu_solve_right(A, p, x);
+      return x;
+    }
+  } // namespace details::impl
+
 /*---------------------------------------------------------------------------------------*/
 
   template<size_t N, Type T> constexpr Tensor<N, T> Tensor<N, T>::invert() const noexcept
@@ -276,12 +567,18 @@ namespace Math
     //    consider using a tolerance-based comparison or std::abs(d) < epsilon
     // 2. silently returns zero tensor on singular matrix, which may cause subtle bugs;
     //    consider throwing an exception or returning std::optional<Tensor>
+    if constexpr (N > 4 && std::floating_point<T>)
+      if (!std::is_constant_evaluated())
+        return details::impl::lu_invert(*this);
+
     T d = det();
-    if (d == static_cast<T>(0))
+    auto singular = (d == static_cast<T>(0));
+    if (details::all(singular))
       return Tensor<N, T>(0); // inverse matrix doesn't exist, return 0
 
+    // lanes of SIMD packs are inverted independently, singular ones give 0 as above
     Tensor<N, T> A;
-    T c = static_cast<T>(1) / d;
+    T c = details::select(singular, static_cast<T>(0), static_cast<T>(1) / d);
     for (size_t i = 0; i < N; ++i)
       for (size_t j = 0; j < N; ++j)
         A[j][i] = ( ((i + j) & 1)? -c : c ) * M(i, j).det();
@@ -289,6 +586,27 @@ namespace Math
     return A;
   }
 
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr Tensor<N, T>& Tensor<N, T>::operator/=(const Tensor<N, T> &A) noexcept
+  {
+    // the same threshold as of invert(), the system is solved without the inverse
+    if constexpr (N > 4 && std::floating_point<T>)
+      return *this = details::impl::lu_divide(*this, A);
+    else
+      return *this *= A.invert();
+  }
+
+  template<size_t N, Type T, class L>
+    constexpr auto& operator/=(Vector<N, T, true, L> &a, const Tensor<N, T> &A) noexcept
+  {
+    if constexpr (N > 4 && std::floating_point<T>)
+      return a = details::impl::lu_divide(a, A);
+    else
+      return a *= A.invert();
+  }
+
 /*---------------------------------------------------------------------------------------*/
 
   template<size_t N, Type T> constexpr Tensor<N, T> Tensor<N, T>::transpose() const noexcept
@@ -318,8 +636,8 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T>
-    constexpr auto& operator*=(Vector<N, T> &a, const Tensor<N, T> &A) noexcept
+  template<size_t N, Type T, class L>
+    constexpr auto& operator*=(Vector<N, T, true, L> &a, const Tensor<N, T> &A) noexcept
   {
     auto b = a;
     for (size_t i = 0; i < N; ++i)
@@ -351,8 +669,9 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T>
-    constexpr auto operator^(const Vector<N, T> &a, const Vector<N, T> &b) noexcept
+  template<size_t N, Type T, class L>
+    constexpr auto operator^(
+      const Vector<N, T, true, L> &a, const Vector<N, T, true, L> &b) noexcept
   {
     Tensor<N, T> t;
     for (size_t i = 0; i < N; ++i)
@@ -363,20 +682,20 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T>
-    constexpr auto operator%(const Tensor<2, T> &A, const Vector<2, T> &a) noexcept
+  template<Type T, class L>
+    constexpr auto operator%(const Tensor<2, T> &A, const Vector<2, T, true, L> &a) noexcept
   {
-    return Vector<2, T>(A[0][0] * a[1] - A[0][1] * a[0],
-                        A[1][0] * a[1] - A[1][1] * a[0]);
+    return Vector<2, T, true, L>(A[0][0] * a[1] - A[0][1] * a[0],
+                                 A[1][0] * a[1] - A[1][1] * a[0]);
   }
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T>
-    constexpr auto operator%(const Vector<2, T> &a, const Tensor<2, T> &A) noexcept
+  template<Type T, class L>
+    constexpr auto operator%(const Vector<2, T, true, L> &a, const Tensor<2, T> &A) noexcept
   {
-    return Vector<2, T>(a[0] * A[1][0] - a[1] * A[0][0],
-                        a[0] * A[1][1] - a[1] * A[0][1]);
+    return Vector<2, T, true, L>(a[0] * A[1][0] - a[1] * A[0][0],
+                                 a[0] * A[1][1] - a[1] * A[0][1]);
   }
 
 /*---------------------------------------------------------------------------------------*/
@@ -394,7 +713,8 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T> constexpr Tensor<3, T> operator~(const Vector<3, T> &a) noexcept
+  template<Type T, class L>
+    constexpr Tensor<3, T> operator~(const Vector<3, T, true, L> &a) noexcept
   {
     return Tensor<3, T>(    0,  -a[2],  a[1],
                          a[2],     0, -a[0],
@@ -403,8 +723,8 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T>
-    constexpr auto operator%(const Tensor<3, T> &A, const Vector<3, T> &a) noexcept
+  template<Type T, class L>
+    constexpr auto operator%(const Tensor<3, T> &A, const Vector<3, T, true, L> &a) noexcept
   {
     Tensor<3, T> R;
     for (size_t i = 0; i < 3; ++i)
@@ -418,8 +738,8 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T>
-    constexpr auto operator%(const Vector<3, T> &a, const Tensor<3, T> &A) noexcept
+  template<Type T, class L>
+    constexpr auto operator%(const Vector<3, T, true, L> &a, const Tensor<3, T> &A) noexcept
   {
     Tensor<3, T> R;
     for (size_t i = 0; i < 3; ++i)
@@ -446,11 +766,16 @@ namespace Math
              data[0][2] * (data[1][0]*data[2][1] - data[1][1]*data[2][0]);
     else // generic case N > 3
     {
+      // O(N^3) in runtime, cofactor expansion (exact for integers) in compile-time and for N = 4,
+      // where it is still faster
+      if constexpr (N > 4 && std::floating_point<T>)
+        if (!std::is_constant_evaluated())
+          return details::impl::lu_det(*this);
+
       T d = 0;
       for (size_t j = 0; j < N; ++j)
-        // coeff: -1 if odd, 1 else,
-        // (j & 1) returns 1 if odd, else 0; x << 1 ~ 2*x
-        d += (1 - ((j & 1) << 1)) * data[0][j] * M(0, j).det();
+        // coeff: -1 if odd, 1 else
+        d += ((j & 1)? -data[0][j] : data[0][j]) * M(0, j).det();
       return d;
     }
   }
@@ -566,6 +891,12 @@ namespace Math::Tensors::tests
   static_assert(t.invert() == T2i(2, -1, -3, 2), "t^-1 failed");
   static_assert(t.invert() * t == E, "t^-1 * t failed");
   static_assert(t * t.invert() == E, "t * t^-1 failed");
+
+  // LU with pivoting, used for N > 4 in runtime
+  constexpr T2d lu(3., 1., 6., 4.);
+  static_assert(details::impl::lu_det(lu) == lu.det(), "LU |t| failed");
+  static_assert(details::impl::lu_invert(lu) * lu == T2d(1.), "LU t^-1 failed");
+  static_assert(details::impl::lu_invert(T2d(1., 2., 2., 4.)) == T2d(0.), "LU singular t^-1 failed");
 } // namespace Math::Tensors::tests
 
 /*---------------------------------------------------------------------------------------*/
@@ -705,6 +1036,8 @@ namespace Math::Tensors::tests
 /*!
   \fn constexpr Tensor& Tensor::operator*=(const Tensor &A) noexcept
   \brief Multiplication assignment by tensor.
+    For N >= 12 and floating point components the product is computed in runtime by 4-row tiles
+    of packed registers, which sweep the panels of columns of A kept in L1 cache.
   \param A Factor, a tensor of the same size (N) and type (T) of the components.
   \return The multiplication of the given tensor and the factor A.
 */
@@ -719,6 +1052,8 @@ namespace Math::Tensors::tests
 /*!
   \fn constexpr T Tensor::det() const noexcept
   \brief Compute the tensor' determinant.
+    For N > 4 and floating point components it is computed in runtime by LU decomposition
+    with partial pivoting in O(N^3), by cofactor expansion otherwise.
   \return Determinant of the given tensor.
 */
 
@@ -731,7 +1066,10 @@ namespace Math::Tensors::tests
 /*!
   \fn constexpr Tensor Tensor::invert() const noexcept
   \brief Get the inverse tensor.
-  \return The inverse tensor to the given one.
+    For N > 4 and floating point components it is computed in runtime by LU decomposition
+    with partial pivoting in O(N^3), by the adjugate (cofactors) otherwise.
+  \return The inverse tensor to the given one, or zero tensor if it is singular
+    (lane by lane for Math::Pack components).
 */
 
 /*!
@@ -803,7 +1141,16 @@ namespace Math::Tensors::tests
   \param A Left term.
   \param B Right term.
   \return true if all components of the left term equals to the corresponding components
-    of the right term, i.e. A[i][j] == B[i][j] for all i,j = 0..(N-1)
+    of the right term, i.e. A[i][j] == B[i][j] for all i,j = 0..(N-1), in all the lanes for Math::Pack components
+*/
+
+/*!
+  \fn constexpr auto equal(const Tensor &A, const Tensor &B) noexcept
+  \brief Component-wise equality comparison which keeps the lanes of SIMD packs apart.
+  \param A Left term.
+  \param B Right term.
+  \return bool for scalar components (same as A == B), or the mask of lanes
+    where all the components are equal for Math::Pack components.
 */
 
 /*!
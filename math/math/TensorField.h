@@ -0,0 +1,265 @@
+#ifndef MATH_TENSOR_FIELD_H_INCLUDED
+#define MATH_TENSOR_FIELD_H_INCLUDED
+
+/*!
+  \file TensorField.h
+  \author gennadiy
+  \brief Structure-of-arrays container of tensors and batched det/inverse kernels, definition,
+    documentation and tests.
+*/
+
+#include "Tensor.h"
+#include "VectorField.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace Math
+{
+  template<size_t N, Type T = double> class TensorField
+  {
+    // component (i, j) of the tensors is the component i*N + j of the vectors
+    VectorField<N*N, T> f;
+
+  public:
+    // traits
+    static constexpr int ncomps = N*N;
+
+    // ctors
+    TensorField() = default;
+    explicit TensorField(size_t size, const Tensor<N, T> &A = Tensor<N, T>());
+
+    // size
+    size_t size() const noexcept { return f.size(); }
+    bool empty() const noexcept { return f.empty(); }
+    void resize(size_t size) { f.resize(size); }
+
+    // access to the components arrays
+    std::span<T> component(size_t i, size_t j) noexcept { assert(i < N && j < N); return f.component(i*N + j); }
+    std::span<const T> component(size_t i, size_t j) const noexcept
+      { assert(i < N && j < N); return f.component(i*N + j); }
+
+    // access to the tensors (NB! returns a copy!)
+    Tensor<N, T> operator[](size_t k) const noexcept;
+
+    void set(size_t k, const Tensor<N, T> &A) noexcept;
+    Tensor<N, T> get(size_t k) const noexcept { return (*this)[k]; }
+  }; // class TensorField<N, T>
+
+/*---------------------------------------------------------------------------------------*/
+
+  // r[k] = A[k].det()
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void det(const TensorField<N, T> &A, std::span<T> r) noexcept;
+
+  // R[k] = A[k].invert(), singular tensors give zero and are marked by 1 in the mask (if it isn't empty),
+  // returns the number of singular tensors, R may coincide with A
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    size_t invert(const TensorField<N, T> &A, TensorField<N, T> &R,
+      std::span<std::uint8_t> singular = {}) noexcept;
+
+  // R[k] = ~A[k].invert(), e.g. for gradients of the shape functions, the rest is as above
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    size_t invert_transpose(const TensorField<N, T> &A, TensorField<N, T> &R,
+      std::span<std::uint8_t> singular = {}) noexcept;
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definition ---------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    TensorField<N, T>::TensorField(size_t size, const Tensor<N, T> &A) : f(size)
+  {
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        std::ranges::fill(component(i, j), A[i][j]);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    Tensor<N, T> TensorField<N, T>::operator[](size_t k) const noexcept
+  {
+    assert(k < size());
+    Tensor<N, T> A;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        A[i][j] = component(i, j)[k];
+    return A;
+  }
+
+  template<size_t N, Type T>
+    void TensorField<N, T>::set(size_t k, const Tensor<N, T> &A) noexcept
+  {
+    assert(k < size());
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        component(i, j)[k] = A[i][j];
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  namespace details::impl
+  {
+    // pointers to the components arrays, row by row
+    template<size_t N, class T, class F> auto component_ptrs(F &A) noexcept
+    {
+      std::array<T*, N*N> p;
+      for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < N; ++j)
+          p[i*N + j] = A.component(i, j).data();
+      return p;
+    }
+
+    // the loop over tensors is vectorized: every tensor is loaded, its cofactors are
+    // computed and scaled by 1/det, and the results are stored, all in registers
+    template<bool Transpose, class T>
+      size_t batch_invert(const TensorField<2, T> &A, TensorField<2, T> &R, std::uint8_t *singular) noexcept
+    {
+      const auto a = component_ptrs<2, const T>(A);
+      const auto r = component_ptrs<2, T>(R);
+      const size_t n = A.size();
+      size_t count = 0;
+      MATH_SIMD_LOOP
+      for (size_t k = 0; k < n; ++k)
+      {
+        const T a00 = a[0][k], a01 = a[1][k], a10 = a[2][k], a11 = a[3][k];
+        const T d = a00*a11 - a01*a10;
+        const bool s = (d == T(0));
+        const T c = s? T(0) : T(1) / d;
+        r[0][k] = c*a11;
+        r[1][k] = -c*(Transpose? a10 : a01);
+        r[2][k] = -c*(Transpose? a01 : a10);
+        r[3][k] = c*a00;
+        if (singular)
+          singular[k] = s;
+        count += s;
+      }
+      return count;
+    }
+
+    template<bool Transpose, class T>
+      size_t batch_invert(const TensorField<3, T> &A, TensorField<3, T> &R, std::uint8_t *singular) noexcept
+    {
+      const auto a = component_ptrs<3, const T>(A);
+      const auto r = component_ptrs<3, T>(R);
+      const size_t n = A.size();
+      size_t count = 0;
+      MATH_SIMD_LOOP
+      for (size_t k = 0; k < n; ++k)
+      {
+        const T a00 = a[0][k], a01 = a[1][k], a02 = a[2][k];
+        const T a10 = a[3][k], a11 = a[4][k], a12 = a[5][k];
+        const T a20 = a[6][k], a21 = a[7][k], a22 = a[8][k];
+
+        // cofactors, the inverse is their transpose over det
+        const T c00 = a11*a22 - a12*a21, c01 = a12*a20 - a10*a22, c02 = a10*a21 - a11*a20;
+        const T c10 = a02*a21 - a01*a22, c11 = a00*a22 - a02*a20, c12 = a01*a20 - a00*a21;
+        const T c20 = a01*a12 - a02*a11, c21 = a02*a10 - a00*a12, c22 = a00*a11 - a01*a10;
+        const T d = a00*c00 + a01*c01 + a02*c02;
+        const bool s = (d == T(0));
+        const T c = s? T(0) : T(1) / d;
+
+        r[0][k] = c*c00;
+        r[1][k] = c*(Transpose? c01 : c10);
+        r[2][k] = c*(Transpose? c02 : c20);
+        r[3][k] = c*(Transpose? c10 : c01);
+        r[4][k] = c*c11;
+        r[5][k] = c*(Transpose? c12 : c21);
+        r[6][k] = c*(Transpose? c20 : c02);
+        r[7][k] = c*(Transpose? c21 : c12);
+        r[8][k] = c*c22;
+        if (singular)
+          singular[k] = s;
+        count += s;
+      }
+      return count;
+    }
+  } // namespace details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    void det(const TensorField<N, T> &A, std::span<T> r) noexcept
+  {
+    assert(r.size() == A.size());
+    const auto a = details::impl::component_ptrs<N, const T>(A);
+    T *pr = r.data();
+    const size_t n = r.size();
+    if constexpr (N == 2)
+    {
+      MATH_SIMD_LOOP
+      for (size_t k = 0; k < n; ++k)
+        pr[k] = a[0][k]*a[3][k] - a[1][k]*a[2][k];
+    }
+    else
+    {
+      MATH_SIMD_LOOP
+      for (size_t k = 0; k < n; ++k)
+        pr[k] = a[0][k] * (a[4][k]*a[8][k] - a[5][k]*a[7][k]) +
+                a[1][k] * (a[5][k]*a[6][k] - a[3][k]*a[8][k]) +
+                a[2][k] * (a[3][k]*a[7][k] - a[4][k]*a[6][k]);
+    }
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    size_t invert(const TensorField<N, T> &A, TensorField<N, T> &R, std::span<std::uint8_t> singular) noexcept
+  {
+    assert(R.size() == A.size() && (singular.empty() || singular.size() == A.size()));
+    return details::impl::batch_invert<false>(A, R, singular.data());
+  }
+
+  template<size_t N, std::floating_point T> requires (N == 2 || N == 3)
+    size_t invert_transpose(const TensorField<N, T> &A, TensorField<N, T> &R,
+      std::span<std::uint8_t> singular) noexcept
+  {
+    assert(R.size() == A.size() && (singular.empty() || singular.size() == A.size()));
+    return details::impl::batch_invert<true>(A, R, singular.data());
+  }
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::TensorFields::tests
+{
+  static_assert(TensorField<3>::ncomps == 9);
+  static_assert(std::is_same_v<decltype(std::declval<const TensorField<2>&>()[0]), Tensor2D>);
+} // namespace Math::TensorFields::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::TensorField
+  \brief Container of tensors with structure-of-arrays layout.
+  \tparam N Dimension of the tensors.
+  \tparam T Type of the components.
+
+  Each of N*N components is stored in its own aligned array (it's a Math::VectorField
+  of N*N components), thus the batched kernels process simd::lanes<T> tensors at once,
+  e.g. all Jacobians of the quadrature points of a mesh:
+  \code
+  TensorField<3> J(npoints), invJT(npoints);
+  std::vector<std::uint8_t> degenerate(npoints);
+  ... J.set(q, jacobian(q)) ...
+  if (invert_transpose(J, invJT, degenerate) != 0)
+    report(degenerate);
+  \endcode
+*/
+
+/*!
+  \fn size_t invert(const TensorField &A, TensorField &R, std::span<std::uint8_t> singular) noexcept
+  \brief Batched inverse of 2x2 or 3x3 tensors by cofactors, R[k] = A[k].invert().
+  \param A Tensors to invert.
+  \param R Results, must have the same size as A, may be A itself.
+  \param singular Empty or mask of the size of A, singular[k] = 1 if det A[k] == 0, 0 otherwise.
+  \return Number of the singular tensors, their inverses are zero tensors as of Tensor::invert.
+*/
+
+#endif // MATH_TENSOR_FIELD_H_INCLUDED
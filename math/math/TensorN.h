@@ -0,0 +1,801 @@
+#ifndef MATH_TENSOR_N_H_INCLUDED
+#define MATH_TENSOR_N_H_INCLUDED
+
+/*!
+  \file TensorN.h
+  \author gennadiy
+  \brief Vector and tensor of rank 2 of runtime dimension with storage from a memory resource,
+    definition, documentation and tests.
+*/
+
+#include "Tensor.h"
+#include <algorithm>
+#include <concepts>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace Math
+{
+  namespace details::impl
+  {
+    // n values from a memory resource, copies are allocated from the resource of the source
+    template<class U> class ArenaArray
+    {
+      static_assert(std::is_trivially_copyable_v<U>, "Values are copied as bytes.");
+
+      std::pmr::memory_resource *mr;
+      U *p = nullptr;
+      size_t n = 0;
+
+      // uninitialized values, reallocates if the size differs only
+      void reallocate(size_t size);
+
+    public:
+      explicit ArenaArray(std::pmr::memory_resource *r) noexcept : mr(r) { assert(r); }
+      // zeros
+      ArenaArray(size_t size, std::pmr::memory_resource *r) : ArenaArray(r)
+        { reallocate(size); std::fill_n(p, n, U(0)); }
+      ArenaArray(const ArenaArray &a, std::pmr::memory_resource *r) : ArenaArray(r)
+        { reallocate(a.n); std::copy_n(a.p, n, p); }
+      ArenaArray(const ArenaArray &a) : ArenaArray(a, a.mr) {}
+      ArenaArray(ArenaArray &&a) noexcept
+        : mr(a.mr), p(std::exchange(a.p, nullptr)), n(std::exchange(a.n, 0)) {}
+      ~ArenaArray() { reallocate(0); }
+
+      // the resource is kept, the values of the other resources are copied, not moved
+      ArenaArray& operator=(const ArenaArray &a);
+      ArenaArray& operator=(ArenaArray &&a);
+
+      U* data() noexcept { return p; }
+      const U* data() const noexcept { return p; }
+      size_t size() const noexcept { return n; }
+      std::pmr::memory_resource* resource() const noexcept { return mr; }
+    }; // class ArenaArray<U>
+  } // namespace details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T = double> class VectorN
+  {
+    details::impl::ArenaArray<T> data;
+
+  public:
+    auto* begin() noexcept { return data.data(); }
+    auto* end() noexcept { return begin() + size(); }
+    const auto* begin() const noexcept { return data.data(); }
+    const auto* end() const noexcept { return begin() + size(); }
+
+    // ctors, copies are allocated from the resource of the source
+    explicit VectorN(std::pmr::memory_resource *mr = std::pmr::get_default_resource()) noexcept : data(mr) {}
+    explicit VectorN(size_t n, std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : data(n, mr) {}
+    // a template, so that literal 0 matches it better than the null resource
+    template<class A> requires std::is_arithmetic_v<A>
+      VectorN(size_t n, A a, std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+    VectorN(const VectorN &v, std::pmr::memory_resource *mr) : data(v.data, mr) {}
+
+    // converters
+    template<size_t N, class L>
+      explicit VectorN(const Vector<N, T, true, L> &v,
+                       std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+    // size
+    size_t size() const noexcept { return data.size(); }
+    bool empty() const noexcept { return size() == 0; }
+    std::pmr::memory_resource* resource() const noexcept { return data.resource(); }
+
+    // access
+    T& operator[](size_t i) noexcept { assert(i < size()); return begin()[i]; }
+    const T& operator[](size_t i) const noexcept { assert(i < size()); return begin()[i]; }
+
+    // the same storage as a vector of the compile-time dimension, size() must be N
+    template<size_t N> Vector<N, T>& view() & noexcept;
+    template<size_t N> const Vector<N, T>& view() const & noexcept;
+
+    // unary ops (NB! returns a copy!)
+    VectorN operator+() const { return *this; }
+    VectorN operator-() const;
+
+    // assign-ops
+    VectorN& operator/=(const T &a) noexcept;
+    VectorN& operator*=(const T &a) noexcept;
+    VectorN& operator+=(const VectorN &v) noexcept;
+    VectorN& operator-=(const VectorN &v) noexcept;
+
+    // comparison ops, vectors of different sizes aren't equal
+    bool operator==(const VectorN &v) const noexcept;
+  }; // class VectorN<T>
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T = double> class TensorN
+  {
+    details::impl::ArenaArray<T> data; // row by row
+    size_t n = 0;
+
+  public:
+    auto* begin() noexcept { return data.data(); }
+    auto* end() noexcept { return begin() + data.size(); }
+    const auto* begin() const noexcept { return data.data(); }
+    const auto* end() const noexcept { return begin() + data.size(); }
+
+    // ctors, copies are allocated from the resource of the source
+    explicit TensorN(std::pmr::memory_resource *mr = std::pmr::get_default_resource()) noexcept : data(mr) {}
+    explicit TensorN(size_t n, std::pmr::memory_resource *mr = std::pmr::get_default_resource())
+      : data(n*n, mr), n(n) {}
+    // a * I as of Tensor(a), a template, so that literal 0 matches it better than the null resource
+    template<class A> requires std::is_arithmetic_v<A>
+      TensorN(size_t n, A a, std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+    TensorN(const TensorN &A, std::pmr::memory_resource *mr) : data(A.data, mr), n(A.n) {}
+    TensorN(const TensorN &A) = default;
+    TensorN(TensorN &&A) noexcept : data(std::move(A.data)), n(std::exchange(A.n, 0)) {}
+    TensorN& operator=(const TensorN &A) = default;
+    TensorN& operator=(TensorN &&A);
+
+    // converters
+    template<size_t N>
+      explicit TensorN(const Tensor<N, T> &A, std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+    // size, i.e. the dimension
+    size_t size() const noexcept { return n; }
+    bool empty() const noexcept { return n == 0; }
+    std::pmr::memory_resource* resource() const noexcept { return data.resource(); }
+
+    // access
+    T* operator[](size_t i) && noexcept = delete;
+    T* operator[](size_t i) & noexcept { assert(i < n); return begin() + i*n; }
+    const T* operator[](size_t i) const & noexcept { assert(i < n); return begin() + i*n; }
+
+    // the same storage as a tensor of the compile-time dimension, size() must be N
+    template<size_t N> Tensor<N, T>& view() & noexcept;
+    template<size_t N> const Tensor<N, T>& view() const & noexcept;
+
+    // unary ops (NB! returns a copy!)
+    TensorN operator-() const;
+    TensorN operator+() const { return *this; }
+    TensorN operator~() const { return transpose(); }
+
+    // assign with op, the temporaries are allocated from the resource of this tensor
+    TensorN& operator*=(const T &a) noexcept;
+    TensorN& operator/=(const T &a) noexcept;
+    TensorN& operator+=(const TensorN &A) noexcept;
+    TensorN& operator-=(const TensorN &A) noexcept;
+    TensorN& operator*=(const TensorN &A);
+    TensorN& operator/=(const TensorN &A);
+
+    // comparison ops, tensors of different sizes aren't equal
+    bool operator==(const TensorN &A) const noexcept;
+
+    // other useful ops, det(), invert() and divisions are by LU decomposition with partial pivoting
+    T det() const;
+    T trace() const noexcept;
+    TensorN invert() const;
+    TensorN transpose() const;
+  }; // class TensorN<T>
+
+/*---------------------------------------------------------------------------------------*/
+
+  // arithmetic ops, the results are allocated from the resource of the left operand
+  template<std::floating_point T>
+    auto operator+(VectorN<T> v1, const VectorN<T> &v2) { v1 += v2; return v1; }
+
+  template<std::floating_point T>
+    auto operator-(VectorN<T> v1, const VectorN<T> &v2) { v1 -= v2; return v1; }
+
+  template<std::floating_point T>
+    auto operator*(const T &a, VectorN<T> v) { v *= a; return v; }
+
+  template<std::floating_point T>
+    auto operator*(VectorN<T> v, const T &a) { v *= a; return v; }
+
+  template<std::floating_point T>
+    auto operator/(VectorN<T> v, const T &a) { v /= a; return v; }
+
+  template<std::floating_point T>
+    auto operator+(TensorN<T> A, const TensorN<T> &B) { A += B; return A; }
+
+  template<std::floating_point T>
+    auto operator-(TensorN<T> A, const TensorN<T> &B) { A -= B; return A; }
+
+  template<std::floating_point T>
+    auto operator*(TensorN<T> A, const TensorN<T> &B) { A *= B; return A; }
+
+  template<std::floating_point T>
+    auto operator*(TensorN<T> A, const T &a) { A *= a; return A; }
+
+  template<std::floating_point T>
+    auto operator*(const T &a, TensorN<T> A) { A *= a; return A; }
+
+  template<std::floating_point T>
+    auto operator/(TensorN<T> A, const T &a) { A /= a; return A; }
+
+  template<std::floating_point T>
+    auto operator/(TensorN<T> A, const TensorN<T> &B) { A /= B; return A; }
+
+  // io ops, the sizes must be set before reading
+  template<std::floating_point T>
+    std::istream& operator>>(std::istream &in, VectorN<T> &v);
+
+  template<std::floating_point T>
+    std::ostream& operator<<(std::ostream &out, const VectorN<T> &v);
+
+  template<std::floating_point T>
+    std::istream& operator>>(std::istream &in, TensorN<T> &A);
+
+  template<std::floating_point T>
+    std::ostream& operator<<(std::ostream &out, const TensorN<T> &A);
+
+  // useful functions of vectors
+  template<std::floating_point T>
+    T operator*(const VectorN<T> &v1, const VectorN<T> &v2) noexcept;
+
+  template<std::floating_point T>
+    T sqs(const VectorN<T> &v) noexcept { return v*v; }
+
+  template<std::floating_point T>
+    T fabs(const VectorN<T> &v) noexcept { return details::sqrt(v*v); }
+
+  template<std::floating_point T>
+    VectorN<T> normalize(const VectorN<T> &v) { return v / fabs(v); }
+
+  // ops with vectors, a A, A a, a A^-1 and the outer product
+  template<std::floating_point T>
+    VectorN<T>& operator*=(VectorN<T> &a, const TensorN<T> &A);
+
+  template<std::floating_point T>
+    auto operator*(VectorN<T> a, const TensorN<T> &A) { a *= A; return a; }
+
+  template<std::floating_point T>
+    VectorN<T> operator*(const TensorN<T> &A, const VectorN<T> &a);
+
+  template<std::floating_point T>
+    VectorN<T>& operator/=(VectorN<T> &a, const TensorN<T> &A);
+
+  template<std::floating_point T>
+    auto operator/(VectorN<T> a, const TensorN<T> &A) { a /= A; return a; }
+
+  template<std::floating_point T>
+    TensorN<T> operator^(const VectorN<T> &a, const VectorN<T> &b);
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definition ---------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+  namespace details::impl
+  {
+    template<class U> void ArenaArray<U>::reallocate(size_t size)
+    {
+      if (size == n)
+        return;
+      if (p)
+        mr->deallocate(p, n*sizeof(U), alignof(U));
+      p = nullptr;
+      n = 0;
+      if (size)
+        p = static_cast<U*>(mr->allocate(size*sizeof(U), alignof(U)));
+      n = size;
+    }
+
+    template<class U> ArenaArray<U>& ArenaArray<U>::operator=(const ArenaArray &a)
+    {
+      if (this != &a)
+      {
+        reallocate(a.n);
+        std::copy_n(a.p, n, p);
+      }
+      return *this;
+    }
+
+    template<class U> ArenaArray<U>& ArenaArray<U>::operator=(ArenaArray &&a)
+    {
+      if (this != &a && (mr == a.mr || mr->is_equal(*a.mr)))
+      {
+        reallocate(0);
+        p = std::exchange(a.p, nullptr);
+        n = std::exchange(a.n, 0);
+        return *this;
+      }
+      return *this = a;
+    }
+
+/*---------------------------------------------------------------------------------------*/
+
+    // runtime dimension versions of lu_decompose() and lu_solve() of Tensor.h,
+    // A is n x n row by row, returns the sign of P or 0 if A is singular
+    template<std::floating_point T> int lu_decompose(T *A, size_t n, size_t *p) noexcept
+    {
+      int sign = 1;
+      for (size_t i = 0; i < n; ++i)
+        p[i] = i;
+
+      for (size_t k = 0; k < n; ++k)
+      {
+        size_t m = k;
+        T amax = (A[k*n + k] < 0)? -A[k*n + k] : A[k*n + k];
+        for (size_t i = k + 1; i < n; ++i)
+        {
+          T a = (A[i*n + k] < 0)? -A[i*n + k] : A[i*n + k];
+          if (amax < a)
+          {
+            amax = a;
+            m = i;
+          }
+        }
+        if (amax == 0)
+          return 0;
+        if (m != k)
+        {
+          std::swap_ranges(A + k*n, A + (k + 1)*n, A + m*n);
+          std::swap(p[k], p[m]);
+          sign = -sign;
+        }
+
+        const T r = T(1) / A[k*n + k];
+        for (size_t i = k + 1; i < n; ++i)
+        {
+          const T l = A[i*n + k] *= r;
+          for (size_t j = k + 1; j < n; ++j)
+            A[i*n + j] -= l * A[k*n + j];
+        }
+      }
+      return sign;
+    }
+
+    // X = A^-1 B by the decomposition above, B and X are n x m row by row, all the columns
+    // of X at once by row operations
+    template<std::floating_point T>
+      void lu_solve(const T *A, size_t n, const size_t *p, const T *B, T *X, size_t m) noexcept
+    {
+      for (size_t i = 0; i < n; ++i)
+        std::copy_n(B + p[i]*m, m, X + i*m);
+      // L Y = P B
+      for (size_t i = 1; i < n; ++i)
+        for (size_t k = 0; k < i; ++k)
+        {
+          const T l = A[i*n + k];
+          for (size_t j = 0; j < m; ++j)
+            X[i*m + j] -= l * X[k*m + j];
+        }
+      // U X = Y
+      for (size_t i = n; i-- > 0;)
+      {
+        for (size_t k = i + 1; k < n; ++k)
+        {
+          const T u = A[i*n + k];
+          for (size_t j = 0; j < m; ++j)
+            X[i*m + j] -= u * X[k*m + j];
+        }
+        const T r = T(1) / A[i*n + i];
+        for (size_t j = 0; j < m; ++j)
+          X[i*m + j] *= r;
+      }
+    }
+  } // namespace details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> template<class A> requires std::is_arithmetic_v<A>
+    VectorN<T>::VectorN(size_t n, A a, std::pmr::memory_resource *mr) : data(n, mr)
+  {
+    std::fill(begin(), end(), static_cast<T>(a));
+  }
+
+  template<std::floating_point T> template<size_t N, class L>
+    VectorN<T>::VectorN(const Vector<N, T, true, L> &v, std::pmr::memory_resource *mr) : data(N, mr)
+  {
+    for (size_t i = 0; i < N; ++i)
+      (*this)[i] = v[i];
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> template<size_t N> Vector<N, T>& VectorN<T>::view() & noexcept
+  {
+    static_assert(sizeof(Vector<N, T>) == N*sizeof(T) && alignof(Vector<N, T>) == alignof(T));
+    assert(size() == N);
+    return *reinterpret_cast<Vector<N, T>*>(begin());
+  }
+
+  template<std::floating_point T> template<size_t N>
+    const Vector<N, T>& VectorN<T>::view() const & noexcept
+  {
+    static_assert(sizeof(Vector<N, T>) == N*sizeof(T) && alignof(Vector<N, T>) == alignof(T));
+    assert(size() == N);
+    return *reinterpret_cast<const Vector<N, T>*>(begin());
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> VectorN<T> VectorN<T>::operator-() const
+  {
+    VectorN v(*this);
+    for (auto &x : v)
+      x = -x;
+    return v;
+  }
+
+  template<std::floating_point T> VectorN<T>& VectorN<T>::operator/=(const T &a) noexcept
+  {
+    for (auto &x : *this)
+      x /= a;
+    return *this;
+  }
+
+  template<std::floating_point T> VectorN<T>& VectorN<T>::operator*=(const T &a) noexcept
+  {
+    for (auto &x : *this)
+      x *= a;
+    return *this;
+  }
+
+  template<std::floating_point T> VectorN<T>& VectorN<T>::operator+=(const VectorN &v) noexcept
+  {
+    assert(size() == v.size());
+    for (size_t i = 0; i < size(); ++i)
+      begin()[i] += v.begin()[i];
+    return *this;
+  }
+
+  template<std::floating_point T> VectorN<T>& VectorN<T>::operator-=(const VectorN &v) noexcept
+  {
+    assert(size() == v.size());
+    for (size_t i = 0; i < size(); ++i)
+      begin()[i] -= v.begin()[i];
+    return *this;
+  }
+
+  template<std::floating_point T> bool VectorN<T>::operator==(const VectorN &v) const noexcept
+  {
+    return std::ranges::equal(*this, v);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> template<class A> requires std::is_arithmetic_v<A>
+    TensorN<T>::TensorN(size_t n, A a, std::pmr::memory_resource *mr) : TensorN(n, mr)
+  {
+    for (size_t i = 0; i < n; ++i)
+      (*this)[i][i] = static_cast<T>(a);
+  }
+
+  template<std::floating_point T> template<size_t N>
+    TensorN<T>::TensorN(const Tensor<N, T> &A, std::pmr::memory_resource *mr) : TensorN(N, mr)
+  {
+    std::copy(A.begin(), A.end(), begin());
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> template<size_t N> Tensor<N, T>& TensorN<T>::view() & noexcept
+  {
+    static_assert(sizeof(Tensor<N, T>) == N*N*sizeof(T) && alignof(Tensor<N, T>) == alignof(T));
+    assert(n == N);
+    return *reinterpret_cast<Tensor<N, T>*>(begin());
+  }
+
+  template<std::floating_point T> template<size_t N>
+    const Tensor<N, T>& TensorN<T>::view() const & noexcept
+  {
+    static_assert(sizeof(Tensor<N, T>) == N*N*sizeof(T) && alignof(Tensor<N, T>) == alignof(T));
+    assert(n == N);
+    return *reinterpret_cast<const Tensor<N, T>*>(begin());
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> TensorN<T> TensorN<T>::operator-() const
+  {
+    TensorN A(*this);
+    for (auto &x : A)
+      x = -x;
+    return A;
+  }
+
+  template<std::floating_point T> TensorN<T>& TensorN<T>::operator*=(const T &a) noexcept
+  {
+    for (auto &x : *this)
+      x *= a;
+    return *this;
+  }
+
+  template<std::floating_point T> TensorN<T>& TensorN<T>::operator/=(const T &a) noexcept
+  {
+    for (auto &x : *this)
+      x /= a;
+    return *this;
+  }
+
+  template<std::floating_point T> TensorN<T>& TensorN<T>::operator+=(const TensorN &A) noexcept
+  {
+    assert(n == A.n);
+    for (size_t i = 0; i < n*n; ++i)
+      begin()[i] += A.begin()[i];
+    return *this;
+  }
+
+  template<std::floating_point T> TensorN<T>& TensorN<T>::operator-=(const TensorN &A) noexcept
+  {
+    assert(n == A.n);
+    for (size_t i = 0; i < n*n; ++i)
+      begin()[i] -= A.begin()[i];
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> TensorN<T>& TensorN<T>::operator*=(const TensorN &A)
+  {
+    assert(n == A.n);
+    // rows of the result are linear combinations of the rows of A, i.e. contiguous loops
+    TensorN C(n, resource());
+    for (size_t i = 0; i < n; ++i)
+    {
+      T *c = C[i];
+      for (size_t k = 0; k < n; ++k)
+      {
+        const T a = (*this)[i][k];
+        const T *b = A[k];
+        for (size_t j = 0; j < n; ++j)
+          c[j] += a * b[j];
+      }
+    }
+    return *this = std::move(C);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+
+  template<std::floating_point T> TensorN<T>& TensorN<T>::operator=(TensorN &&A)
+  {
+    data = std::move(A.data);
+    n = A.n;
+    // the storage of the other resources is copied, not moved
+    if (A.data.size() == 0)
+      A.n = 0;
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> TensorN<T>& TensorN<T>::operator/=(const TensorN &A)
+  {
+    assert(n == A.n);
+    // X = B A^-1 without the inverse, i.e. ~A ~X = ~B as of Tensor, zero if A is singular
+    TensorN At(n, resource()), Bt(n, resource());
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+      {
+        At[j][i] = A[i][j];
+        Bt[j][i] = (*this)[i][j];
+      }
+    details::impl::ArenaArray<size_t> p(n, resource());
+    if (details::impl::lu_decompose(At.begin(), n, p.data()) == 0)
+    {
+      std::fill(begin(), end(), T(0));
+      return *this;
+    }
+    TensorN Xt(n, resource());
+    details::impl::lu_solve(At.begin(), n, p.data(), Bt.begin(), Xt.begin(), n);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        (*this)[i][j] = Xt[j][i];
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> bool TensorN<T>::operator==(const TensorN &A) const noexcept
+  {
+    return n == A.n && std::ranges::equal(*this, A);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> T TensorN<T>::det() const
+  {
+    TensorN A(*this);
+    details::impl::ArenaArray<size_t> p(n, resource());
+    T d = details::impl::lu_decompose(A.begin(), n, p.data());
+    for (size_t k = 0; k < n && d != 0; ++k)
+      d *= A[k][k];
+    return d;
+  }
+
+  template<std::floating_point T> T TensorN<T>::trace() const noexcept
+  {
+    T tr = 0;
+    for (size_t i = 0; i < n; ++i)
+      tr += (*this)[i][i];
+    return tr;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T> TensorN<T> TensorN<T>::invert() const
+  {
+    TensorN A(*this), X(n, resource());
+    details::impl::ArenaArray<size_t> p(n, resource());
+    if (details::impl::lu_decompose(A.begin(), n, p.data()) == 0)
+      return X; // inverse matrix doesn't exist, return 0
+    const TensorN E(n, T(1), resource());
+    details::impl::lu_solve(A.begin(), n, p.data(), E.begin(), X.begin(), n);
+    return X;
+  }
+
+  template<std::floating_point T> TensorN<T> TensorN<T>::transpose() const
+  {
+    TensorN A(n, resource());
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        A[i][j] = (*this)[j][i];
+    return A;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T>
+    std::istream& operator>>(std::istream &in, VectorN<T> &v)
+  {
+    IO::read_values(in, v, '(', ')');
+    return in;
+  }
+
+  template<std::floating_point T>
+    std::ostream& operator<<(std::ostream &out, const VectorN<T> &v)
+  {
+    IO::write_values(out, v, '(', ')');
+    return out;
+  }
+
+  template<std::floating_point T>
+    std::istream& operator>>(std::istream &in, TensorN<T> &A)
+  {
+    IO::read_values(in, A, '[', ']');
+    return in;
+  }
+
+  template<std::floating_point T>
+    std::ostream& operator<<(std::ostream &out, const TensorN<T> &A)
+  {
+    IO::write_values(out, A, '[', ']');
+    return out;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T>
+    T operator*(const VectorN<T> &v1, const VectorN<T> &v2) noexcept
+  {
+    assert(v1.size() == v2.size());
+    T s = 0;
+    for (size_t i = 0; i < v1.size(); ++i)
+      s += v1[i] * v2[i];
+    return s;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T>
+    VectorN<T>& operator*=(VectorN<T> &a, const TensorN<T> &A)
+  {
+    assert(a.size() == A.size());
+    // linear combination of the rows of A
+    VectorN<T> r(a.size(), a.resource());
+    for (size_t i = 0; i < A.size(); ++i)
+    {
+      const T *row = A[i];
+      for (size_t j = 0; j < A.size(); ++j)
+        r[j] += a[i] * row[j];
+    }
+    return a = std::move(r);
+  }
+
+  template<std::floating_point T>
+    VectorN<T> operator*(const TensorN<T> &A, const VectorN<T> &a)
+  {
+    assert(a.size() == A.size());
+    VectorN<T> r(a.size(), a.resource());
+    for (size_t i = 0; i < A.size(); ++i)
+    {
+      const T *row = A[i];
+      T s = 0;
+      for (size_t j = 0; j < A.size(); ++j)
+        s += row[j] * a[j];
+      r[i] = s;
+    }
+    return r;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<std::floating_point T>
+    VectorN<T>& operator/=(VectorN<T> &a, const TensorN<T> &A)
+  {
+    assert(a.size() == A.size());
+    // x A = b, i.e. ~A x = b, zero if A is singular as of Tensor
+    const size_t n = A.size();
+    TensorN<T> At(n, a.resource());
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        At[j][i] = A[i][j];
+    details::impl::ArenaArray<size_t> p(n, a.resource());
+    if (details::impl::lu_decompose(At.begin(), n, p.data()) == 0)
+      return a *= T(0);
+    VectorN<T> x(n, a.resource());
+    details::impl::lu_solve(At.begin(), n, p.data(), a.begin(), x.begin(), 1);
+    return a = std::move(x);
+  }
+
+  template<std::floating_point T>
+    TensorN<T> operator^(const VectorN<T> &a, const VectorN<T> &b)
+  {
+    assert(a.size() == b.size());
+    TensorN<T> A(a.size(), a.resource());
+    for (size_t i = 0; i < a.size(); ++i)
+      for (size_t j = 0; j < b.size(); ++j)
+        A[i][j] = a[i] * b[j];
+    return A;
+  }
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::TensorNs::tests
+{
+  // no allocations are constexpr, the rest is in tests/tst_tensor_n.cpp
+  static_assert(std::is_nothrow_move_constructible_v<TensorN<>>);
+  static_assert(std::is_nothrow_move_constructible_v<VectorN<>>);
+  static_assert(std::is_same_v<decltype(std::declval<TensorN<>&>().view<3>()), Tensor3D&>);
+  static_assert(std::is_same_v<decltype(std::declval<const VectorN<float>&>().view<2>()),
+                               const Vector<2, float>&>);
+  static_assert(std::is_same_v<decltype(std::declval<TensorN<>>() * std::declval<VectorN<>>()), VectorN<>>);
+} // namespace Math::TensorNs::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::TensorN
+  \brief Tensor of rank 2 of runtime dimension, e.g. the blocks of coupled systems of
+    the number of species plus equations given by the input.
+  \tparam T Type of the components.
+
+  The operators are the same as of Math::Tensor, det(), invert() and division are by LU
+  decomposition with partial pivoting, singular tensors give zero as of Tensor::invert.
+  The components are stored row by row in a single buffer from std::pmr::memory_resource,
+  operator new by default. Copies and the results of the operators are allocated from the
+  resource of the source (the left operand), thus all the temporaries of the cells are in
+  the arena of the caller and are freed at once:
+  \code
+  std::byte buffer[1 << 16];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+  for (size_t c = 0; c < ncells; ++c)
+  {
+    TensorN<> A(n, &arena);
+    VectorN<> b(n, &arena);
+    assemble(c, A, b);
+    x[c] = b / ~A;       // no malloc unless the buffer is exhausted
+    arena.release();
+  }
+  \endcode
+  The objects must not outlive their resource. If the dimension is known at compile time,
+  view<N>() is the same storage as Tensor<N, T>, e.g. for the 2D and 3D kernels.
+*/
+
+/*!
+  \class Math::VectorN
+  \brief Vector of runtime dimension, the counterpart of Math::TensorN.
+  \tparam T Type of the components.
+*/
+
+/*!
+  \fn template<size_t N> Tensor<N, T>& Math::TensorN::view() & noexcept
+  \brief Reference to the components as a tensor of compile-time dimension.
+  \tparam N Dimension, must be equal to size().
+*/
+
+#endif // MATH_TENSOR_N_H_INCLUDED
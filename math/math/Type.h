@@ -9,9 +9,17 @@
 
 #include <concepts>
 #include <type_traits>
+#include <utility>
 
 namespace Math
 {
+  template<class M>
+  concept Mask = std::convertible_to<M, bool>
+    || requires(const M &m) {
+      { all_of(m) } -> std::convertible_to<bool>;
+      { any_of(m) } -> std::convertible_to<bool>;
+    };
+
   template<class T>
   concept Type = std::is_default_constructible_v<T>
     && std::is_copy_constructible_v<T>
@@ -20,21 +28,33 @@ namespace Math
       { a -= b } -> std::convertible_to<T&>;
       { a *= b } -> std::convertible_to<T&>;
       { a /= b } -> std::convertible_to<T&>;
-      { a == b } -> std::convertible_to<bool>;
+      { a == b } -> Mask;
     };
+
+  template<class T>
+  concept Pack = Type<T> && !std::convertible_to<decltype(std::declval<T>() == std::declval<T>()), bool>;
 } // namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 /*------------------------------------ documentation ------------------------------------*/
 /*---------------------------------------------------------------------------------------*/
 
+/*!
+  \interface Math::Mask
+  \brief Result of a comparison: either \c bool or a mask of SIMD lanes.
+
+  A mask is a type for which \c all_of and \c any_of are found by argument-dependent lookup,
+  e.g. \c std::experimental::simd_mask. Use Math::details::all, Math::details::any
+  and Math::details::select to handle both kinds uniformly.
+*/
+
 /*!
   \interface Math::Type
   \brief Constrains types eligible for use in numerical computations.
 
   A type satisfies \c Type if it is default-constructible, copy-constructible,
   and supports compound arithmetic assignment operators (\c +=, \c -=, \c *=, \c /=)
-  as well as equality comparison (\c ==).
+  as well as equality comparison (\c ==) which gives a Math::Mask.
   This is intentionally broader than \c std::is_arithmetic: user-defined types
   such as vectors, tensors, or any other numeric-like type that implements
   these operators will satisfy the concept automatically.
@@ -43,5 +63,15 @@ namespace Math
   \see Quantities::State
 */
 
+/*!
+  \interface Math::Pack
+  \brief SIMD pack of lanes, i.e. a Math::Type whose comparison gives a mask of lanes.
+
+  Vectors and tensors of packs, e.g. \c Vector<3, std::experimental::native_simd<double>>,
+  process several independent vectors or tensors at once (one per lane) by the same code
+  as scalar ones: arithmetic, dot and cross products, \c det() and \c invert() work lanewise,
+  while \c == compares all the lanes and \c Math::equal gives the mask of equal lanes.
+*/
+
 #endif // MATH_TYPE_H_INCLUDED
 
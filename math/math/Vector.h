@@ -9,20 +9,51 @@
 
 #include "Type.h"
 #include "details.h"
+#include "simd.h"
 #include "common/IOMode.h"
+#include <algorithm>
+#include <bit>
 #include <cassert>
 
 namespace Math
 {
-  template<size_t N, Type T = double, bool is_euclidian = true> class Vector
+  // memory layouts of the vector's components
+  namespace Layout
   {
-    T data[N] = {};
+    // components are stored one by one w/o any gaps
+    struct Packed
+    {
+      template<size_t N, class T> static constexpr size_t size = N;
+      template<size_t N, class T> static constexpr size_t alignment = alignof(T);
+    };
+
+    // storage is padded with zeros up to the power of 2 components (e.g. 3 -> 4)
+    // and aligned to its size if it fits a SIMD register
+    struct Padded
+    {
+      template<size_t N, class T> static constexpr size_t size = std::bit_ceil(N);
+      template<size_t N, class T> static constexpr size_t alignment =
+        (std::has_single_bit(size<N, T> * sizeof(T)) && size<N, T> * sizeof(T) <= simd::alignment)?
+          std::max(size<N, T> * sizeof(T), alignof(T)) : alignof(T);
+    };
+  } // namespace Layout
+
+  template<size_t N, Type T = double, bool is_euclidian = true, class layout_policy = Layout::Packed>
+    class Vector
+  {
+  public:
+    // traits
+    using layout = layout_policy;
+    static constexpr int ncomps = N;
+    static constexpr size_t nlanes = layout::template size<N, T>; // incl. padding
+
+  private:
+    alignas(layout::template alignment<N, T>) T data[nlanes] = {};
     static_assert(N != 0, "Vector of zero size is meaningless.");
+    static_assert(nlanes >= N, "Layout must provide storage for all components.");
     static_assert(std::is_default_constructible_v<T>, "Components must be default constructible");
 
   public:
-    // traits
-    static constexpr int ncomps = N;
 
     constexpr auto* begin() noexcept { return data; }
     constexpr auto* end() noexcept { return data + ncomps; }
@@ -36,10 +67,10 @@ namespace Math
       constexpr explicit Vector(Ts... as) noexcept : data{static_cast<T>(as)...} {}
 
     // converters
-    template<Type U>
-      constexpr explicit Vector(const Vector<N, U, is_euclidian> &v) noexcept;
-    template<Type U>
-      constexpr Vector& operator=(const Vector<N, U, is_euclidian> &v) noexcept;
+    template<Type U, class L>
+      constexpr explicit Vector(const Vector<N, U, is_euclidian, L> &v) noexcept;
+    template<Type U, class L>
+      constexpr Vector& operator=(const Vector<N, U, is_euclidian, L> &v) noexcept;
 
     // access
     static constexpr size_t X = 0;
@@ -60,13 +91,17 @@ namespace Math
     constexpr Vector& operator+=(const Vector &v) noexcept;
     constexpr Vector& operator-=(const Vector &v) noexcept;
 
-    // comparison ops
-    constexpr bool operator==(const Vector &) const noexcept = default;
-  }; // class Vector<N, T, is_euclidian>
+    // comparison ops, all the lanes of SIMD packs must be equal
+    constexpr bool operator==(const Vector &v) const noexcept;
+  }; // class Vector<N, T, is_euclidian, layout_policy>
 
   using Vector2D = Vector<2>; //! Shortcut for 2D vector in euclidian space.
   using Vector3D = Vector<3>; //! Shortcut for 3D vector in euclidian space.
 
+  //! Shortcut for euclidian vector padded to full SIMD lanes.
+  template<size_t N, Type T = double> using PaddedVector = Vector<N, T, true, Layout::Padded>;
+  using PaddedVector3D = PaddedVector<3>; //! Shortcut for padded 3D vector in euclidian space.
+
   //! Shortcut for non-euclidian vector
   //! i.e. array with componentwise arithmetic, equality and IO operations.
   template<size_t N, Type T = double> using Array = Vector<N, T, false>;
@@ -74,71 +109,94 @@ namespace Math
 /*---------------------------------------------------------------------------------------*/
 
   // arithmetic ops
-  template<size_t N, Type T, bool B>
+  template<size_t N, Type T, bool B, class L>
     constexpr auto operator+(
-      Vector<N, T, B> v1, const Vector<N, T, B> &v2) noexcept { v1 += v2; return v1; }
+      Vector<N, T, B, L> v1, const Vector<N, T, B, L> &v2) noexcept { v1 += v2; return v1; }
 
-  template<size_t N, Type T, bool B>
+  template<size_t N, Type T, bool B, class L>
     constexpr auto operator-(
-      Vector<N, T, B> v1, const Vector<N, T, B> &v2) noexcept { v1 -= v2; return v1; }
+      Vector<N, T, B, L> v1, const Vector<N, T, B, L> &v2) noexcept { v1 -= v2; return v1; }
+
+  template<size_t N, Type T, bool B, class L>
+    constexpr auto operator*(const T &a, Vector<N, T, B, L> v) noexcept { v *= a; return v; }
 
-  template<size_t N, Type T, bool B>
-    constexpr auto operator*(const T &a, Vector<N, T, B> v) noexcept { v *= a; return v; }
+  template<size_t N, Type T, bool B, class L>
+    constexpr auto operator*(Vector<N, T, B, L> v, const T &a) noexcept { v *= a; return v; }
 
-  template<size_t N, Type T, bool B>
-    constexpr auto operator*(Vector<N, T, B> v, const T &a) noexcept { v *= a; return v; }
+  template<size_t N, Type T, bool B, class L>
+    constexpr auto operator/(Vector<N, T, B, L> v, const T &a) noexcept { v /= a; return v; }
 
-  template<size_t N, Type T, bool B>
-    constexpr auto operator/(Vector<N, T, B> v, const T &a) noexcept { v /= a; return v; }
+  // componentwise equality, i.e. the mask of equal lanes for SIMD packs
+  template<size_t N, Type T, bool B, class L>
+    constexpr auto equal(const Vector<N, T, B, L> &v1, const Vector<N, T, B, L> &v2) noexcept;
 
   // IO ops
   // TODO: should throw an exception in case of unexpected format, symbols, ...
-  template<size_t N, Type T, bool B>
-    std::istream& operator>>(std::istream &in, Vector<N, T, B> &v);
+  template<size_t N, Type T, bool B, class L>
+    std::istream& operator>>(std::istream &in, Vector<N, T, B, L> &v);
 
-  template<size_t N, Type T, bool B>
-    std::ostream& operator<<(std::ostream &out, const Vector<N, T, B> &v);
+  template<size_t N, Type T, bool B, class L>
+    std::ostream& operator<<(std::ostream &out, const Vector<N, T, B, L> &v);
 
-  // useful functions for euclidian vector only! note the lack of third tparam
-  template<size_t N, Type T>
-    constexpr auto operator*(const Vector<N, T> &v1, const Vector<N, T> &v2) noexcept;
+  // useful functions for euclidian vector only! note the fixed third tparam
+  template<size_t N, Type T, class L>
+    constexpr auto operator*(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept;
 
-  template<size_t N, Type T>
-    constexpr auto sqs(const Vector<N, T> &v) noexcept { return v*v; }
+  template<size_t N, Type T, class L>
+    constexpr auto sqs(const Vector<N, T, true, L> &v) noexcept { return v*v; }
 
-  template<size_t N, Type T>
-    constexpr auto fabs(const Vector<N, T> &v) noexcept { return details::sqrt(v*v); }
+  template<size_t N, Type T, class L>
+    constexpr auto fabs(const Vector<N, T, true, L> &v) noexcept { return details::sqrt(v*v); }
 
-  template<size_t N, Type T>
-    constexpr auto cos(const Vector<N, T> &v1, const Vector<N, T> &v2) noexcept;
+  template<size_t N, Type T, class L>
+    constexpr auto cos(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept;
 
-  template<size_t N, Type T>
-    constexpr auto sin(const Vector<N, T> &v1, const Vector<N, T> &v2) noexcept;
+  template<size_t N, Type T, class L>
+    constexpr auto sin(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept;
 
-  template<Type T>
-    constexpr auto operator%(const Vector<2, T> &v1, const Vector<2, T> &v2) noexcept;
+  // both of them at once, {cos, sin}
+  template<size_t N, Type T, class L>
+    constexpr auto cos_sin(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept;
 
-  template<Type T>
-    constexpr auto operator%(const Vector<3, T> &v1, const Vector<3, T> &v2) noexcept;
+  // unit vector of the same direction
+  template<size_t N, Type T, class L>
+    constexpr auto normalize(const Vector<N, T, true, L> &v) noexcept;
 
-  template<Type T> constexpr auto operator~(const Vector<2, T> &v) noexcept;
+  // angle between vectors in [0, pi], not constexpr as std::atan2 isn't
+  template<size_t N, std::floating_point T, class L>
+    auto angle(const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept;
+
+  template<Type T, class L>
+    constexpr auto operator%(
+      const Vector<2, T, true, L> &v1, const Vector<2, T, true, L> &v2) noexcept;
+
+  template<Type T, class L>
+    constexpr auto operator%(
+      const Vector<3, T, true, L> &v1, const Vector<3, T, true, L> &v2) noexcept;
+
+  template<Type T, class L>
+    constexpr auto operator~(const Vector<2, T, true, L> &v) noexcept;
 
 /*---------------------------------------------------------------------------------------*/
 /*------------------------------------ definition ---------------------------------------*/
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    template<class U> constexpr Vector<N, T, B>::Vector(const U &a) noexcept
+  template<size_t N, Type T, bool B, class L>
+    template<class U> constexpr Vector<N, T, B, L>::Vector(const U &a) noexcept
   {
-    for (auto &d : data)
-      d = static_cast<T>(a);
+    for (size_t i = 0; i < N; ++i)
+      data[i] = static_cast<T>(a);
   }
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    template<Type U>
-      constexpr Vector<N, T, B>::Vector(const Vector<N, U, B> &v) noexcept
+  template<size_t N, Type T, bool B, class L>
+    template<Type U, class L2>
+      constexpr Vector<N, T, B, L>::Vector(const Vector<N, U, B, L2> &v) noexcept
   {
     for (size_t i = 0; i < N; ++i)
       data[i] = static_cast<T>(v[i]);
@@ -146,10 +204,10 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    template<Type U>
-      constexpr Vector<N, T, B>&
-        Vector<N, T, B>::operator=(const Vector<N, U, B> &v) noexcept
+  template<size_t N, Type T, bool B, class L>
+    template<Type U, class L2>
+      constexpr Vector<N, T, B, L>&
+        Vector<N, T, B, L>::operator=(const Vector<N, U, B, L2> &v) noexcept
   {
     for (size_t i = 0; i < N; ++i)
       data[i] = v[i];
@@ -158,29 +216,60 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    constexpr Vector<N, T, B>& Vector<N, T, B>::operator/=(const T &a) noexcept
+  template<size_t N, Type T, bool B, class L>
+    constexpr Vector<N, T, B, L>& Vector<N, T, B, L>::operator/=(const T &a) noexcept
   {
-    for (auto &d : data)
-      d /= a;
+    if constexpr (simd::kernels<nlanes, T>::enabled)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        if constexpr (nlanes == N)
+          simd::kernels<nlanes, T>::div(data, a);
+        else
+          simd::kernels<nlanes, T>::div3(data, a); // 0/0 is NaN in padding otherwise
+        return *this;
+      }
+    }
+    for (size_t i = 0; i < N; ++i)
+      data[i] /= a;
     return *this;
   }
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    constexpr Vector<N, T, B>& Vector<N, T, B>::operator*=(const T &a) noexcept
+  template<size_t N, Type T, bool B, class L>
+    constexpr Vector<N, T, B, L>& Vector<N, T, B, L>::operator*=(const T &a) noexcept
   {
-    for (auto &d : data)
-      d *= a;
+    if constexpr (simd::kernels<nlanes, T>::enabled)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        if constexpr (nlanes == N)
+          simd::kernels<nlanes, T>::mul(data, a);
+        else
+          simd::kernels<nlanes, T>::mul3(data, a); // 0*inf is NaN in padding otherwise
+        return *this;
+      }
+    }
+    for (size_t i = 0; i < N; ++i)
+      data[i] *= a;
     return *this;
   }
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    constexpr Vector<N, T, B>& Vector<N, T, B>::operator+=(const Vector<N, T, B> &v) noexcept
+  template<size_t N, Type T, bool B, class L>
+    constexpr Vector<N, T, B, L>&
+      Vector<N, T, B, L>::operator+=(const Vector<N, T, B, L> &v) noexcept
   {
+    if constexpr (simd::kernels<nlanes, T>::enabled)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        simd::kernels<nlanes, T>::add(data, v.data);
+        return *this;
+      }
+    }
     for (size_t i = 0; i < N; ++i)
       data[i] += v[i];
     return *this;
@@ -188,9 +277,18 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    constexpr Vector<N, T, B>& Vector<N, T, B>::operator-=(const Vector<N, T, B> &v) noexcept
+  template<size_t N, Type T, bool B, class L>
+    constexpr Vector<N, T, B, L>&
+      Vector<N, T, B, L>::operator-=(const Vector<N, T, B, L> &v) noexcept
   {
+    if constexpr (simd::kernels<nlanes, T>::enabled)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        simd::kernels<nlanes, T>::sub(data, v.data);
+        return *this;
+      }
+    }
     for (size_t i = 0; i < N; ++i)
       data[i] -= v[i];
     return *this;
@@ -198,8 +296,30 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    std::istream& operator>>(std::istream &in, Vector<N, T, B> &v)
+  template<size_t N, Type T, bool B, class L>
+    constexpr bool Vector<N, T, B, L>::operator==(const Vector<N, T, B, L> &v) const noexcept
+  {
+    for (size_t i = 0; i < N; ++i)
+      if (!details::all(data[i] == v.data[i]))
+        return false;
+    return true;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, bool B, class L>
+    constexpr auto equal(const Vector<N, T, B, L> &v1, const Vector<N, T, B, L> &v2) noexcept
+  {
+    auto r = (v1[0] == v2[0]);
+    for (size_t i = 1; i < N; ++i)
+      r = r && (v1[i] == v2[i]);
+    return r;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, bool B, class L>
+    std::istream& operator>>(std::istream &in, Vector<N, T, B, L> &v)
   {
     IO::read_values(in, v, '(', ')');
     return in;
@@ -207,8 +327,8 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T, bool B>
-    std::ostream& operator<<(std::ostream &out, const Vector<N, T, B> &v)
+  template<size_t N, Type T, bool B, class L>
+    std::ostream& operator<<(std::ostream &out, const Vector<N, T, B, L> &v)
   {
     IO::write_values(out, v, '(', ')');
     return out;
@@ -216,9 +336,17 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T>
-  constexpr auto operator*(const Vector<N, T> &v1, const Vector<N, T> &v2) noexcept
+  template<size_t N, Type T, class L>
+    constexpr auto operator*(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept
   {
+    // padding lanes are zeros, so they don't contribute to the sum
+    constexpr size_t M = Vector<N, T, true, L>::nlanes;
+    if constexpr (simd::kernels<M, T>::enabled)
+    {
+      if (!std::is_constant_evaluated())
+        return simd::kernels<M, T>::dot(v1.begin(), v2.begin());
+    }
     auto t = v1[0] * v2[0];
     for (size_t i = 1; i < N; ++i)
       t += v1[i]*v2[i];
@@ -227,35 +355,115 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T>
-    constexpr auto cos(const Vector<N, T> &v1, const Vector<N, T> &v2) noexcept
+  namespace details::impl
+  {
+    // v/|v| by the reciprocal square root, thus |v|^2 must not overflow as for fabs(v)
+    template<size_t N, Type T, class L>
+      constexpr auto unit(const Vector<N, T, true, L> &v) noexcept { return v * rsqrt(sqs(v)); }
+
+    // squared sine times the product of squared norms, |v1 x v2|^2 in 2D and 3D
+    template<size_t N, Type T, class L>
+      constexpr auto sqr_cross(const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept
+    {
+      if constexpr (N == 2)
+        return (v1 % v2) * (v1 % v2);
+      else if constexpr (N == 3)
+        return sqs(v1 % v2);
+      else
+      {
+        auto d = v1 * v2, x = sqs(v1) * sqs(v2) - d * d;
+        return select(x < static_cast<T>(0), static_cast<T>(0), x); // rounding
+      }
+    }
+  } // namespace details::impl
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, class L>
+    constexpr auto cos(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept
   {
     return v1 * v2 / (fabs(v1) * fabs(v2));
   }
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<size_t N, Type T>
-    constexpr auto sin(const Vector<N, T> &v1, const Vector<N, T> &v2) noexcept
+  template<size_t N, Type T, class L>
+    constexpr auto sin(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept
   {
-    auto x = cos(v1, v2);
-    return details::sqrt(static_cast<T>(1) - x*x);
+    if constexpr (!std::integral<T>)
+      return cos_sin(v1, v2).second;
+    else
+    {
+      auto x = cos(v1, v2);
+      return details::sqrt(static_cast<T>(1) - x*x);
+    }
   }
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T>
-    constexpr auto operator%(const Vector<2, T> &v1, const Vector<2, T> &v2) noexcept
+  template<size_t N, Type T, class L>
+    constexpr auto cos_sin(
+      const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept
+  {
+    if constexpr (!std::integral<T>)
+    {
+      // the products of the unit vectors don't overflow nor underflow unlike |v1|^2 |v2|^2
+      auto u1 = details::impl::unit(v1), u2 = details::impl::unit(v2);
+      return std::pair<T, T>(u1 * u2, details::sqrt(details::impl::sqr_cross(u1, u2)));
+    }
+    else
+      return std::pair<T, T>(cos(v1, v2), sin(v1, v2));
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T, class L>
+    constexpr auto normalize(const Vector<N, T, true, L> &v) noexcept
+  {
+    if constexpr (!std::integral<T>)
+      return details::impl::unit(v);
+    else
+      return v / fabs(v);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, std::floating_point T, class L>
+    auto angle(const Vector<N, T, true, L> &v1, const Vector<N, T, true, L> &v2) noexcept
+  {
+    // accurate for both small and close to pi angles unlike acos(cos) or asin(sin)
+    return std::atan2(details::sqrt(details::impl::sqr_cross(v1, v2)), v1 * v2);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Type T, class L>
+    constexpr auto operator%(
+      const Vector<2, T, true, L> &v1, const Vector<2, T, true, L> &v2) noexcept
   {
     return v1[0]*v2[1] - v1[1]*v2[0];
   }
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T>
-    constexpr auto operator%(const Vector<3, T> &v1, const Vector<3, T> &v2) noexcept
+  template<Type T, class L>
+    constexpr auto operator%(
+      const Vector<3, T, true, L> &v1, const Vector<3, T, true, L> &v2) noexcept
   {
-    return Vector<3, T>(
+    using V = Vector<3, T, true, L>;
+    using K = simd::kernels<V::nlanes, T>;
+    if constexpr (requires { &K::cross; })
+    {
+      if (!std::is_constant_evaluated())
+      {
+        V r;
+        K::cross(v1.begin(), v2.begin(), r.begin());
+        return r;
+      }
+    }
+    return V(
       v1[1]*v2[2] - v2[1]*v1[2],
       v1[2]*v2[0] - v2[2]*v1[0],
       v1[0]*v2[1] - v2[0]*v1[1]);
@@ -263,9 +471,10 @@ namespace Math
 
 /*---------------------------------------------------------------------------------------*/
 
-  template<Type T> constexpr auto operator~(const Vector<2, T> &v) noexcept
+  template<Type T, class L>
+    constexpr auto operator~(const Vector<2, T, true, L> &v) noexcept
   {
-    return Vector<2, T>(-v[1], v[0]);
+    return Vector<2, T, true, L>(-v[1], v[0]);
   }
 } // namespace Math
 
@@ -343,6 +552,13 @@ namespace Math::Vectors::tests
   static_assert(details::fp_equal(cos(vd, ex), .6), "cos failed");
   static_assert(details::fp_equal(sin(vd, ex), .8), "sin failed");
 
+  static_assert(details::fp_equal(cos_sin(vd, ex).first, .6), "cos_sin failed");
+  static_assert(details::fp_equal(cos_sin(vd, ex).second, .8), "cos_sin failed");
+  static_assert(details::fp_equal(cos_sin(-vd, V2d(8, -6)).second, 1.), "cos_sin failed");
+  static_assert(details::fp_equal(sin(Vector<4>(1, 1, 0, 0), Vector<4>(0, 1, 0, 0)), details::sqrt(.5)), "sin failed");
+  static_assert(sin(Vector<4>(1, 2, 3, 4), Vector<4>(1, 2, 3, 4)) >= 0, "sin failed");
+  static_assert(details::fp_equal(normalize(vd)[0], .6) && details::fp_equal(normalize(vd)[1], .8), "normalize failed");
+
   constexpr Vector<2, float> vf(3, 4);
   static_assert(details::fp_equal(sqs(vf), 25.f), "sqs failed");
   static_assert(details::fp_equal(fabs(vf), 5.f), "abs failed");
@@ -350,6 +566,37 @@ namespace Math::Vectors::tests
   constexpr Vector<2, long> vl(3, 4);
   static_assert(sqs(vl) == 25, "sqs failed");
   static_assert(fabs(vl) == 5, "abs failed");
+  static_assert(cos(vl, vl) == 1 && sin(vl, vl) == 0, "cos/sin failed");
+  static_assert(cos(V3d(1e100, 0, 0), V3d(1e100, 0, 0)) == 1., "cos failed");
+  static_assert(cos_sin(V3d(1e-100, 0, 0), V3d(0, 1e-100, 0)).second == 1., "cos_sin failed");
+
+  // types with packed kernels still work in compile-time
+  constexpr V3d a3(1, 2, 3), b3(4, 5, 6);
+  static_assert(a3 + b3 == V3d(5, 7, 9), "v + v failed for packed type");
+  static_assert(b3 - a3 == V3d(3), "v - v failed for packed type");
+  static_assert(2. * a3 == V3d(2, 4, 6), "a * v failed for packed type");
+  static_assert(b3 / 2. == V3d(2, 2.5, 3), "v / a failed for packed type");
+  static_assert(a3 * b3 == 32., "v * v failed for packed type");
+  static_assert(a3 % b3 == V3d(-3, 6, -3), "v % v failed for packed type");
+
+  constexpr Vector<4, float> a4(1, 2, 3, 4);
+  static_assert(a4 + a4 == 2.f * a4, "v + v failed for packed type");
+  static_assert(a4 * a4 == 30.f, "v * v failed for packed type");
+
+  // padded layout
+  using P3d = PaddedVector<3>;
+  using P3i = PaddedVector<3, int>;
+  static_assert(sizeof(V3d) == 3*sizeof(double) && sizeof(P3d) == 4*sizeof(double), "padding failed");
+  static_assert(alignof(P3d) == 4*sizeof(double), "alignment failed");
+  static_assert(sizeof(PaddedVector<2>) == sizeof(V2d), "needless padding");
+  static_assert(sizeof(PaddedVector<5>) == 8*sizeof(double), "padding failed");
+
+  constexpr P3d p3(1, 2, 3), q3(4, 5, 6);
+  static_assert(p3 + q3 == P3d(5, 7, 9), "v + v failed for padded type");
+  static_assert(p3 % q3 == P3d(-3, 6, -3), "v % v failed for padded type");
+  static_assert(p3 * q3 == 32., "v * v failed for padded type");
+  static_assert(P3d(a3) == p3 && V3d(p3) == a3, "conversion of layouts failed");
+  static_assert(P3i(1) * P3i(1) == 3, "padding is not zero");
 
   // vector's properties
   constexpr V3i z(0), a(1, 2, 3), b(4, 5, 6), c(7, 8, 9);
@@ -383,6 +630,7 @@ namespace Math::Vectors::tests
   \tparam T Type of the components.
   \tparam is_euclidian Boolean flag, used to distinguish vector in euclidian space (true)
     from an array of components with the same type (false) and a subset of operatrions.
+  \tparam layout_policy Memory layout of the components, Math::Layout::Packed by default.
 
   If vector is not euclidian one then only minimal, componentwise set of operations
   are defined for it, like multiplication and division by scalar, addition to
@@ -391,6 +639,17 @@ namespace Math::Vectors::tests
   magnitude, etc. Also several mixed operations with tensors/matricies are defined,
   \see Math::Tensor
 
+  Basic operations (+=, -=, *=, /=, dot and cross products) of the most used vectors
+  of floats and doubles are done with packed SIMD instructions in runtime,
+  see Math::simd::kernels. In compile-time the generic loops are used.
+
+  Padded layout (Math::Layout::Padded) stores the components with zeros up to the power
+  of 2 and aligns the storage, e.g. padded Vector<3, float> takes 16 bytes and fits exactly
+  one SIMD register, so arrays of them never split a register or a cache line.
+  Padding lanes are always zero, thus 3D vectors of floats and doubles use full-width
+  kernels for all operations incl. dot and cross products. Vectors of different layouts
+  are explicitly convertible to each other, see Math::PaddedVector.
+
   NB! All operations are noexcept because I don't care about overflows! Just kidding!
   It's because there is no standard and cross-platform way to catch them in C++
   for types like int or double (which are the main type of the components IMO).
@@ -568,7 +827,16 @@ namespace Math::Vectors::tests
   \param v1 Left term.
   \param v2 Right term.
   \return true if all components of the left term equals to the corresponding components
-    of the right term, i.e. v1[i] == v2[i] for i = 0..(N-1)
+    of the right term, i.e. v1[i] == v2[i] for i = 0..(N-1), in all the lanes for Math::Pack components
+*/
+
+/*!
+  \fn constexpr auto equal(const Vector &v1, const Vector &v2) noexcept
+  \brief Component-wise equality comparison which keeps the lanes of SIMD packs apart.
+  \param v1 Left term.
+  \param v2 Right term.
+  \return bool for scalar components (same as v1 == v2), or the mask of lanes
+    where all the components are equal for Math::Pack components.
 */
 
 /*!
@@ -638,6 +906,31 @@ namespace Math::Vectors::tests
   \return Sine of the angle between two given vectors.
 */
 
+/*!
+  \fn constexpr auto cos_sin(const Vector &v1, const Vector &v2) noexcept
+  \brief Get both cosine and sine of the angle between two vectors.
+  \param v1 Left term.
+  \param v2 Right term.
+  \return Pair {cos, sin}, e.g. <tt>auto [c, s] = cos_sin(v1, v2);</tt>
+
+  Normalizes the vectors by the reciprocal square roots, thus it has the range of Math::fabs,
+  and takes the sine as the norm of the cross product of the unit vectors in 2D and 3D,
+  so it is accurate for small angles. Math::sin of floating point vectors is computed
+  the same way, integral vectors give v1 v2 / (|v1| |v2|) and sqrt(1 - cos^2) as before.
+*/
+
+/*!
+  \fn constexpr auto normalize(const Vector &v) noexcept
+  \brief Get unit vector of the same direction, v/|v| by the reciprocal square root.
+*/
+
+/*!
+  \fn auto angle(const Vector &v1, const Vector &v2) noexcept
+  \brief Get angle in [0, pi] between two vectors as atan2(|v1 x v2|, v1 v2).
+
+  Accurate in the whole range unlike acos of the cosine, vectors need not be normalized.
+*/
+
 /*!
   \fn constexpr auto operator%(const Vector &v1, const Vector &v2) noexcept
   \brief Cross product in 2D i.e. signed(!) area of a parallelogram formed by two vectors.
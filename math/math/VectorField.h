@@ -0,0 +1,439 @@
+#ifndef MATH_VECTOR_FIELD_H_INCLUDED
+#define MATH_VECTOR_FIELD_H_INCLUDED
+
+/*!
+  \file VectorField.h
+  \author gennadiy
+  \brief Structure-of-arrays container of vectors and bulk kernels, definition, documentation and tests.
+*/
+
+#include "Vector.h"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+namespace Math
+{
+  template<size_t N, Type T = double> class VectorField
+  {
+    static_assert(N != 0, "Vector field of zero size vectors is meaningless.");
+
+    // components are stored one after another, each starts at an aligned address
+    std::vector<T, simd::allocator<T>> data;
+    size_t n = 0;      // number of vectors
+    size_t stride = 0; // distance between the beginnings of the components
+
+  public:
+    class reference;
+
+    // traits
+    static constexpr int ncomps = N;
+
+    // ctors
+    VectorField() = default;
+    explicit VectorField(size_t size, const Vector<N, T> &v = Vector<N, T>());
+
+    // size
+    size_t size() const noexcept { return n; }
+    bool empty() const noexcept { return n == 0; }
+    void resize(size_t size);
+
+    // access to the components arrays
+    std::span<T> component(size_t i) noexcept { assert(i < N); return {data.data() + i*stride, n}; }
+    std::span<const T> component(size_t i) const noexcept { assert(i < N); return {data.data() + i*stride, n}; }
+
+    // access to the vectors
+    reference operator[](size_t k) noexcept { assert(k < n); return {data.data() + k, stride}; }
+    Vector<N, T> operator[](size_t k) const noexcept;
+
+    void set(size_t k, const Vector<N, T> &v) noexcept { (*this)[k] = v; }
+    Vector<N, T> get(size_t k) const noexcept { return (*this)[k]; }
+
+  private:
+    // raw storage including the padding at the end of each component,
+    // padded elements are always default initialized
+    T* raw() noexcept { return data.data(); }
+    const T* raw() const noexcept { return data.data(); }
+    size_t raw_size() const noexcept { return data.size(); }
+
+    template<size_t M, Type U>
+      friend void axpy(const U &a, const VectorField<M, U> &x, VectorField<M, U> &y) noexcept;
+    template<size_t M, Type U> friend void scale(const U &a, VectorField<M, U> &x) noexcept;
+  }; // class VectorField<N, T>
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T> class VectorField<N, T>::reference
+  {
+    T *p;
+    size_t stride;
+
+    constexpr reference(T *ptr, size_t s) noexcept : p(ptr), stride(s) {}
+    friend class VectorField<N, T>;
+
+  public:
+    reference(const reference &) = default;
+
+    constexpr operator Vector<N, T>() const noexcept;
+    constexpr Vector<N, T> get() const noexcept { return *this; }
+
+    constexpr T& operator[](size_t i) const noexcept { assert(i < N); return p[i*stride]; }
+
+    constexpr reference& operator=(const Vector<N, T> &v) noexcept;
+    constexpr reference& operator=(const reference &r) noexcept { return *this = r.get(); }
+
+    constexpr reference& operator+=(const Vector<N, T> &v) noexcept;
+    constexpr reference& operator-=(const Vector<N, T> &v) noexcept;
+    constexpr reference& operator*=(const T &a) noexcept;
+    constexpr reference& operator/=(const T &a) noexcept;
+  }; // class VectorField<N, T>::reference
+
+/*---------------------------------------------------------------------------------------*/
+
+  // bulk kernels, all fields must have the same size
+  template<size_t N, Type T>
+    void axpy(const T &a, const VectorField<N, T> &x, VectorField<N, T> &y) noexcept;
+
+  template<size_t N, Type T>
+    void scale(const T &a, VectorField<N, T> &x) noexcept;
+
+  template<size_t N, Type T>
+    void dot(const VectorField<N, T> &x, const VectorField<N, T> &y, std::span<T> r) noexcept;
+
+  template<size_t N, std::floating_point T>
+    void norm(const VectorField<N, T> &x, std::span<T> r) noexcept;
+
+  template<size_t N, std::floating_point T>
+    void normalize(VectorField<N, T> &x) noexcept;
+
+  template<Type T>
+    void cross(
+      const VectorField<3, T> &x, const VectorField<3, T> &y, VectorField<3, T> &r) noexcept;
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ definition ---------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    VectorField<N, T>::VectorField(size_t size, const Vector<N, T> &v) :
+      n(size), stride((size + simd::lanes<T> - 1) / simd::lanes<T> * simd::lanes<T>)
+  {
+    data.resize(N * stride);
+    for (size_t i = 0; i < N; ++i)
+      std::fill_n(data.data() + i*stride, n, v[i]);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T> void VectorField<N, T>::resize(size_t size)
+  {
+    VectorField<N, T> f(size);
+    for (size_t i = 0, m = std::min(n, size); i < N; ++i)
+      std::copy_n(data.data() + i*stride, m, f.data.data() + i*f.stride);
+    *this = std::move(f);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    Vector<N, T> VectorField<N, T>::operator[](size_t k) const noexcept
+  {
+    assert(k < n);
+    Vector<N, T> v;
+    for (size_t i = 0; i < N; ++i)
+      v[i] = data[k + i*stride];
+    return v;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr VectorField<N, T>::reference::operator Vector<N, T>() const noexcept
+  {
+    Vector<N, T> v;
+    for (size_t i = 0; i < N; ++i)
+      v[i] = p[i*stride];
+    return v;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr auto VectorField<N, T>::reference::operator=(const Vector<N, T> &v) noexcept
+      -> reference&
+  {
+    for (size_t i = 0; i < N; ++i)
+      p[i*stride] = v[i];
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr auto VectorField<N, T>::reference::operator+=(const Vector<N, T> &v) noexcept
+      -> reference&
+  {
+    for (size_t i = 0; i < N; ++i)
+      p[i*stride] += v[i];
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr auto VectorField<N, T>::reference::operator-=(const Vector<N, T> &v) noexcept
+      -> reference&
+  {
+    for (size_t i = 0; i < N; ++i)
+      p[i*stride] -= v[i];
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr auto VectorField<N, T>::reference::operator*=(const T &a) noexcept
+      -> reference&
+  {
+    for (size_t i = 0; i < N; ++i)
+      p[i*stride] *= a;
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    constexpr auto VectorField<N, T>::reference::operator/=(const T &a) noexcept
+      -> reference&
+  {
+    for (size_t i = 0; i < N; ++i)
+      p[i*stride] /= a;
+    return *this;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    void axpy(const T &a, const VectorField<N, T> &x, VectorField<N, T> &y) noexcept
+  {
+    assert(x.size() == y.size());
+    // padding is zero in both fields thus it's safe to process the whole storage at once
+    const T *px = x.raw();
+    T *py = y.raw();
+    const size_t n = y.raw_size();
+    MATH_SIMD_LOOP
+    for (size_t k = 0; k < n; ++k)
+      py[k] += a * px[k];
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T> void scale(const T &a, VectorField<N, T> &x) noexcept
+  {
+    T *px = x.raw();
+    const size_t n = x.raw_size();
+    MATH_SIMD_LOOP
+    for (size_t k = 0; k < n; ++k)
+      px[k] *= a;
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, Type T>
+    void dot(const VectorField<N, T> &x, const VectorField<N, T> &y, std::span<T> r) noexcept
+  {
+    assert(x.size() == y.size() && r.size() == x.size());
+    const size_t n = x.size();
+    T *pr = r.data();
+    {
+      const T *px = x.component(0).data(), *py = y.component(0).data();
+      MATH_SIMD_LOOP
+      for (size_t k = 0; k < n; ++k)
+        pr[k] = px[k] * py[k];
+    }
+    for (size_t i = 1; i < N; ++i)
+    {
+      const T *px = x.component(i).data(), *py = y.component(i).data();
+      MATH_SIMD_LOOP
+      for (size_t k = 0; k < n; ++k)
+        pr[k] += px[k] * py[k];
+    }
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, std::floating_point T>
+    void norm(const VectorField<N, T> &x, std::span<T> r) noexcept
+  {
+    dot(x, x, r);
+    T *pr = r.data();
+    const size_t n = r.size();
+    MATH_SIMD_LOOP
+    for (size_t k = 0; k < n; ++k)
+      pr[k] = std::sqrt(pr[k]);
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<size_t N, std::floating_point T> void normalize(VectorField<N, T> &x) noexcept
+  {
+    // process the field by chunks which fit in L1 cache
+    constexpr size_t chunk = 64 * simd::lanes<T>;
+    alignas(simd::alignment) T s[chunk];
+
+    for (size_t k0 = 0; k0 < x.size(); k0 += chunk)
+    {
+      const size_t m = std::min(chunk, x.size() - k0);
+      for (size_t k = 0; k < m; ++k)
+        s[k] = 0;
+      for (size_t i = 0; i < N; ++i)
+      {
+        const T *px = x.component(i).data() + k0;
+        MATH_SIMD_LOOP
+        for (size_t k = 0; k < m; ++k)
+          s[k] += px[k] * px[k];
+      }
+
+      // zero vectors are left untouched
+      MATH_SIMD_LOOP
+      for (size_t k = 0; k < m; ++k)
+        s[k] = (s[k] > 0)? T{1} / std::sqrt(s[k]) : T{1};
+
+      for (size_t i = 0; i < N; ++i)
+      {
+        T *px = x.component(i).data() + k0;
+        MATH_SIMD_LOOP
+        for (size_t k = 0; k < m; ++k)
+          px[k] *= s[k];
+      }
+    }
+  }
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<Type T>
+    void cross(
+      const VectorField<3, T> &x, const VectorField<3, T> &y, VectorField<3, T> &r) noexcept
+  {
+    assert(x.size() == y.size() && r.size() == x.size());
+    const T *x0 = x.component(0).data(), *x1 = x.component(1).data(), *x2 = x.component(2).data();
+    const T *y0 = y.component(0).data(), *y1 = y.component(1).data(), *y2 = y.component(2).data();
+    T *r0 = r.component(0).data(), *r1 = r.component(1).data(), *r2 = r.component(2).data();
+    const size_t n = r.size();
+    MATH_SIMD_LOOP
+    for (size_t k = 0; k < n; ++k)
+    {
+      T c0 = x1[k]*y2[k] - y1[k]*x2[k];
+      T c1 = x2[k]*y0[k] - y2[k]*x0[k];
+      T c2 = x0[k]*y1[k] - y0[k]*x1[k];
+      r0[k] = c0;
+      r1[k] = c1;
+      r2[k] = c2;
+    }
+  }
+} // namespace Math
+
+/*---------------------------------------------------------------------------------------*/
+/*--------------------------------------- tests -----------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+namespace Math::VectorFields::tests
+{
+  static_assert(VectorField<3>::ncomps == 3);
+  static_assert(std::is_convertible_v<VectorField<3>::reference, Vector3D>);
+  static_assert(std::is_same_v<decltype(std::declval<const VectorField<2>&>()[0]), Vector2D>);
+} // namespace Math::VectorFields::tests
+
+/*---------------------------------------------------------------------------------------*/
+/*----------------------------------- documentation -------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \class Math::VectorField
+  \brief Container of vectors with structure-of-arrays layout.
+  \tparam N Number of components of each vector.
+  \tparam T Type of the components.
+
+  Each component of the vectors is stored in its own contiguous array aligned
+  to Math::simd::alignment, so bulk operations over the field are vectorized
+  across the elements instead of components. It's the preferred storage for
+  e.g. node or cell values in mesh loops.
+
+  Single vectors are accessed via proxy which converts to (and may be assigned from)
+  a Math::Vector, thus the code written against Vector.h works with the field too:
+  \code
+  VectorField<3> w(ncells);
+  w[i] = Vector3D(1, 2, 3);
+  Vector3D wi = w[i];
+  w[i] += dt * a;
+  auto wx = w.component(Vector3D::X); // std::span with all x-components
+  \endcode
+
+  Note that proxy is not a Vector itself, so template functions like Math::fabs
+  require an explicit conversion, e.g. fabs(w[i].get()).
+*/
+
+/*!
+  \class Math::VectorField::reference
+  \brief Proxy object to access a vector stored in a Math::VectorField.
+*/
+
+/*!
+  \fn std::span<T> VectorField::component(size_t i) noexcept
+  \brief Get all values of the i-th component.
+  \param i Number of component.
+  \return Contiguous aligned array of the i-th components of all vectors.
+*/
+
+/*!
+  \fn void VectorField::resize(size_t size)
+  \brief Change the number of vectors, new vectors are set to zero.
+  \param size New number of vectors.
+*/
+
+/*!
+  \fn void axpy(const T &a, const VectorField &x, VectorField &y) noexcept
+  \brief Bulk y[k] += a * x[k] for all vectors of the fields.
+  \param a Scalar factor.
+  \param x Field of addends.
+  \param y Field to be updated.
+*/
+
+/*!
+  \fn void scale(const T &a, VectorField &x) noexcept
+  \brief Bulk x[k] *= a for all vectors of the field.
+  \param a Scalar factor.
+  \param x Field to be updated.
+*/
+
+/*!
+  \fn void dot(const VectorField &x, const VectorField &y, std::span<T> r) noexcept
+  \brief Bulk dot product, r[k] = x[k] * y[k].
+  \param x Left terms.
+  \param y Right terms.
+  \param r Results, must have the same size as the fields.
+*/
+
+/*!
+  \fn void norm(const VectorField &x, std::span<T> r) noexcept
+  \brief Bulk magnitude, r[k] = fabs(x[k]).
+  \param x Field of vectors.
+  \param r Results, must have the same size as the field.
+*/
+
+/*!
+  \fn void normalize(VectorField &x) noexcept
+  \brief Bulk normalization, x[k] /= fabs(x[k]). Zero vectors are left untouched.
+  \param x Field to be normalized.
+*/
+
+/*!
+  \fn void cross(const VectorField &x, const VectorField &y, VectorField &r) noexcept
+  \brief Bulk cross product of 3D vectors, r[k] = x[k] % y[k].
+  \param x Left terms.
+  \param y Right terms.
+  \param r Results, may coincide with any of the arguments.
+*/
+
+#endif // MATH_VECTOR_FIELD_H_INCLUDED
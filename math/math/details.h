@@ -7,6 +7,9 @@
   \brief Various helpers
 */
 
+#include "Type.h"
+#include "simd.h"
+#include <cmath>
 #include <limits>
 #include <cstddef>
 #include <concepts>
@@ -14,15 +17,49 @@
 
 namespace Math::details
 {
+  // numbers of user-defined class types, e.g. SIMD packs or dual numbers,
+  // their functions are found by argument-dependent lookup
+  template<class T> concept class_number = Type<T> && std::is_class_v<T>;
+
+  namespace adl
+  {
+    // hides the functions of the enclosing namespaces, thus only ADL finds them
+    void sqrt() = delete;
+
+    template<class T> concept has_sqrt = requires(const T &x) { sqrt(x); };
+  } // namespace adl
+
+  // class numbers with sqrt, e.g. a friend or a function of their namespace
+  template<class T> concept sqrt_number = class_number<T> && adl::has_sqrt<T>;
+
   // constexpr version of std::abs
   // TODO: remove after switching to c++23
   constexpr auto abs(auto x) noexcept { return (x < 0)? -x : x; }
 
-  // constexpr version of std::sqrt for both integral and floating point types
+  // constexpr version of std::sqrt for both integral and floating point types,
+  // hardware instructions are used in runtime
   // TODO: remove after switching to c++26
   constexpr auto sqrt(std::integral auto x) noexcept;
   constexpr auto sqrt(std::floating_point auto x) noexcept;
 
+  // square root of class numbers, e.g. lanewise one of SIMD packs
+  constexpr auto sqrt(const sqrt_number auto &x) noexcept;
+
+  // reciprocal square root, 1/sqrt(x)
+  constexpr auto rsqrt(std::floating_point auto x) noexcept;
+  constexpr auto rsqrt(const sqrt_number auto &x) noexcept;
+
+  // sqrt(x*x + y*y) w/o protection against overflow, unlike std::hypot
+  constexpr auto hypot(std::floating_point auto x, std::floating_point auto y) noexcept;
+
+  // reductions of comparison results, i.e. the bool itself for scalars
+  constexpr bool all(const Mask auto &m) noexcept;
+  constexpr bool any(const Mask auto &m) noexcept;
+
+  // lanewise m? a : b, for scalars too
+  template<Mask M, class T>
+    constexpr T select(const M &m, const T &a, const T &b) noexcept;
+
   // floating-point comparison with specific epsilon
   template<std::floating_point T>
     constexpr bool fp_equal(T x, T y, size_t ulp = 1) noexcept;
@@ -51,13 +88,105 @@ namespace Math::details::impl
 constexpr auto Math::details::sqrt(std::floating_point auto x) noexcept
 {
   using type = std::decay_t<decltype(x)>;
-  return (x < type{0})? type{-1} : impl::sqrt_real(x, x, type{0});
+  if (x < type{0})
+    return type{-1};
+  if (std::is_constant_evaluated())
+    return impl::sqrt_real(x, x, type{0});
+  else
+    return std::sqrt(x);
 }
 
 constexpr auto Math::details::sqrt(std::integral auto x) noexcept
 {
   using type = std::decay_t<decltype(x)>;
-  return (x < type{0})? type{-1} : impl::sqrt_int(x, type{0}, x / 2 + type{1});
+  if (x < type{0})
+    return type{-1};
+  if (std::is_constant_evaluated())
+    return impl::sqrt_int(x, type{0}, x / 2 + type{1});
+
+  // initial guess may be off by one for large values due to rounding
+  auto r = static_cast<type>(std::sqrt(static_cast<double>(x)));
+  while (r > 0 && r > x / r)
+    --r;
+  while (r + 1 <= x / (r + 1))
+    ++r;
+  return r;
+}
+
+constexpr auto Math::details::sqrt(const sqrt_number auto &x) noexcept
+{
+  // NB! negative values (lanes) of packs give NaN unlike scalar versions
+  return sqrt(x);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+constexpr auto Math::details::rsqrt(std::floating_point auto x) noexcept
+{
+  using type = std::decay_t<decltype(x)>;
+  if (std::is_constant_evaluated())
+  {
+    if (x == type{0})
+      return std::numeric_limits<type>::infinity();
+    return (x > type{0})? type{1} / impl::sqrt_real(x, x, type{0}) : std::numeric_limits<type>::quiet_NaN();
+  }
+
+#if defined(MATH_SIMD_SSE2)
+  // hardware estimate (12 bits) with one Newton-Raphson step, for normal values only
+  if constexpr (std::is_same_v<type, float>)
+  {
+    if (x >= std::numeric_limits<float>::min() && x <= std::numeric_limits<float>::max())
+    {
+      float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+      return y * (1.5f - 0.5f * x * y * y);
+    }
+  }
+#endif
+  return type{1} / std::sqrt(x);
+}
+
+constexpr auto Math::details::rsqrt(const sqrt_number auto &x) noexcept
+{
+  using type = std::decay_t<decltype(x)>;
+  return type(1) / sqrt(x);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+constexpr auto Math::details::hypot(std::floating_point auto x, std::floating_point auto y) noexcept
+{
+  return sqrt(x*x + y*y);
+}
+
+/*---------------------------------------------------------------------------------------*/
+
+constexpr bool Math::details::all(const Mask auto &m) noexcept
+{
+  if constexpr (std::convertible_to<decltype(m), bool>)
+    return static_cast<bool>(m);
+  else
+    return all_of(m);
+}
+
+constexpr bool Math::details::any(const Mask auto &m) noexcept
+{
+  if constexpr (std::convertible_to<decltype(m), bool>)
+    return static_cast<bool>(m);
+  else
+    return any_of(m);
+}
+
+template<Math::Mask M, class T>
+  constexpr T Math::details::select(const M &m, const T &a, const T &b) noexcept
+{
+  if constexpr (std::convertible_to<M, bool>)
+    return static_cast<bool>(m)? a : b;
+  else
+  {
+    T r = b;
+    where(m, r) = a;
+    return r;
+  }
 }
 
 /*---------------------------------------------------------------------------------------*/
@@ -94,6 +223,29 @@ namespace Math::details::tests
   static_assert(sqrt(4.) == 2., "sqrt failed");
   static_assert(sqrt(4.f) == 2.f, "sqrt failed");
 
+  static_assert(rsqrt(4.) == .5, "rsqrt failed");
+  static_assert(rsqrt(.25f) == 2.f, "rsqrt failed");
+  static_assert(rsqrt(0.) == std::numeric_limits<double>::infinity(), "rsqrt failed");
+  static_assert(rsqrt(-1.) != rsqrt(-1.), "rsqrt failed");
+
+  // sqrt of class numbers is found by ADL only, not by their conversions to built-in types
+  struct NoSqrt
+  {
+    double x = 0;
+    constexpr operator double() const noexcept { return x; }
+    constexpr NoSqrt& operator+=(NoSqrt) noexcept { return *this; }
+    constexpr NoSqrt& operator-=(NoSqrt) noexcept { return *this; }
+    constexpr NoSqrt& operator*=(NoSqrt) noexcept { return *this; }
+    constexpr NoSqrt& operator/=(NoSqrt) noexcept { return *this; }
+  };
+  static_assert(class_number<NoSqrt> && !sqrt_number<NoSqrt>, "sqrt_number failed");
+
+  static_assert(hypot(3., 4.) == 5., "hypot failed");
+  static_assert(hypot(-3.f, 4.f) == 5.f, "hypot failed");
+
+  static_assert(all(true) && !all(false) && any(1 == 1), "all/any failed");
+  static_assert(select(2 > 1, 1., 2.) == 1. && select(false, 1, 2) == 2, "select failed");
+
   static_assert(fp_equal(6.022140857e+23, 6.022140857e+23 + 2e8), "fp equal failed");
   static_assert(!fp_equal(6.022140857e+23, 6.022140857e+23 + 3e8), "fp equal failed");
 }
@@ -0,0 +1,487 @@
+#ifndef MATH_SIMD_H_INCLUDED
+#define MATH_SIMD_H_INCLUDED
+
+/*!
+  \file simd.h
+  \author gennadiy
+  \brief Packed arithmetic kernels for small vectors of floats and doubles, aligned storage.
+*/
+
+#include <new>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define MATH_SIMD_SSE2 1
+#  include <immintrin.h>
+#endif
+
+#if defined(MATH_SIMD_SSE2) && defined(__AVX__)
+#  define MATH_SIMD_AVX 1
+#endif
+
+// conversions between IEEE half and single precision
+#if defined(MATH_SIMD_AVX) && defined(__F16C__)
+#  define MATH_SIMD_F16C 1
+#endif
+
+// hint for the compiler that iterations of the following loop are independent
+#if defined(__clang__)
+#  define MATH_SIMD_LOOP _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__) && defined(__OPTIMIZE__)
+#  define MATH_SIMD_LOOP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#  define MATH_SIMD_LOOP __pragma(loop(ivdep))
+#else
+#  define MATH_SIMD_LOOP
+#endif
+
+namespace Math::simd
+{
+  // alignment of bulk storage, enough for any SIMD register and a cache line
+  inline constexpr size_t alignment = 64;
+
+  template<class T> struct allocator
+  {
+    using value_type = T;
+
+    constexpr allocator() noexcept = default;
+    template<class U> constexpr allocator(const allocator<U> &) noexcept {}
+
+    T* allocate(size_t n)
+    {
+      return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignment}));
+    }
+
+    void deallocate(T *p, size_t n) noexcept
+    {
+      ::operator delete(p, n * sizeof(T), std::align_val_t{alignment});
+    }
+
+    template<class U> constexpr bool operator==(const allocator<U> &) const noexcept { return true; }
+  }; // struct allocator<T>
+
+  // number of elements of type T in an aligned chunk of memory
+  template<class T> inline constexpr size_t lanes = (sizeof(T) < alignment)? alignment / sizeof(T) : 1;
+
+  // primary template: no packed kernels, callers use their own scalar loops
+  template<size_t N, class T> struct kernels
+  {
+    static constexpr bool enabled = false;
+  };
+
+#if defined(MATH_SIMD_SSE2)
+  template<> struct kernels<2, double>
+  {
+    static constexpr bool enabled = true;
+
+    static void add(double *a, const double *b) noexcept
+    {
+      _mm_storeu_pd(a, _mm_add_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    }
+
+    static void sub(double *a, const double *b) noexcept
+    {
+      _mm_storeu_pd(a, _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    }
+
+    static void mul(double *a, double s) noexcept
+    {
+      _mm_storeu_pd(a, _mm_mul_pd(_mm_loadu_pd(a), _mm_set1_pd(s)));
+    }
+
+    static void div(double *a, double s) noexcept
+    {
+      _mm_storeu_pd(a, _mm_div_pd(_mm_loadu_pd(a), _mm_set1_pd(s)));
+    }
+
+    static double dot(const double *a, const double *b) noexcept
+    {
+      __m128d m = _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b));
+      return _mm_cvtsd_f64(_mm_add_sd(m, _mm_unpackhi_pd(m, m)));
+    }
+  }; // struct kernels<2, double>
+
+/*---------------------------------------------------------------------------------------*/
+
+  // (x, y) go to a packed register, z is processed as a scalar lane
+  template<> struct kernels<3, double>
+  {
+    static constexpr bool enabled = true;
+
+    static void add(double *a, const double *b) noexcept
+    {
+      _mm_storeu_pd(a, _mm_add_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+      _mm_store_sd(a + 2, _mm_add_sd(_mm_load_sd(a + 2), _mm_load_sd(b + 2)));
+    }
+
+    static void sub(double *a, const double *b) noexcept
+    {
+      _mm_storeu_pd(a, _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+      _mm_store_sd(a + 2, _mm_sub_sd(_mm_load_sd(a + 2), _mm_load_sd(b + 2)));
+    }
+
+    static void mul(double *a, double s) noexcept
+    {
+      __m128d f = _mm_set1_pd(s);
+      _mm_storeu_pd(a, _mm_mul_pd(_mm_loadu_pd(a), f));
+      _mm_store_sd(a + 2, _mm_mul_sd(_mm_load_sd(a + 2), f));
+    }
+
+    static void div(double *a, double s) noexcept
+    {
+      __m128d f = _mm_set1_pd(s);
+      _mm_storeu_pd(a, _mm_div_pd(_mm_loadu_pd(a), f));
+      _mm_store_sd(a + 2, _mm_div_sd(_mm_load_sd(a + 2), f));
+    }
+
+    // same order of summation as the scalar loop: (x + y) + z
+    static double dot(const double *a, const double *b) noexcept
+    {
+      __m128d m = _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b));
+      __m128d s = _mm_add_sd(m, _mm_unpackhi_pd(m, m));
+      return _mm_cvtsd_f64(_mm_add_sd(s, _mm_mul_sd(_mm_load_sd(a + 2), _mm_load_sd(b + 2))));
+    }
+
+    // (r0, r1) = (a1, a2)*(b2, b0) - (b1, b2)*(a2, a0), r2 = a0*b1 - b0*a1
+    static void cross(const double *a, const double *b, double *r) noexcept
+    {
+      __m128d a12 = _mm_loadu_pd(a + 1), b12 = _mm_loadu_pd(b + 1);
+      __m128d a20 = _mm_unpacklo_pd(_mm_load_sd(a + 2), _mm_load_sd(a));
+      __m128d b20 = _mm_unpacklo_pd(_mm_load_sd(b + 2), _mm_load_sd(b));
+      _mm_storeu_pd(r, _mm_sub_pd(_mm_mul_pd(a12, b20), _mm_mul_pd(b12, a20)));
+      r[2] = a[0]*b[1] - b[0]*a[1];
+    }
+  }; // struct kernels<3, double>
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<> struct kernels<4, double>
+  {
+    static constexpr bool enabled = true;
+
+#if defined(MATH_SIMD_AVX)
+    static void add(double *a, const double *b) noexcept
+    {
+      _mm256_storeu_pd(a, _mm256_add_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+    }
+
+    static void sub(double *a, const double *b) noexcept
+    {
+      _mm256_storeu_pd(a, _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+    }
+
+    static void mul(double *a, double s) noexcept
+    {
+      _mm256_storeu_pd(a, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_set1_pd(s)));
+    }
+
+    static void div(double *a, double s) noexcept
+    {
+      _mm256_storeu_pd(a, _mm256_div_pd(_mm256_loadu_pd(a), _mm256_set1_pd(s)));
+    }
+
+    // the same for 3D vectors padded to 4 lanes, lane 3 is kept unchanged (i.e. zero)
+    static void mul3(double *a, double s) noexcept
+    {
+      __m256d v = _mm256_loadu_pd(a);
+      _mm256_storeu_pd(a, _mm256_blend_pd(_mm256_mul_pd(v, _mm256_set1_pd(s)), v, 0x8));
+    }
+
+    static void div3(double *a, double s) noexcept
+    {
+      __m256d v = _mm256_loadu_pd(a);
+      _mm256_storeu_pd(a, _mm256_blend_pd(_mm256_div_pd(v, _mm256_set1_pd(s)), v, 0x8));
+    }
+
+    // NB! pairwise order of summation: (x + z) + (y + w)
+    static double dot(const double *a, const double *b) noexcept
+    {
+      __m256d m = _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+      __m128d s = _mm_add_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+      return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+#else
+    static void add(double *a, const double *b) noexcept
+    {
+      kernels<2, double>::add(a, b);
+      kernels<2, double>::add(a + 2, b + 2);
+    }
+
+    static void sub(double *a, const double *b) noexcept
+    {
+      kernels<2, double>::sub(a, b);
+      kernels<2, double>::sub(a + 2, b + 2);
+    }
+
+    static void mul(double *a, double s) noexcept
+    {
+      kernels<2, double>::mul(a, s);
+      kernels<2, double>::mul(a + 2, s);
+    }
+
+    static void div(double *a, double s) noexcept
+    {
+      kernels<2, double>::div(a, s);
+      kernels<2, double>::div(a + 2, s);
+    }
+
+    // the same for 3D vectors padded to 4 lanes, lane 3 is kept unchanged (i.e. zero)
+    static void mul3(double *a, double s) noexcept
+    {
+      __m128d f = _mm_set1_pd(s), zw = _mm_loadu_pd(a + 2);
+      _mm_storeu_pd(a, _mm_mul_pd(_mm_loadu_pd(a), f));
+      _mm_storeu_pd(a + 2, _mm_move_sd(zw, _mm_mul_sd(zw, f)));
+    }
+
+    static void div3(double *a, double s) noexcept
+    {
+      __m128d f = _mm_set1_pd(s), zw = _mm_loadu_pd(a + 2);
+      _mm_storeu_pd(a, _mm_div_pd(_mm_loadu_pd(a), f));
+      _mm_storeu_pd(a + 2, _mm_move_sd(zw, _mm_div_sd(zw, f)));
+    }
+
+    // NB! pairwise order of summation: (x + z) + (y + w)
+    static double dot(const double *a, const double *b) noexcept
+    {
+      __m128d s = _mm_add_pd(
+        _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)),
+        _mm_mul_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+      return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+#endif
+
+    // 3D cross product of padded vectors (x, y, z, w): r = a.yzxw*b.zxyw - a.zxyw*b.yzxw,
+    // so w of the result is zero if the padding lanes are
+#if defined(__AVX2__)
+    static void cross(const double *a, const double *b, double *r) noexcept
+    {
+      __m256d va = _mm256_loadu_pd(a), vb = _mm256_loadu_pd(b);
+      __m256d a_yzx = _mm256_permute4x64_pd(va, _MM_SHUFFLE(3, 0, 2, 1));
+      __m256d a_zxy = _mm256_permute4x64_pd(va, _MM_SHUFFLE(3, 1, 0, 2));
+      __m256d b_yzx = _mm256_permute4x64_pd(vb, _MM_SHUFFLE(3, 0, 2, 1));
+      __m256d b_zxy = _mm256_permute4x64_pd(vb, _MM_SHUFFLE(3, 1, 0, 2));
+      _mm256_storeu_pd(r, _mm256_sub_pd(_mm256_mul_pd(a_yzx, b_zxy), _mm256_mul_pd(a_zxy, b_yzx)));
+    }
+#else
+    static void cross(const double *a, const double *b, double *r) noexcept
+    {
+      __m128d a_xy = _mm_loadu_pd(a), a_zw = _mm_loadu_pd(a + 2);
+      __m128d b_xy = _mm_loadu_pd(b), b_zw = _mm_loadu_pd(b + 2);
+      __m128d a_yz = _mm_shuffle_pd(a_xy, a_zw, 1), a_xw = _mm_shuffle_pd(a_xy, a_zw, 2);
+      __m128d a_zx = _mm_shuffle_pd(a_zw, a_xy, 0), a_yw = _mm_shuffle_pd(a_xy, a_zw, 3);
+      __m128d b_yz = _mm_shuffle_pd(b_xy, b_zw, 1), b_xw = _mm_shuffle_pd(b_xy, b_zw, 2);
+      __m128d b_zx = _mm_shuffle_pd(b_zw, b_xy, 0), b_yw = _mm_shuffle_pd(b_xy, b_zw, 3);
+      _mm_storeu_pd(r, _mm_sub_pd(_mm_mul_pd(a_yz, b_zx), _mm_mul_pd(a_zx, b_yz)));
+      _mm_storeu_pd(r + 2, _mm_sub_pd(_mm_mul_pd(a_xw, b_yw), _mm_mul_pd(a_yw, b_xw)));
+    }
+#endif
+  }; // struct kernels<4, double>
+
+/*---------------------------------------------------------------------------------------*/
+
+  template<> struct kernels<4, float>
+  {
+    static constexpr bool enabled = true;
+
+    static void add(float *a, const float *b) noexcept
+    {
+      _mm_storeu_ps(a, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+    }
+
+    static void sub(float *a, const float *b) noexcept
+    {
+      _mm_storeu_ps(a, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+    }
+
+    static void mul(float *a, float s) noexcept
+    {
+      _mm_storeu_ps(a, _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(s)));
+    }
+
+    static void div(float *a, float s) noexcept
+    {
+      _mm_storeu_ps(a, _mm_div_ps(_mm_loadu_ps(a), _mm_set1_ps(s)));
+    }
+
+    // the same for 3D vectors padded to 4 lanes, lane 3 is kept zero
+    static void mul3(float *a, float s) noexcept
+    {
+      const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+      _mm_storeu_ps(a, _mm_and_ps(_mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(s)), xyz));
+    }
+
+    static void div3(float *a, float s) noexcept
+    {
+      const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+      _mm_storeu_ps(a, _mm_and_ps(_mm_div_ps(_mm_loadu_ps(a), _mm_set1_ps(s)), xyz));
+    }
+
+    // NB! pairwise order of summation: (x + z) + (y + w)
+    static float dot(const float *a, const float *b) noexcept
+    {
+      __m128 m = _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+      __m128 s = _mm_add_ps(m, _mm_movehl_ps(m, m));
+      return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55)));
+    }
+
+    // 3D cross product of padded vectors, see kernels<4, double>::cross
+    static void cross(const float *a, const float *b, float *r) noexcept
+    {
+      __m128 va = _mm_loadu_ps(a), vb = _mm_loadu_ps(b);
+      __m128 a_yzx = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+      __m128 a_zxy = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 1, 0, 2));
+      __m128 b_yzx = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+      __m128 b_zxy = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 1, 0, 2));
+      _mm_storeu_ps(r, _mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx)));
+    }
+  }; // struct kernels<4, float>
+#endif // MATH_SIMD_SSE2
+
+/*---------------------------------------------------------------------------------------*/
+
+  // thin wrappers of the widest available packed registers, used by bulk kernels
+  template<class T> struct packed
+  {
+    static constexpr bool enabled = false;
+  };
+
+#if defined(MATH_SIMD_AVX)
+  template<> struct packed<float>
+  {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 8;
+    using reg = __m256;
+    static reg load(const float *p) noexcept { return _mm256_loadu_ps(p); }
+    static void store(float *p, reg a) noexcept { _mm256_storeu_ps(p, a); }
+    static reg set1(float a) noexcept { return _mm256_set1_ps(a); }
+    static reg zero() noexcept { return _mm256_setzero_ps(); }
+    static reg add(reg a, reg b) noexcept { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm256_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm256_div_ps(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm256_min_ps(a, b); }
+    static reg max(reg a, reg b) noexcept { return _mm256_max_ps(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm256_sqrt_ps(a); }
+    static reg rsqrt(reg a) noexcept { return _mm256_rsqrt_ps(a); }
+    static reg in_range(reg a, reg lo, reg hi) noexcept
+    {
+      return _mm256_and_ps(_mm256_cmp_ps(a, lo, _CMP_GE_OQ), _mm256_cmp_ps(a, hi, _CMP_LE_OQ));
+    }
+    static reg select(reg m, reg a, reg b) noexcept { return _mm256_blendv_ps(b, a, m); }
+  }; // struct packed<float>
+
+  template<> struct packed<double>
+  {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 4;
+    using reg = __m256d;
+    static reg load(const double *p) noexcept { return _mm256_loadu_pd(p); }
+    static void store(double *p, reg a) noexcept { _mm256_storeu_pd(p, a); }
+    static reg set1(double a) noexcept { return _mm256_set1_pd(a); }
+    static reg zero() noexcept { return _mm256_setzero_pd(); }
+    static reg add(reg a, reg b) noexcept { return _mm256_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm256_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm256_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm256_div_pd(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm256_min_pd(a, b); }
+    static reg max(reg a, reg b) noexcept { return _mm256_max_pd(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm256_sqrt_pd(a); }
+  }; // struct packed<double>
+#elif defined(MATH_SIMD_SSE2)
+  template<> struct packed<float>
+  {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 4;
+    using reg = __m128;
+    static reg load(const float *p) noexcept { return _mm_loadu_ps(p); }
+    static void store(float *p, reg a) noexcept { _mm_storeu_ps(p, a); }
+    static reg set1(float a) noexcept { return _mm_set1_ps(a); }
+    static reg zero() noexcept { return _mm_setzero_ps(); }
+    static reg add(reg a, reg b) noexcept { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm_mul_ps(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm_div_ps(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm_min_ps(a, b); }
+    static reg max(reg a, reg b) noexcept { return _mm_max_ps(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm_sqrt_ps(a); }
+    static reg rsqrt(reg a) noexcept { return _mm_rsqrt_ps(a); }
+    static reg in_range(reg a, reg lo, reg hi) noexcept
+    {
+      return _mm_and_ps(_mm_cmpge_ps(a, lo), _mm_cmple_ps(a, hi));
+    }
+    static reg select(reg m, reg a, reg b) noexcept
+    {
+      return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+  }; // struct packed<float>
+
+  template<> struct packed<double>
+  {
+    static constexpr bool enabled = true;
+    static constexpr size_t width = 2;
+    using reg = __m128d;
+    static reg load(const double *p) noexcept { return _mm_loadu_pd(p); }
+    static void store(double *p, reg a) noexcept { _mm_storeu_pd(p, a); }
+    static reg set1(double a) noexcept { return _mm_set1_pd(a); }
+    static reg zero() noexcept { return _mm_setzero_pd(); }
+    static reg add(reg a, reg b) noexcept { return _mm_add_pd(a, b); }
+    static reg sub(reg a, reg b) noexcept { return _mm_sub_pd(a, b); }
+    static reg mul(reg a, reg b) noexcept { return _mm_mul_pd(a, b); }
+    static reg div(reg a, reg b) noexcept { return _mm_div_pd(a, b); }
+    static reg min(reg a, reg b) noexcept { return _mm_min_pd(a, b); }
+    static reg max(reg a, reg b) noexcept { return _mm_max_pd(a, b); }
+    static reg sqrt(reg a) noexcept { return _mm_sqrt_pd(a); }
+  }; // struct packed<double>
+#endif
+} // namespace Math::simd
+
+/*---------------------------------------------------------------------------------------*/
+/*------------------------------------ documentation ------------------------------------*/
+/*---------------------------------------------------------------------------------------*/
+
+/*!
+  \struct Math::simd::allocator
+  \brief Allocator of memory aligned to Math::simd::alignment bytes.
+  \tparam T Type of the elements.
+
+  Used for bulk storage (e.g. Math::VectorField) so that aligned packed loads
+  can be used and no SIMD register or cache line is split at the beginning of an array.
+*/
+
+/*!
+  \struct Math::simd::packed
+  \brief Thin wrapper of the widest packed register of T available (SSE2 or AVX).
+  \tparam T float or double.
+
+  Used by bulk kernels processing long arrays, e.g. Math::sqrt of spans.
+  The primary template has \c enabled == false, callers must provide a scalar fallback.
+  Note that min(a, b) and max(a, b) return b if any of them is NaN, i.e. they
+  match <tt>(a < b)? a : b</tt> and <tt>(b < a)? a : b</tt> correspondingly.
+*/
+
+/*!
+  \struct Math::simd::kernels
+  \brief Packed implementation of the basic vector operations for N components of type T.
+  \tparam N Number of components.
+  \tparam T Type of the components.
+
+  The primary template has \c enabled == false and no kernels at all, in that case
+  Math::Vector uses its generic scalar loops (which is the portable fallback).
+  Specializations exist for the most used combinations, i.e. 2, 3 and 4 doubles
+  and 4 floats, on x86 with SSE2 (always available on x86-64) and AVX if the compiler
+  is allowed to use it (e.g. with NUMKIT_NATIVE_ARCH=ON). All kernels work
+  with unaligned pointers.
+
+  Specializations for 4 components also have kernels for 3D vectors padded to 4 lanes
+  (see Math::Layout::Padded): \c mul3 and \c div3 which keep the padding lane zero
+  even for infinite or zero scalar, and \c cross, the lane 3 of the result is zero
+  as long as it is zero in both arguments.
+
+  Kernels are never called in constant evaluation, so all constexpr functions
+  of Math::Vector stay constexpr. Note that dot product of 4 components is summed
+  pairwise which may differ in the last bit from the sequential constexpr version.
+
+  \see Math::Vector
+*/
+
+#endif // MATH_SIMD_H_INCLUDED
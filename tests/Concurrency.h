@@ -0,0 +1,37 @@
+#ifndef TESTS_CONCURRENCY_H_INCLUDED
+#define TESTS_CONCURRENCY_H_INCLUDED
+
+/*!
+  \file Concurrency.h
+  \author gennadiy
+  \brief Number of threads of the parallel algorithms in the tests of an executable.
+*/
+
+#include "common/Parallel.h"
+#include <gtest/gtest.h>
+#include <cstddef>
+
+namespace Tests
+{
+  // sets the number of threads before the tests, e.g. to run the parallel code paths
+  // on a single core machine too, the default one is restored after them
+  class Concurrency : public testing::Environment
+  {
+    size_t n;
+
+  public:
+    explicit Concurrency(size_t n) noexcept : n(n) {}
+
+    void SetUp() override { Parallel::set_concurrency(n); }
+    void TearDown() override { Parallel::set_concurrency(0); }
+  }; // class Concurrency
+
+  // registers the environment, once per test file at namespace scope:
+  // const auto *threads = Tests::concurrency(4);
+  inline testing::Environment* concurrency(size_t n)
+  {
+    return testing::AddGlobalTestEnvironment(new Concurrency(n));
+  }
+} // namespace Tests
+
+#endif // TESTS_CONCURRENCY_H_INCLUDED
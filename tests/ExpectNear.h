@@ -0,0 +1,31 @@
+#ifndef TESTS_EXPECT_NEAR_H_INCLUDED
+#define TESTS_EXPECT_NEAR_H_INCLUDED
+
+/*!
+  \file ExpectNear.h
+  \author gennadiy
+  \brief Componentwise EXPECT_NEAR of tensors and vectors with the relative tolerance.
+*/
+
+#include "math/Tensor.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+
+namespace Tests
+{
+  template<size_t N> void expect_near(const Math::Tensor<N> &A, const Math::Tensor<N> &B, double eps = 1e-12)
+  {
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        EXPECT_NEAR(A[i][j], B[i][j], eps * (1 + std::fabs(B[i][j])));
+  }
+
+  template<size_t N> void expect_near(const Math::Vector<N> &a, const Math::Vector<N> &b, double eps = 1e-12)
+  {
+    for (size_t i = 0; i < N; ++i)
+      EXPECT_NEAR(a[i], b[i], eps * (1 + std::fabs(b[i])));
+  }
+} // namespace Tests
+
+#endif // TESTS_EXPECT_NEAR_H_INCLUDED
@@ -0,0 +1,44 @@
+#ifndef TESTS_RANDOM_TENSORS_H_INCLUDED
+#define TESTS_RANDOM_TENSORS_H_INCLUDED
+
+/*!
+  \file RandomTensors.h
+  \author gennadiy
+  \brief Reproducible random tensors and vectors of the tests and the benchmarks.
+*/
+
+#include "math/Tensor.h"
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace Tests
+{
+  // components in [-1, 1] plus N on the diagonal, i.e. diagonally dominant, thus well conditioned
+  template<size_t N> Math::Tensor<N> random_tensor(unsigned seed = 42)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    Math::Tensor<N> A;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        A[i][j] = dist(gen);
+    return A + Math::Tensor<N>(double(N));
+  }
+
+  // n vectors of components in [-1, 1], e.g. right hand sides
+  template<size_t N> std::vector<Math::Vector<N>> random_vectors(size_t n, unsigned seed = 7)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<Math::Vector<N>> v(n);
+    for (auto &x : v)
+      for (size_t i = 0; i < N; ++i)
+        x[i] = dist(gen);
+    return v;
+  }
+
+  template<size_t N> Math::Vector<N> random_vector(unsigned seed = 7) { return random_vectors<N>(1, seed)[0]; }
+} // namespace Tests
+
+#endif // TESTS_RANDOM_TENSORS_H_INCLUDED
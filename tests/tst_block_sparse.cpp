@@ -0,0 +1,152 @@
+#include "math/BlockSparse.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // 7-point stencil of a nx^3 grid, the columns of a row are shuffled
+  Ragged<std::uint32_t> stencil(size_t nx)
+  {
+    std::mt19937 gen(42);
+    std::vector<std::vector<std::uint32_t>> rows(nx*nx*nx);
+    for (size_t i = 0; i < nx; ++i)
+      for (size_t j = 0; j < nx; ++j)
+        for (size_t k = 0; k < nx; ++k)
+        {
+          auto &r = rows[(i*nx + j)*nx + k];
+          const auto cell = [nx](size_t i, size_t j, size_t k) { return std::uint32_t((i*nx + j)*nx + k); };
+          r.push_back(cell(i, j, k));
+          if (i > 0) r.push_back(cell(i - 1, j, k));
+          if (j > 0) r.push_back(cell(i, j - 1, k));
+          if (k > 0) r.push_back(cell(i, j, k - 1));
+          if (i + 1 < nx) r.push_back(cell(i + 1, j, k));
+          if (j + 1 < nx) r.push_back(cell(i, j + 1, k));
+          if (k + 1 < nx) r.push_back(cell(i, j, k + 1));
+          std::shuffle(r.begin(), r.end(), gen);
+        }
+    return Ragged<std::uint32_t>::from_rows(rows);
+  }
+
+  template<size_t N> void randomize(BlockSparse<N> &A)
+  {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (auto &B : A.values())
+      for (auto &x : B)
+        x = dist(gen);
+  }
+
+  template<size_t N> std::vector<Vector<N>> random_vectors(size_t n)
+  {
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<Vector<N>> v(n);
+    for (auto &x : v)
+      for (size_t i = 0; i < N; ++i)
+        x[i] = dist(gen);
+    return v;
+  }
+
+  // y = A x and y = ~A x by the blocks one by one
+  template<size_t N> std::vector<Vector<N>> reference(const BlockSparse<N> &A, const std::vector<Vector<N>> &x,
+                                                      bool transpose)
+  {
+    std::vector<Vector<N>> y(transpose? A.ncols() : A.nrows());
+    for (size_t i = 0; i < A.nrows(); ++i)
+      for (size_t k = 0; k < A.columns(i).size(); ++k)
+      {
+        const size_t j = A.columns(i)[k];
+        if (transpose)
+          y[j] += x[i] * A.row(i)[k];
+        else
+          y[i] += A.row(i)[k] * x[j];
+      }
+    return y;
+  }
+
+  template<size_t N> void expect_near(const std::vector<Vector<N>> &a, const std::vector<Vector<N>> &b)
+  {
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t k = 0; k < a.size(); ++k)
+      for (size_t i = 0; i < N; ++i)
+        ASSERT_NEAR(a[k][i], b[k][i], 1e-13) << k;
+  }
+
+  template<size_t N> void check_products(const BlockSparse<N> &A)
+  {
+    const auto x = random_vectors<N>(A.ncols()), xt = random_vectors<N>(A.nrows());
+    std::vector<Vector<N>> y(A.nrows()), yt(A.ncols());
+    multiply(A, x, y);
+    multiply_transpose(A, xt, yt);
+    expect_near(y, reference(A, x, false));
+    expect_near(yt, reference(A, xt, true));
+  }
+
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(4);
+} // namespace
+
+TEST(BlockSparse, pattern)
+{
+  BlockSparse<3> A(stencil(4), 64);
+  EXPECT_EQ(A.nrows(), 64);
+  EXPECT_EQ(A.ncols(), 64);
+  EXPECT_EQ(A.nblocks(), 64 + 6*48);
+  EXPECT_EQ(A.index().offsets().back(), A.nblocks());
+  for (size_t i = 0; i < A.nrows(); ++i)
+  {
+    EXPECT_TRUE(std::ranges::is_sorted(A.columns(i)));
+    EXPECT_EQ(A.row(i).size(), A.columns(i).size());
+  }
+  EXPECT_EQ(A.values()[0], Tensor3D());
+
+  // find() gives the blocks of the rows and nothing outside of the pattern
+  *A.find(5, 21) = Tensor3D(2.);
+  EXPECT_EQ(A.row(5)[std::ranges::find(A.columns(5), 21u) - A.columns(5).begin()], Tensor3D(2.));
+  EXPECT_EQ(A.find(5, 5), &A.row(5)[std::ranges::find(A.columns(5), 5u) - A.columns(5).begin()]);
+  EXPECT_EQ(A.find(5, 7), nullptr);
+  EXPECT_EQ(std::as_const(A).find(0, 63), nullptr);
+}
+
+TEST(BlockSparse, multiply)
+{
+  BlockSparse<3> A(stencil(6), 216);
+  randomize(A);
+  check_products(A);
+
+  BlockSparse<4> B(stencil(5), 125);
+  randomize(B);
+  check_products(B);
+
+  // rectangular with empty rows
+  Ragged<std::uint32_t> pattern(std::vector<size_t>{2, 0, 1, 0});
+  std::ranges::copy(std::vector<std::uint32_t>{6, 1}, pattern[0].begin());
+  pattern[2][0] = 3;
+  BlockSparse<2> C(std::move(pattern), 7);
+  randomize(C);
+  check_products(C);
+
+  // empty
+  check_products(BlockSparse<2>());
+}
+
+TEST(BlockSparse, threads)
+{
+  // the chunks of the rows and their column ranges overlap in the transposed product
+  BlockSparse<3> A(stencil(28), 28*28*28);
+  ASSERT_EQ(Parallel::partition(A.nrows(), 1 << 12).nchunks, 4);
+  randomize(A);
+  check_products(A);
+
+  // the same result for the same number of threads
+  const auto x = random_vectors<3>(A.nrows());
+  std::vector<Vector3D> y1(A.ncols()), y2(A.ncols());
+  multiply_transpose(A, x, y1);
+  multiply_transpose(A, x, y2);
+  EXPECT_EQ(y1, y2);
+}
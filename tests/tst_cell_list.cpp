@@ -0,0 +1,150 @@
+#include "math/CellList.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  template<size_t N> std::vector<Vector<N>> random_points(size_t n, double size, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(0, size);
+    std::vector<Vector<N>> v(n);
+    for (auto &x : v)
+      for (size_t c = 0; c < N; ++c)
+        x[c] = dist(gen);
+    return v;
+  }
+
+  // original indices of the neighbours found by the cell list, sorted
+  template<size_t N> std::vector<size_t> found(const CellList<N> &cells, const Vector<N> &q)
+  {
+    std::vector<size_t> r;
+    cells.neighbours(q, [&](size_t k, double d2)
+    {
+      EXPECT_DOUBLE_EQ(d2, (cells.points()[k] - q) * (cells.points()[k] - q));
+      r.push_back(cells.indices()[k]);
+    });
+    std::sort(r.begin(), r.end());
+    return r;
+  }
+
+  template<size_t N> std::vector<size_t> brute_force(const std::vector<Vector<N>> &v, const Vector<N> &q, double rc)
+  {
+    std::vector<size_t> r;
+    for (size_t i = 0; i < v.size(); ++i)
+      if ((v[i] - q) * (v[i] - q) <= rc * rc)
+        r.push_back(i);
+    return r;
+  }
+
+  template<size_t N> void check(size_t n, double size, double rc)
+  {
+    auto v = random_points<N>(n, size, 1);
+    CellList<N> cells(rc, v);
+    ASSERT_EQ(cells.size(), n);
+    EXPECT_GE(cells.cell_size(), rc);
+    EXPECT_LE(cells.ncells(), std::max<size_t>(n, 1));
+
+    // queries inside and around the box
+    for (auto &q : random_points<N>(200, 1.2 * size, 2))
+    {
+      auto p = q - Vector<N>(0.1 * size);
+      EXPECT_EQ(found(cells, p), brute_force(v, p, rc));
+    }
+  }
+
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(4);
+} // namespace
+
+TEST(CellList, neighbours_3d)
+{
+  check<3>(50000, 10., 0.3);
+  check<3>(1000, 10., 2.);
+}
+
+TEST(CellList, neighbours_2d)
+{
+  check<2>(20000, 10., 0.1);
+}
+
+TEST(CellList, sparse_points_enlarge_cells)
+{
+  check<3>(10, 100., 0.5);
+  check<3>(1, 1., 0.5);
+}
+
+TEST(CellList, wide_domain_small_cutoff)
+{
+  // extent / rc is far beyond the range of uint32_t, the pairs of close points are found anyway
+  const double rc = 1e-5;
+  auto v = random_points<3>(2000, 1e6, 6);
+  for (size_t i = 0; i < 2000; ++i)
+    v.push_back(v[i] + Vector3D(0.5 * rc, 0, 0));
+  CellList<3> cells(rc, v);
+  EXPECT_LE(cells.ncells(), v.size());
+  for (size_t i = 0; i < v.size(); i += 13)
+    EXPECT_EQ(found(cells, v[i]), brute_force(v, v[i], rc)) << i;
+}
+
+TEST(CellList, neighbours_of_exclude_self)
+{
+  auto v = random_points<3>(5000, 5., 3);
+  CellList<3> cells(0.4, v);
+  for (size_t k = 0; k < cells.size(); k += 7)
+  {
+    std::vector<size_t> r;
+    cells.neighbours_of(k, [&](size_t j, double) { r.push_back(cells.indices()[j]); });
+    std::sort(r.begin(), r.end());
+
+    size_t i = cells.indices()[k];
+    auto expected = brute_force(v, v[i], 0.4);
+    expected.erase(std::find(expected.begin(), expected.end(), i));
+    EXPECT_EQ(r, expected);
+  }
+}
+
+TEST(CellList, rebuild_moving_points)
+{
+  auto v = random_points<3>(20000, 4., 4);
+  CellList<3> cells(0.25);
+  for (int step = 0; step < 3; ++step)
+  {
+    for (auto &x : v)
+      x += Vector3D(0.5, -0.25, 0.1);
+    cells.rebuild(v);
+    Vector3D q(2, 1, 3);
+    q += static_cast<double>(step) * Vector3D(0.5, -0.25, 0.1);
+    EXPECT_EQ(found(cells, q), brute_force(v, q, 0.25));
+  }
+}
+
+TEST(CellList, cell_order_is_deterministic)
+{
+  auto v = random_points<3>(100000, 10., 5);
+  CellList<3> a(0.5, v);
+  Parallel::set_concurrency(1);
+  CellList<3> b(0.5, v);
+  Parallel::set_concurrency(4); // back to the threads of the tests
+  EXPECT_TRUE(std::equal(a.indices().begin(), a.indices().end(), b.indices().begin(), b.indices().end()));
+}
+
+TEST(CellList, degenerate_sets)
+{
+  CellList<3> cells(1., std::vector<Vector3D>{});
+  EXPECT_EQ(cells.size(), 0u);
+  EXPECT_TRUE(found(cells, Vector3D()).empty());
+
+  std::vector<Vector3D> same(100, Vector3D(1, 1, 1));
+  cells.rebuild(same);
+  EXPECT_EQ(cells.ncells(), 1u);
+  EXPECT_TRUE(std::is_sorted(cells.indices().begin(), cells.indices().end())); // points of a cell keep their order
+  EXPECT_EQ(found(cells, Vector3D(1.5, 1, 1)).size(), 100u);
+  EXPECT_TRUE(found(cells, Vector3D(3, 1, 1)).empty());
+}
@@ -0,0 +1,131 @@
+#include "math/Dual.h"
+#include "quantities/State.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace Math;
+
+namespace
+{
+  using D3 = Dual<double, 3>;
+
+  // residual of a nonlinear system, the same code for doubles and duals
+  template<class T> Vector<3, T> residual(const Vector<3, T> &x)
+  {
+    using std::exp, std::sin, std::sqrt;
+    return Vector<3, T>(
+      x[0] * x[1] - exp(x[2]) + 1,
+      sin(x[0]) + x[1] * x[1] * x[2] - 2,
+      sqrt(x * x) - x[2] / x[0]);
+  }
+
+  // central finite differences
+  Tensor3D numerical_jacobian(const Vector3D &x)
+  {
+    const double h = 1e-6;
+    Tensor3D J;
+    for (size_t j = 0; j < 3; ++j)
+    {
+      Vector3D xp = x, xm = x;
+      xp[j] += h;
+      xm[j] -= h;
+      auto df = (residual(xp) - residual(xm)) / (2 * h);
+      for (size_t i = 0; i < 3; ++i)
+        J[i][j] = df[i];
+    }
+    return J;
+  }
+} // namespace
+
+TEST(Dual, elementary_functions)
+{
+  const double x0 = 0.7;
+  auto x = Dual<double, 1>::variable(x0, 0);
+  EXPECT_DOUBLE_EQ(sqrt(x).derivative(0), 0.5 / std::sqrt(x0));
+  EXPECT_DOUBLE_EQ(exp(x).derivative(0), std::exp(x0));
+  EXPECT_DOUBLE_EQ(log(x).derivative(0), 1 / x0);
+  EXPECT_DOUBLE_EQ(sin(x).derivative(0), std::cos(x0));
+  EXPECT_DOUBLE_EQ(cos(x).derivative(0), -std::sin(x0));
+  EXPECT_DOUBLE_EQ(pow(x, 2.5).derivative(0), 2.5 * std::pow(x0, 1.5));
+  EXPECT_DOUBLE_EQ(details::sqrt(x).value(), std::sqrt(x0));
+
+  // composition
+  auto f = exp(sin(x) * x) / (1 + x * x);
+  double g = std::exp(std::sin(x0) * x0), h = 1 + x0 * x0;
+  EXPECT_DOUBLE_EQ(f.value(), g / h);
+  EXPECT_DOUBLE_EQ(f.derivative(0), g * (std::cos(x0) * x0 + std::sin(x0)) / h - g * 2 * x0 / (h * h));
+}
+
+TEST(Dual, jacobian_of_residual)
+{
+  const Vector3D x(0.8, 1.3, 0.4);
+  auto r = residual(variables<3>(x));
+  auto J = jacobian(r);
+  auto Jn = numerical_jacobian(x);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    EXPECT_DOUBLE_EQ(r[i].value(), residual(x)[i]);
+    for (size_t j = 0; j < 3; ++j)
+      EXPECT_NEAR(J[i][j], Jn[i][j], 1e-8) << i << j;
+  }
+}
+
+TEST(Dual, newton_solve)
+{
+  // residual(x) = residual(x0) from a nearby point, the exact Jacobian gives the quadratic convergence
+  const Vector3D x0(0.8, 1.3, 0.4), r0 = residual(x0);
+  Vector3D x = x0 + Vector3D(0.1, -0.1, 0.05);
+  double norm = 1;
+  for (int it = 0; it < 10 && norm > 1e-15; ++it)
+  {
+    auto r = residual(variables<3>(x));
+    Vector3D f(r[0].value() - r0[0], r[1].value() - r0[1], r[2].value() - r0[2]);
+    if (norm < 1e-4 && norm > 1e-12)
+    {
+      EXPECT_LT(fabs(f), 1e3 * norm * norm);
+    }
+    norm = fabs(f);
+    x -= jacobian(r).invert() * f;
+  }
+  EXPECT_LT(fabs(residual(x) - r0), 1e-15);
+}
+
+TEST(Dual, lanes_offset)
+{
+  // 2 variables of a vector and a scalar one in the same 3 lanes
+  auto v = variables<3>(Vector2D(2, 5));
+  auto t = D3::variable(0.5, 2);
+  auto f = v * v * t; // t |v|^2
+  EXPECT_DOUBLE_EQ(f.derivative(0), 2);
+  EXPECT_DOUBLE_EQ(f.derivative(1), 5);
+  EXPECT_DOUBLE_EQ(f.derivative(2), 29);
+}
+
+TEST(Dual, state_of_duals)
+{
+  using rho_t = Quantities::Traits<D3, 3, "rho">;
+  using p_t = Quantities::Traits<D3, 3, "p">;
+  constexpr rho_t rho;
+  constexpr p_t p;
+
+  Quantities::State<rho_t, p_t> s(D3::variable(2, 0), D3::variable(3, 1));
+  auto m = s * D3(0.5) + s;
+  EXPECT_DOUBLE_EQ(m[rho].value(), 3);
+  EXPECT_DOUBLE_EQ(m[rho].derivative(0), 1.5);
+  EXPECT_DOUBLE_EQ(m[p].derivative(1), 1.5);
+  EXPECT_DOUBLE_EQ(m[p].derivative(0), 0);
+
+  // sound speed squared, gamma p / rho, and its derivatives
+  auto c2 = 1.4 * s[p] / s[rho];
+  EXPECT_DOUBLE_EQ(c2.value(), 2.1);
+  EXPECT_DOUBLE_EQ(c2.derivative(0), -1.05);
+  EXPECT_DOUBLE_EQ(c2.derivative(1), 0.7);
+}
+
+TEST(Dual, output)
+{
+  std::stringstream out;
+  out << Dual<double, 2>::variable(1.5, 1);
+  EXPECT_EQ(out.str(), "1.5[0, 1]");
+}
@@ -0,0 +1,191 @@
+#include "math/Eigensystem.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  template<size_t N> SymTensor<N> random_sym(std::mt19937 &gen)
+  {
+    std::uniform_real_distribution<double> dist(-1, 1);
+    SymTensor<N> A;
+    for (auto &x : A)
+      x = dist(gen);
+    return A;
+  }
+
+  // ~R diag(l) R with a random rotation R, e.g. with repeated eigenvalues
+  SymTensor3D rotated(const Vector3D &l, std::mt19937 &gen)
+  {
+    std::uniform_real_distribution<double> dist(-1, 1);
+    Vector3D a(dist(gen), dist(gen), dist(gen)), b(dist(gen), dist(gen), dist(gen));
+    a = normalize(a);
+    b = normalize(b - (a * b) * a);
+    const auto c = a % b;
+    SymTensor3D A;
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = i; j < 3; ++j)
+        A(i, j) = l[0]*a[i]*a[j] + l[1]*b[i]*b[j] + l[2]*c[i]*c[j];
+    return A;
+  }
+
+  // eigenvalues are accurate relative to the largest |l|, not to themselves
+  template<size_t N> double max_abs(const Vector<N> &l)
+  {
+    double scale = 1e-300;
+    for (size_t k = 0; k < N; ++k)
+      scale = std::max(scale, fabs(l[k]));
+    return scale;
+  }
+
+  template<size_t N> void expect_near(const Vector<N> &l, const Vector<N> &r, double eps = 1e-14)
+  {
+    for (size_t k = 0; k < N; ++k)
+      EXPECT_NEAR(l[k], r[k], eps * max_abs(r));
+  }
+
+  // A v = l v, orthonormal vectors and ascending values
+  template<size_t N> void check(const SymTensor<N> &A, const Eigensystem<N> &e, double eps = 1e-13)
+  {
+    const double scale = max_abs(e.values);
+
+    for (size_t k = 0; k < N; ++k)
+    {
+      Vector<N> v;
+      for (size_t j = 0; j < N; ++j)
+        v[j] = e.vectors[k][j];
+      const auto r = A * v - e.values[k] * v;
+      EXPECT_LE(fabs(r), eps * scale) << A << " " << k;
+      for (size_t j = 0; j < N; ++j)
+      {
+        double d = 0;
+        for (size_t i = 0; i < N; ++i)
+          d += e.vectors[k][i] * e.vectors[j][i];
+        EXPECT_NEAR(d, (j == k)? 1. : 0., 1e-14) << A << " " << k << " " << j;
+      }
+      if (k > 0)
+      {
+        EXPECT_LE(e.values[k - 1], e.values[k]);
+      }
+    }
+  }
+
+  template<size_t N> TensorField<N> to_field(const std::vector<SymTensor<N>> &v)
+  {
+    TensorField<N> f(v.size());
+    for (size_t k = 0; k < v.size(); ++k)
+      f.set(k, Tensor<N>(v[k]));
+    return f;
+  }
+
+  template<size_t N> Eigensystem<N> get(const VectorField<N> &values, const TensorField<N> &vectors, size_t k)
+  {
+    Eigensystem<N> e;
+    e.values = values[k];
+    e.vectors = vectors[k];
+    return e;
+  }
+
+  // random, isotropic, uniaxial and zero ones
+  std::vector<SymTensor3D> tensors3()
+  {
+    std::mt19937 gen(42);
+    std::vector<SymTensor3D> v;
+    for (int k = 0; k < 1000; ++k)
+      v.push_back(random_sym<3>(gen));
+    v.push_back(SymTensor3D());
+    v.push_back(SymTensor3D(3.));
+    v.push_back(SymTensor3D(1., 1., 5.));
+    v.push_back(SymTensor3D(-2., 4., 4.));
+    for (int k = 0; k < 20; ++k)
+    {
+      v.push_back(rotated(Vector3D(1, 1, 5), gen));
+      v.push_back(rotated(Vector3D(-7, 2, 2), gen));
+      v.push_back(rotated(Vector3D(1e6, 1, 1 + 1e-9), gen));
+    }
+    return v;
+  }
+} // namespace
+
+TEST(Eigensystem, analytic_2d)
+{
+  std::mt19937 gen(42);
+  for (int k = 0; k < 1000; ++k)
+  {
+    const auto A = random_sym<2>(gen);
+    const auto e = eigen(A);
+    check(A, e);
+    EXPECT_EQ(eigenvalues(A), e.values);
+  }
+  check(SymTensor2D(), eigen(SymTensor2D()));
+  check(SymTensor2D(2.), eigen(SymTensor2D(2.)));
+  EXPECT_EQ(eigen(SymTensor2D(3., 1.)).values, Vector2D(1, 3));
+}
+
+TEST(Eigensystem, analytic_3d)
+{
+  for (const auto &A : tensors3())
+  {
+    const auto e = eigen(A);
+    check(A, e);
+    expect_near(eigenvalues(A), e.values);
+  }
+  EXPECT_EQ(eigen(SymTensor3D(2.)).values, Vector3D(2, 2, 2));
+  EXPECT_EQ(eigen(SymTensor3D(2.)).vectors * ~eigen(SymTensor3D(2.)).vectors, Tensor3D(1.));
+}
+
+TEST(Eigensystem, jacobi)
+{
+  std::mt19937 gen(7);
+  for (int k = 0; k < 100; ++k)
+  {
+    const auto A = random_sym<2>(gen);
+    check(A, eigen_jacobi(A));
+  }
+  for (const auto &A : tensors3())
+  {
+    const auto e = eigen_jacobi(A), a = eigen(A);
+    check(A, e, 1e-14);
+    expect_near(e.values, a.values);
+  }
+}
+
+TEST(Eigensystem, batched)
+{
+  // odd size for the remainders of the blocks and the vectorized loops
+  const auto v = tensors3();
+  const auto A = to_field(v);
+  VectorField<3> values(A.size()), lj(A.size()), l(A.size());
+  TensorField<3> vectors(A.size()), vj(A.size());
+  eigen(A, values, vectors);
+  eigen_jacobi(A, lj, vj);
+  eigenvalues(A, l);
+  for (size_t k = 0; k < A.size(); ++k)
+  {
+    check(v[k], get(values, vectors, k));
+    check(v[k], get(lj, vj, k), 1e-14);
+    const auto e = eigen(v[k]);
+    expect_near(values.get(k), e.values);
+    expect_near(l.get(k), e.values);
+  }
+
+  std::mt19937 gen(42);
+  std::vector<SymTensor2D> v2(301, SymTensor2D(1.));
+  for (size_t k = 1; k < v2.size(); ++k)
+    v2[k] = random_sym<2>(gen);
+  const auto A2 = to_field(v2);
+  VectorField<2> values2(A2.size()), lj2(A2.size()), l2(A2.size());
+  TensorField<2> vectors2(A2.size()), vj2(A2.size());
+  eigen(A2, values2, vectors2);
+  eigen_jacobi(A2, lj2, vj2);
+  eigenvalues(A2, l2);
+  for (size_t k = 0; k < A2.size(); ++k)
+  {
+    check(v2[k], get(values2, vectors2, k));
+    check(v2[k], get(lj2, vj2, k));
+    EXPECT_EQ(l2.get(k), values2.get(k));
+  }
+}
@@ -0,0 +1,83 @@
+#include "math/Expression.h"
+#include "math/Tensor.h"
+
+#include <gtest/gtest.h>
+
+using namespace Math;
+
+using V3d = Vector<3>;
+using V3i = Vector<3, int>;
+
+TEST(Expression, sum_of_vectors)
+{
+  V3d a(1, 2, 3), b(4, 5, 6), c(7, 8, 9);
+  V3d r = lazy(a) + b + c;
+  EXPECT_EQ(r, a + b + c);
+}
+
+TEST(Expression, mixed_expression)
+{
+  V3d a(1, 2, 3), b(-4, 5, 0.5), c(7, 8, 9);
+  double dt = 0.1;
+  V3d r = lazy(a) + 2.*lazy(b) - lazy(c)/dt;
+  EXPECT_EQ(r, a + 2.*b - c/dt);
+}
+
+TEST(Expression, unary_minus)
+{
+  V3i a(1, -2, 3);
+  V3i r = -lazy(a) + a;
+  EXPECT_EQ(r, V3i(0));
+}
+
+TEST(Expression, eval)
+{
+  V3i a(1, 2, 3), b(3, 2, 1);
+  auto r = eval(lazy(a) * 2 - b);
+  static_assert(std::is_same_v<decltype(r), V3i>);
+  EXPECT_EQ(r, V3i(-1, 2, 5));
+}
+
+TEST(Expression, assign_with_aliasing)
+{
+  V3i a(1, 2, 3), b(1);
+  assign(a, lazy(a) * 3 - b);
+  EXPECT_EQ(a, V3i(2, 5, 8));
+}
+
+TEST(Expression, compound_assignment)
+{
+  V3i a(1, 2, 3), b(1), c(2);
+  a += lazy(b) + c;
+  EXPECT_EQ(a, V3i(4, 5, 6));
+  a -= 2 * lazy(c);
+  EXPECT_EQ(a, V3i(0, 1, 2));
+}
+
+TEST(Expression, dot_product)
+{
+  V3i a(1, 2, 3), b(4, 5, 6), c(1);
+  EXPECT_EQ(lazy(a) * b, a * b);
+  EXPECT_EQ((lazy(a) - c) * (lazy(b) + c), (a - c) * (b + c));
+}
+
+TEST(Expression, arrays)
+{
+  using A4i = Array<4, int>;
+  A4i a(1, 2, 3, 4), b(4, 3, 2, 1);
+  A4i r = lazy(a) + b;
+  EXPECT_EQ(r, A4i(5));
+}
+
+TEST(Expression, tensor_components)
+{
+  using T2i = Tensor<2, int>;
+  using VT = Vector<3, T2i>;
+  VT a(T2i(1, 2, 3, 4), T2i(1), T2i(0, 1, 1, 0));
+  VT b(T2i(2), T2i(1, 1, 1, 1), T2i(5, 6, 7, 8));
+  T2i s(0, 1, 1, 0);
+
+  VT r = lazy(a) + b * s - a;
+  EXPECT_EQ(r, a + b * s - a);
+  EXPECT_EQ(lazy(a) * b, a * b);
+}
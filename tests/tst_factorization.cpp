@@ -0,0 +1,112 @@
+#include "math/Factorization.h"
+#include "ExpectNear.h"
+#include "RandomTensors.h"
+
+#include <gtest/gtest.h>
+
+using namespace Math;
+using namespace Tests;
+
+namespace
+{
+  template<size_t N> Tensor<N> random_spd(unsigned seed = 42)
+  {
+    const auto A = random_tensor<N>(seed);
+    return A * ~A;
+  }
+
+  // A x = b and A X = B for any of the factorizations
+  template<size_t N, class F> void check_solve(const Tensor<N> &A, const F &f)
+  {
+    ASSERT_FALSE(f.singular());
+    const auto b = random_vector<N>();
+    expect_near(A * f.solve(b), b);
+
+    const auto B = random_tensor<N>(3);
+    expect_near(A * f.solve(B), B);
+    expect_near(f.solve(A), Tensor<N>(1));
+    EXPECT_NEAR(f.det(), A.det(), 1e-12 * fabs(A.det()));
+  }
+
+  template<size_t N> void check_all()
+  {
+    const auto A = random_tensor<N>(N);
+    const auto S = random_spd<N>(N);
+
+    check_solve(A, LU<N>(A));
+    check_solve(A, QR<N>(A));
+    check_solve(S, LU<N>(S));
+    check_solve(S, Cholesky<N>(S));
+    check_solve(S, QR<N>(S));
+
+    expect_near(LU<N>(A).invert(), A.invert());
+    expect_near(LU<N>(A).invert() * A, Tensor<N>(1));
+  }
+} // namespace
+
+TEST(Factorization, solve)
+{
+  check_all<3>();
+  check_all<5>();
+  check_all<8>();
+}
+
+TEST(Factorization, factors)
+{
+  const auto S = random_spd<5>();
+  const auto L = Cholesky<5>(S).L();
+  expect_near(L * ~L, S);
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = i + 1; j < 5; ++j)
+      EXPECT_EQ(L[i][j], 0);
+
+  const auto A = random_tensor<5>();
+  const QR<5> qr(A);
+  expect_near(qr.Q() * qr.R(), A);
+  expect_near(qr.Q() * ~qr.Q(), Tensor<5>(1));
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = 0; j < i; ++j)
+      EXPECT_EQ(qr.R()[i][j], 0);
+}
+
+TEST(Factorization, singular)
+{
+  // the last row is the sum of the others
+  auto A = random_tensor<5>();
+  for (size_t j = 0; j < 5; ++j)
+    A[4][j] = A[0][j] + A[1][j] + A[2][j] + A[3][j];
+  const auto b = random_vector<5>();
+
+  EXPECT_TRUE(QR<5>(A).singular());
+  EXPECT_EQ(QR<5>(A).solve(b), Vector<5>());
+  EXPECT_TRUE(LU<5>(Tensor<5>()).singular());
+  EXPECT_EQ(LU<5>(Tensor<5>()).det(), 0);
+  EXPECT_EQ(LU<5>(Tensor<5>()).solve(A), Tensor<5>());
+
+  // indefinite
+  auto S = random_spd<5>();
+  S[2][2] = -1;
+  EXPECT_TRUE(Cholesky<5>(S).singular());
+  EXPECT_EQ(Cholesky<5>(S).det(), 0);
+  EXPECT_EQ(Cholesky<5>(S).solve(b), Vector<5>());
+}
+
+TEST(Factorization, division_operators)
+{
+  // a / A = a A^-1 and B / A = B A^-1 are solved by LU for N > 4
+  const auto A = random_tensor<8>(), B = random_tensor<8>(5);
+  const auto a = random_vector<8>();
+  expect_near(a / A, a * A.invert());
+  expect_near(B / A, B * A.invert());
+
+  auto C = B;
+  C /= A;
+  expect_near(C * A, B);
+
+  // and give zero for singular tensors as multiplication by the zero inverse does
+  EXPECT_EQ(a / Tensor<8>(), Vector<8>());
+  EXPECT_EQ(B / Tensor<8>(), Tensor<8>());
+
+  const auto A3 = random_tensor<3>(), B3 = random_tensor<3>(5);
+  expect_near(B3 / A3, B3 * A3.invert());
+}
@@ -0,0 +1,172 @@
+#include "math/FastMath.h"
+#include "math/Vector.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+TEST(FastMath, runtime_sqrt_real)
+{
+  for (double x : {0., 1e-300, 0.25, 2., 3., 1e10, 1.7e308})
+    EXPECT_EQ(details::sqrt(x), std::sqrt(x));
+  for (float x : {0.f, 1e-40f, 0.25f, 2.f, 3.f, 1e10f})
+    EXPECT_EQ(details::sqrt(x), std::sqrt(x));
+  EXPECT_EQ(details::sqrt(-2.), -1.);
+}
+
+TEST(FastMath, runtime_sqrt_integer)
+{
+  for (long x = 0; x < 10000; ++x)
+  {
+    long r = details::sqrt(x);
+    EXPECT_TRUE(r*r <= x && (r + 1)*(r + 1) > x) << x;
+  }
+
+  // values where conversion to double is inexact
+  const long big = 3037000499L; // floor(sqrt(2^63 - 1))
+  EXPECT_EQ(details::sqrt(big*big), big);
+  EXPECT_EQ(details::sqrt(big*big - 1), big - 1);
+  EXPECT_EQ(details::sqrt(std::numeric_limits<long>::max()), big);
+  EXPECT_EQ(details::sqrt(-4), -1);
+}
+
+TEST(FastMath, runtime_rsqrt)
+{
+  for (float x = 1e-30f; x < 1e30f; x *= 1.37f)
+    EXPECT_NEAR(details::rsqrt(x) * std::sqrt(x), 1.f, 5e-7f) << x;
+  for (double x = 1e-300; x < 1e300; x *= 17.3)
+    EXPECT_DOUBLE_EQ(details::rsqrt(x), 1. / std::sqrt(x));
+
+  EXPECT_EQ(details::rsqrt(0.f), std::numeric_limits<float>::infinity());
+  EXPECT_EQ(details::rsqrt(std::numeric_limits<float>::infinity()), 0.f);
+  EXPECT_TRUE(std::isnan(details::rsqrt(-1.f)));
+}
+
+TEST(FastMath, runtime_hypot)
+{
+  EXPECT_DOUBLE_EQ(details::hypot(3., 4.), 5.);
+  EXPECT_FLOAT_EQ(details::hypot(5.f, -12.f), 13.f);
+}
+
+TEST(FastMath, vector_magnitude)
+{
+  EXPECT_DOUBLE_EQ(fabs(Vector<3>(1, 2, 2)), 3.);
+  EXPECT_FLOAT_EQ(fabs(Vector<4, float>(1, 1, 1, 1)), 2.f);
+  EXPECT_EQ(fabs(Vector<2, int>(6, 8)), 10);
+}
+
+TEST(FastMath, batched_sqrt)
+{
+  std::vector<double> x(37), r(37);
+  std::vector<float> xf(37), rf(37);
+  for (size_t i = 0; i < x.size(); ++i)
+    xf[i] = static_cast<float>(x[i] = 0.5 * i * i + 0.1);
+
+  sqrt(x, r);
+  sqrt(xf, rf);
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    EXPECT_EQ(r[i], std::sqrt(x[i]));
+    EXPECT_EQ(rf[i], std::sqrt(xf[i]));
+  }
+
+  // in-place
+  sqrt(x, x);
+  EXPECT_EQ(x, r);
+}
+
+TEST(FastMath, batched_rsqrt)
+{
+  std::vector<double> x(29), r(29);
+  std::vector<float> xf(29), rf(29);
+  for (size_t i = 0; i < x.size(); ++i)
+    xf[i] = static_cast<float>(x[i] = 1e-3 * (i + 1) * (i + 1) * (i + 1));
+  xf[3] = 0.f;
+  xf[5] = -1.f;
+  xf[7] = 1e-40f; // subnormal
+
+  rsqrt(x, r);
+  rsqrt(xf, rf);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_DOUBLE_EQ(r[i], 1. / std::sqrt(x[i]));
+  for (size_t i = 0; i < xf.size(); ++i)
+  {
+    if (i != 3 && i != 5)
+    {
+      EXPECT_NEAR(rf[i] * std::sqrt(xf[i]), 1.f, 5e-7f) << i;
+    }
+  }
+  EXPECT_EQ(rf[3], std::numeric_limits<float>::infinity());
+  EXPECT_TRUE(std::isnan(rf[5]));
+}
+
+TEST(FastMath, batched_hypot)
+{
+  std::vector<double> x(19), y(19), r(19);
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = 3. * i;
+    y[i] = -4. * i;
+  }
+  hypot(x, y, r);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_DOUBLE_EQ(r[i], 5. * i);
+}
+
+namespace
+{
+  template<size_t N, class T> std::vector<Vector<N, T>> random_vectors(size_t n, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<T> dist(-10, 10);
+    std::vector<Vector<N, T>> v(n);
+    for (auto &x : v)
+      for (size_t k = 0; k < N; ++k)
+        x[k] = dist(gen);
+    return v;
+  }
+
+  template<size_t N, class T> void check_angle_kernels(T tol)
+  {
+    // more than a block with a tail
+    auto a = random_vectors<N, T>(300, 1), b = random_vectors<N, T>(300, 2);
+    std::vector<T> c(a.size()), s(a.size()), r(a.size());
+    std::vector<Vector<N, T>> n(a.size());
+    cos_sin(a, b, c, s);
+    angle(a, b, r);
+    normalize(a, n);
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+      auto [ci, si] = cos_sin(a[i], b[i]);
+      EXPECT_NEAR(c[i], ci, tol);
+      EXPECT_NEAR(s[i], si, tol);
+      EXPECT_NEAR(c[i]*c[i] + s[i]*s[i], T(1), tol);
+      EXPECT_NEAR(r[i], angle(a[i], b[i]), tol);
+      EXPECT_NEAR(r[i], std::acos(std::clamp(c[i], T(-1), T(1))), std::sqrt(tol));
+      for (size_t k = 0; k < N; ++k)
+        EXPECT_NEAR(n[i][k], normalize(a[i])[k], tol);
+    }
+
+    // in place
+    normalize(a, a);
+    EXPECT_EQ(a, n);
+  }
+} // namespace
+
+TEST(FastMath, batched_angles)
+{
+  check_angle_kernels<2, double>(1e-14);
+  check_angle_kernels<3, double>(1e-14);
+  check_angle_kernels<4, double>(1e-14);
+  check_angle_kernels<3, float>(1e-5f);
+
+  std::vector<PaddedVector3D> a = {PaddedVector3D(1, 0, 0)}, b = {PaddedVector3D(0, 0, -2)};
+  std::vector<double> c(1), s(1);
+  cos_sin(a, b, c, s);
+  EXPECT_NEAR(c[0], 0., 1e-16);
+  EXPECT_DOUBLE_EQ(s[0], 1.);
+}
@@ -0,0 +1,155 @@
+#include "math/Half.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  std::vector<float> random_floats(size_t n, unsigned seed)
+  {
+    // log-uniform magnitudes cover subnormals, normals and overflow
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> exponent(-27, 17), sign(-1, 1);
+    std::vector<float> v(n);
+    for (auto &x : v)
+      x = std::copysign(std::exp2(exponent(gen)), sign(gen));
+    return v;
+  }
+} // namespace
+
+TEST(Half, all_codes_round_trip)
+{
+  for (uint32_t b = 0; b < 0x10000; ++b)
+  {
+    auto h = Half::from_bits(static_cast<uint16_t>(b));
+    float x = static_cast<float>(h);
+    if (std::isnan(x))
+    {
+      EXPECT_TRUE(std::isnan(static_cast<float>(Half(x)))) << b;
+    }
+    else
+    {
+      EXPECT_EQ(Half(x).bits(), b) << b;
+    }
+  }
+}
+
+TEST(Half, rounding_to_nearest_even)
+{
+  for (float x : random_floats(100000, 1))
+  {
+    float r = static_cast<float>(Half(x));
+    if (std::abs(x) >= 65520.f)
+    {
+      EXPECT_TRUE(std::isinf(r));
+      continue;
+    }
+
+    // the neighbours of the result are not closer, ties go to the even code
+    auto h = Half(x).bits();
+    for (int d : {-1, 1})
+    {
+      float y = static_cast<float>(Half::from_bits(static_cast<uint16_t>(h + d)));
+      if (std::isfinite(y) && std::signbit(y) == std::signbit(r))
+      {
+        EXPECT_LE(std::abs(r - x), std::abs(y - x)) << x;
+        if (std::abs(r - x) == std::abs(y - x))
+        {
+          EXPECT_EQ(h & 1, 0) << x;
+        }
+      }
+    }
+  }
+}
+
+TEST(Half, bfloat16)
+{
+  for (uint32_t b = 0; b < 0x10000; ++b)
+  {
+    float x = static_cast<float>(BFloat16::from_bits(static_cast<uint16_t>(b)));
+    if (!std::isnan(x))
+    {
+      EXPECT_EQ(BFloat16(x).bits(), b) << b;
+    }
+  }
+  for (float x : random_floats(10000, 2))
+    EXPECT_LE(std::abs(static_cast<float>(BFloat16(x)) - x), std::abs(x) * 0x1p-8f);
+  EXPECT_TRUE(std::isnan(static_cast<float>(BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(Half, bulk_conversions)
+{
+  // odd size to check the tails of the vectorized loops
+  auto f = random_floats(1001, 3);
+  std::vector<double> d(f.begin(), f.end()), d2(f.size());
+  std::vector<float> f2(f.size());
+  std::vector<Half> h(f.size()), h2(f.size());
+  std::vector<BFloat16> b(f.size());
+
+  convert(f, h);
+  convert(d, h2);
+  for (size_t i = 0; i < f.size(); ++i)
+  {
+    ASSERT_EQ(h[i].bits(), Half(f[i]).bits()) << f[i];
+    ASSERT_EQ(h2[i].bits(), Half(f[i]).bits()) << f[i];
+  }
+
+  convert(h, f2);
+  convert(h, d2);
+  for (size_t i = 0; i < f.size(); ++i)
+  {
+    EXPECT_EQ(f2[i], static_cast<float>(h[i]));
+    EXPECT_EQ(d2[i], static_cast<float>(h[i]));
+  }
+
+  convert(d, b);
+  convert(b, f2);
+  for (size_t i = 0; i < f.size(); ++i)
+    EXPECT_EQ(f2[i], static_cast<float>(BFloat16(f[i])));
+}
+
+TEST(Half, vectors_and_tensors)
+{
+  std::vector<Vector3D> v = {Vector3D(1, 2, 3), Vector3D(-0.1, 1e-3, 7e4)};
+  std::vector<Vector<3, Half>> vh(v.size());
+  std::vector<Vector<3, float>> vf(v.size());
+  convert(v, vh);
+  convert(vh, vf);
+  EXPECT_EQ(vf[0], (Vector<3, float>(1, 2, 3)));
+  EXPECT_NEAR(vf[1][0], -0.1f, 1e-4f);
+  EXPECT_TRUE(std::isinf(vf[1][2]));
+
+  std::vector<PaddedVector<3, float>> pf = {PaddedVector<3, float>(1, 2, 3)};
+  std::vector<PaddedVector<3, BFloat16>> pb(1);
+  convert(pf, pb);
+  EXPECT_EQ(pb[0], (PaddedVector<3, BFloat16>(1, 2, 3)));
+
+  std::vector<Tensor2D> t = {Tensor2D(1, 2, 3, 4)}, t2(1);
+  std::vector<Tensor<2, Half>> th(1);
+  convert(t, th);
+  EXPECT_EQ(th[0].det(), Half(-2));
+  EXPECT_EQ(th[0].invert(), (Tensor<2, Half>(-2, 1, 1.5, -0.5)));
+  convert(th, t2);
+  EXPECT_EQ(t2[0], t[0]);
+
+  // norms and angles through sqrt in float
+  const Vector<3, Half> a(1, 2, 2), b(2, -2, 1);
+  EXPECT_EQ(fabs(a), Half(3));
+  EXPECT_EQ(cos(a, b), Half(0));
+  EXPECT_NEAR(float(sin(a, b)), 1.f, 1e-3f);
+  EXPECT_NEAR(float(normalize(a)[2]), 2.f/3, 1e-3f);
+}
+
+TEST(Half, io)
+{
+  std::stringstream s;
+  s << Vector<2, Half>(0.5, -3);
+  Vector<2, Half> v;
+  s >> v;
+  EXPECT_EQ(v, (Vector<2, Half>(0.5, -3)));
+}
@@ -0,0 +1,155 @@
+#include "math/KdTree.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  template<size_t N, class T> std::vector<Vector<N, T>> random_points(size_t n, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<T> dist(-1, 1);
+    std::vector<Vector<N, T>> v(n);
+    for (auto &x : v)
+      for (size_t c = 0; c < N; ++c)
+        x[c] = dist(gen);
+    return v;
+  }
+
+  // all the points sorted by distance
+  template<size_t N, class T>
+    std::vector<Neighbour<T>> brute_force(const std::vector<Vector<N, T>> &v, const Vector<N, T> &q)
+  {
+    std::vector<Neighbour<T>> r(v.size());
+    for (size_t i = 0; i < v.size(); ++i)
+      r[i] = {i, (v[i] - q) * (v[i] - q)};
+    std::stable_sort(r.begin(), r.end(), [](auto &a, auto &b) { return a.sqr_distance < b.sqr_distance; });
+    return r;
+  }
+
+  template<size_t N, class T> void check_knn(size_t n, size_t k, size_t leaf_size)
+  {
+    auto v = random_points<N, T>(n, 1);
+    auto q = random_points<N, T>(200, 2);
+    KdTree<N, T> tree(v, leaf_size);
+    ASSERT_EQ(tree.size(), n);
+
+    std::vector<Neighbour<T>> result(q.size() * k);
+    tree.knn(q, k, result);
+    for (size_t j = 0; j < q.size(); ++j)
+    {
+      auto expected = brute_force(v, q[j]);
+      for (size_t i = 0; i < k; ++i)
+      {
+        // random points have no ties
+        EXPECT_EQ(result[j*k + i].index, expected[i].index);
+        EXPECT_EQ(result[j*k + i].sqr_distance, expected[i].sqr_distance);
+      }
+    }
+  }
+
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(4);
+} // namespace
+
+TEST(KdTree, knn_3d)
+{
+  check_knn<3, double>(10000, 8, 8);
+  check_knn<3, double>(1001, 1, 1);
+  check_knn<3, float>(3000, 5, 16);
+}
+
+TEST(KdTree, knn_2d_and_4d)
+{
+  check_knn<2, double>(5000, 4, 8);
+  check_knn<4, double>(2000, 3, 4);
+}
+
+TEST(KdTree, small_trees)
+{
+  for (size_t n : {1, 2, 3, 7, 9})
+    check_knn<3, double>(n, n, 2);
+}
+
+TEST(KdTree, single_queries)
+{
+  auto v = random_points<3, double>(2000, 3);
+  KdTree<3, double> tree(v);
+  for (auto &q : random_points<3, double>(100, 4))
+  {
+    auto expected = brute_force(v, q);
+    EXPECT_EQ(tree.nearest(q), expected[0]);
+    auto knn = tree.knn(q, 10);
+    EXPECT_TRUE(std::equal(knn.begin(), knn.end(), expected.begin()));
+  }
+  // points of the tree are their own nearest
+  for (size_t i = 0; i < v.size(); i += 97)
+    EXPECT_EQ(tree.nearest(v[i]), (Neighbour<double>{i, 0.}));
+}
+
+TEST(KdTree, radius)
+{
+  auto v = random_points<3, double>(20000, 5);
+  auto q = random_points<3, double>(300, 6);
+  KdTree<3, double> tree(v);
+
+  std::vector<size_t> offsets, result;
+  tree.radius(q, 0.2, offsets, result);
+  ASSERT_EQ(offsets.size(), q.size() + 1);
+  for (size_t j = 0; j < q.size(); ++j)
+  {
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < v.size(); ++i)
+      if ((v[i] - q[j]) * (v[i] - q[j]) <= 0.04)
+        expected.push_back(i);
+    std::vector<size_t> found(result.begin() + offsets[j], result.begin() + offsets[j + 1]);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+  }
+
+  auto single = tree.radius(q[0], 0.2);
+  EXPECT_EQ(single.size(), offsets[1]);
+}
+
+TEST(KdTree, duplicates)
+{
+  std::vector<Vector3D> v(100, Vector3D(1, 2, 3));
+  v.push_back(Vector3D(0, 0, 0));
+  KdTree<3, double> tree(v, 4);
+  EXPECT_EQ(tree.nearest(Vector3D(0.1, 0, 0)).index, 100u);
+  auto knn = tree.knn(Vector3D(1, 2, 3), 100);
+  EXPECT_TRUE(std::all_of(knn.begin(), knn.end(), [](auto &n) { return n.index < 100 && n.sqr_distance == 0; }));
+  EXPECT_EQ(tree.radius(Vector3D(1, 2, 3), 0).size(), 100u);
+}
+
+TEST(KdTree, tree_order)
+{
+  auto v = random_points<3, double>(1000, 7);
+  KdTree<3, double> tree(v);
+  auto p = tree.points();
+  auto i = tree.indices();
+  ASSERT_EQ(p.size(), v.size());
+  for (size_t j = 0; j < p.size(); ++j)
+    EXPECT_EQ(p[j], v[i[j]]);
+  std::vector<size_t> identity(v.size()), sorted(i.begin(), i.end());
+  std::iota(identity.begin(), identity.end(), size_t(0));
+  std::ranges::sort(sorted);
+  EXPECT_EQ(sorted, identity);
+}
+
+TEST(KdTree, empty)
+{
+  KdTree<3, double> tree(std::vector<Vector3D>{});
+  EXPECT_TRUE(tree.empty());
+  EXPECT_TRUE(tree.radius(Vector3D(), 1.).empty());
+  EXPECT_TRUE(tree.knn(Vector3D(), 0).empty());
+  EXPECT_EQ(tree.nearest(Vector3D(1, 2, 3)), KdTree<3>::neighbour_type());
+  EXPECT_EQ((KdTree<2, float>().nearest(Vector<2, float>()).index), std::numeric_limits<size_t>::max());
+}
@@ -0,0 +1,151 @@
+#include "math/Tensor.h"
+
+#include <gtest/gtest.h>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+
+using namespace Math;
+namespace stdx = std::experimental;
+
+using P = stdx::fixed_size_simd<double, 4>;
+using V = Vector<3, P>;
+using T = Tensor<3, P>;
+
+static_assert(Type<P> && Pack<P>, "simd is not a pack");
+static_assert(Type<double> && !Pack<double>, "double is a pack");
+static_assert(Mask<bool> && Mask<stdx::fixed_size_simd_mask<double, 4>>, "mask concept failed");
+
+namespace
+{
+  // pack of the given lanes
+  P pack(double a, double b, double c, double d)
+  {
+    const double x[] = {a, b, c, d};
+    return P(x, stdx::element_aligned);
+  }
+
+  // lane of a vector or tensor of packs
+  Vector3D lane(const V &v, size_t k) { return Vector3D(v[0][k], v[1][k], v[2][k]); }
+  Tensor3D lane(const T &A, size_t k)
+  {
+    Tensor3D B;
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        B[i][j] = A[i][j][k];
+    return B;
+  }
+
+  // tensors of the lanes, the last one is singular
+  const Tensor3D lanes[] = {
+    Tensor3D(2., 1., 0., 1., 3., 1., 0., 1., 4.),
+    Tensor3D(1., 2., 3., 0., 1., 4., 5., 6., 0.),
+    Tensor3D(-1., 0., 0., 0., 2., 0., 0., 0., 0.5),
+    Tensor3D(1., 2., 3., 4., 5., 6., 7., 8., 9.)};
+
+  T packed_tensor()
+  {
+    T A;
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        A[i][j] = pack(lanes[0][i][j], lanes[1][i][j], lanes[2][i][j], lanes[3][i][j]);
+    return A;
+  }
+} // namespace
+
+TEST(LanePacks, vector_ops)
+{
+  V a(pack(1, 2, 3, 4), pack(0, 1, 0, 1), pack(5, 6, 7, 8));
+  V b(pack(-1, 0, 2, 1), pack(3, 3, 3, 3), pack(0, 1, 0, 1));
+
+  auto c = a % b;
+  auto d = a * b;
+  auto e = P(2.) * a - b;
+  for (size_t k = 0; k < P::size(); ++k)
+  {
+    EXPECT_EQ(lane(c, k), lane(a, k) % lane(b, k));
+    EXPECT_EQ(d[k], lane(a, k) * lane(b, k));
+    EXPECT_EQ(lane(e, k), 2. * lane(a, k) - lane(b, k));
+    EXPECT_DOUBLE_EQ(fabs(a)[k], fabs(lane(a, k)));
+  }
+
+  auto [cs, sn] = cos_sin(a, b);
+  auto n = normalize(a);
+  for (size_t k = 0; k < P::size(); ++k)
+  {
+    EXPECT_DOUBLE_EQ(cs[k], cos(lane(a, k), lane(b, k)));
+    EXPECT_DOUBLE_EQ(sn[k], sin(lane(a, k), lane(b, k)));
+    for (size_t c = 0; c < 3; ++c)
+      EXPECT_DOUBLE_EQ(lane(n, k)[c], normalize(lane(a, k))[c]);
+  }
+}
+
+TEST(LanePacks, det_and_invert)
+{
+  auto A = packed_tensor();
+  auto d = A.det();
+  auto B = A.invert();
+  for (size_t k = 0; k < P::size(); ++k)
+  {
+    EXPECT_DOUBLE_EQ(d[k], lanes[k].det());
+    auto inv = lane(B, k), expected = lanes[k].invert();
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        EXPECT_DOUBLE_EQ(inv[i][j], expected[i][j]) << "lane " << k;
+  }
+
+  // singular lane gives zero tensor (as the scalar one) w/o NaNs in the others
+  EXPECT_EQ(lane(B, 3), Tensor3D(0.));
+  auto inv_d = B.det();
+  for (size_t k = 0; k < 3; ++k)
+    EXPECT_NEAR(inv_d[k] * d[k], 1., 1e-12);
+  EXPECT_EQ(inv_d[3], 0.);
+
+  // all singular lanes
+  T S(P(1.));
+  S[0][0] = S[1][1] = 0;
+  EXPECT_TRUE(S.invert() == T(P(0.)));
+}
+
+TEST(LanePacks, equality)
+{
+  V a(pack(1, 2, 3, 4), P(0.), P(1.));
+  V b = a;
+  EXPECT_TRUE(a == b);
+  EXPECT_TRUE(stdx::all_of(equal(a, b)));
+
+  b[1][2] = 1;
+  EXPECT_FALSE(a == b);
+  EXPECT_TRUE(a != b);
+  auto m = equal(a, b);
+  EXPECT_TRUE(m[0] && m[1] && !m[2] && m[3]);
+
+  auto A = packed_tensor(), B = A;
+  B[2][0][1] = -1;
+  auto n = equal(A, B);
+  EXPECT_FALSE(A == B);
+  EXPECT_TRUE(n[0] && !n[1] && n[2] && n[3]);
+
+  // scalars are not affected
+  EXPECT_TRUE(equal(Vector3D(1, 2, 3), Vector3D(1, 2, 3)));
+  EXPECT_FALSE(equal(lanes[0], lanes[1]));
+}
+
+TEST(LanePacks, solve_many_systems)
+{
+  // Ax = b for 4 systems at once
+  auto A = packed_tensor();
+  V b(P(1.), pack(1, 2, 3, 4), P(-1.));
+  auto x = b / ~A; // i.e. x = A^-1 b
+  for (size_t k = 0; k < 3; ++k)
+  {
+    auto r = lanes[k] * lane(x, k) - lane(b, k);
+    EXPECT_LT(fabs(r), 1e-12) << "lane " << k;
+  }
+}
+#else
+TEST(LanePacks, unavailable)
+{
+  GTEST_SKIP() << "<experimental/simd> is not available";
+}
+#endif
@@ -0,0 +1,105 @@
+#include "math/OctNormal.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // uniformly distributed unit vectors plus the octants' diagonals and the fold lines
+  std::vector<Vector3D> directions(size_t n, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::normal_distribution<double> dist;
+    std::vector<Vector3D> v;
+    for (int x = -1; x <= 1; ++x)
+      for (int y = -1; y <= 1; ++y)
+        for (int z = -1; z <= 1; ++z)
+          if (x || y || z)
+            v.push_back(Vector3D(x, y, z) / std::sqrt(x*x + y*y + z*z));
+    while (v.size() < n)
+    {
+      Vector3D d(dist(gen), dist(gen), dist(gen));
+      v.push_back(d / std::sqrt(d * d));
+    }
+    return v;
+  }
+
+  double angle(const Vector3D &a, const Vector3D &b)
+  {
+    auto c = a % b;
+    return std::atan2(std::sqrt(c * c), a * b);
+  }
+
+  template<class E> void check_error()
+  {
+    double worst = 0;
+    for (auto &n : directions(200000, 1))
+    {
+      auto d = E(n).vector();
+      EXPECT_NEAR(d * d, 1., 1e-15);
+      worst = std::max(worst, angle(n, d));
+    }
+    EXPECT_LT(worst, E::max_error);
+    EXPECT_GT(worst, E::max_error / 10); // the bound is not too loose
+  }
+} // namespace
+
+TEST(OctNormal, error_bound_16)
+{
+  check_error<OctNormal16>();
+}
+
+TEST(OctNormal, error_bound_32)
+{
+  check_error<OctNormal32>();
+}
+
+TEST(OctNormal, codes_are_stable)
+{
+  // decoding and encoding again gives the same codes
+  for (auto &n : directions(10000, 2))
+  {
+    OctNormal16 e(n);
+    EXPECT_EQ(OctNormal16(e.vector()), e);
+    EXPECT_EQ(OctNormal16(e.vector<float>()), e);
+  }
+}
+
+TEST(OctNormal, bulk_double)
+{
+  auto v = directions(1000, 3);
+  std::vector<OctNormal32> e(v.size());
+  std::vector<Vector3D> r(v.size());
+  OctNormal32::encode(v, e);
+  OctNormal32::decode(e, r);
+  for (size_t i = 0; i < v.size(); ++i)
+  {
+    ASSERT_EQ(e[i], OctNormal32(v[i]));
+    auto d = e[i].vector();
+    for (size_t c = 0; c < 3; ++c)
+      EXPECT_NEAR(r[i][c], d[c], 1e-15);
+  }
+}
+
+TEST(OctNormal, bulk_float)
+{
+  auto v = directions(1000, 4);
+  std::vector<Vector<3, float>> f(v.size()), r(v.size());
+  for (size_t i = 0; i < v.size(); ++i)
+    f[i] = Vector<3, float>(v[i][0], v[i][1], v[i][2]);
+
+  std::vector<OctNormal16> e(v.size());
+  OctNormal16::encode(f, e);
+  OctNormal16::decode(e, r);
+  for (size_t i = 0; i < v.size(); ++i)
+  {
+    ASSERT_EQ(e[i], OctNormal16(f[i]));
+    Vector3D d(r[i][0], r[i][1], r[i][2]);
+    EXPECT_NEAR(d * d, 1., 1e-6);
+    EXPECT_LT(angle(v[i], d), OctNormal16::max_error + 1e-6);
+  }
+}
@@ -0,0 +1,60 @@
+#include "common/Parallel.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(4);
+} // namespace
+
+TEST(Parallel, concurrency)
+{
+  EXPECT_EQ(Parallel::concurrency(), 4u);
+  Parallel::set_concurrency(0);
+  EXPECT_GE(Parallel::concurrency(), 1u);
+  Parallel::set_concurrency(4); // back to the threads of the tests
+}
+
+TEST(Parallel, partition)
+{
+  auto p = Parallel::partition(10, 3);
+  EXPECT_EQ(p.nchunks, 3u);
+  EXPECT_EQ(p.first(0), 0u);
+  EXPECT_EQ(p.last(p.nchunks - 1), 10u);
+  for (size_t c = 1; c < p.nchunks; ++c)
+    EXPECT_EQ(p.first(c), p.last(c - 1));
+
+  EXPECT_EQ(Parallel::partition(1000, 1).nchunks, 4u);
+  EXPECT_EQ(Parallel::partition(5, 100).nchunks, 1u);
+  EXPECT_EQ(Parallel::partition(0, 100).nchunks, 0u);
+}
+
+TEST(Parallel, for_each_visits_all)
+{
+  std::vector<int> v(1000, 0);
+  Parallel::for_each(v.size(), 10, [&v](size_t i) { v[i] += static_cast<int>(i); });
+  for (size_t i = 0; i < v.size(); ++i)
+    EXPECT_EQ(v[i], static_cast<int>(i));
+}
+
+TEST(Parallel, reduce_in_order)
+{
+  std::vector<int> v(1001);
+  std::iota(v.begin(), v.end(), 0);
+  auto sum = Parallel::reduce(v.size(), 10, 0,
+    [&v](size_t first, size_t last) { return std::accumulate(v.begin() + first, v.begin() + last, 0); },
+    [](int a, int b) { return a + b; });
+  EXPECT_EQ(sum, 500500);
+
+  // concatenation is not commutative, so the order of chunks is checked
+  auto s = Parallel::reduce(v.size(), 100, std::string(),
+    [](size_t first, size_t) { return std::to_string(first) + ";"; },
+    [](std::string a, const std::string &b) { return a + b; });
+  EXPECT_EQ(s, "0;250;500;750;");
+
+  EXPECT_EQ(Parallel::reduce(0, 10, 42, [](size_t, size_t) { return 1; }, std::plus<int>()), 42);
+}
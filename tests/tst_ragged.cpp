@@ -0,0 +1,150 @@
+#include "math/Ragged.h"
+#include "math/Vector.h"
+#include "math/VectorField.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // polygons of 3 to 8 vertices
+  std::vector<std::vector<Vector3D>> random_polygons(size_t n)
+  {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> count(3, 8);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::vector<std::vector<Vector3D>> v(n);
+    for (auto &p : v)
+    {
+      p.resize(count(gen));
+      for (auto &x : p)
+        x = Vector3D(dist(gen), dist(gen), dist(gen));
+    }
+    return v;
+  }
+
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(4);
+} // namespace
+
+TEST(Ragged, empty)
+{
+  Ragged<Vector3D> r;
+  EXPECT_TRUE(r.empty());
+  EXPECT_EQ(r.nvalues(), 0);
+  EXPECT_EQ(r.index().offsets().size(), 1);
+  EXPECT_TRUE(Ragged<double>(std::vector<int>()).empty());
+  EXPECT_EQ(r.rows().begin(), r.rows().end());
+}
+
+TEST(Ragged, index_from_counts)
+{
+  std::vector<int> counts(100000);
+  for (size_t i = 0; i < counts.size(); ++i)
+    counts[i] = static_cast<int>(i % 7);
+
+  RaggedIndex index(counts);
+  ASSERT_EQ(index.size(), counts.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < counts.size(); ++i)
+  {
+    ASSERT_EQ(index.first(i), offset);
+    offset += counts[i];
+    ASSERT_EQ(index.last(i), offset);
+  }
+  EXPECT_EQ(index.nvalues(), offset);
+
+  // the same by appending the rows
+  RaggedIndex appended;
+  for (auto c : counts)
+    appended.push_back(c);
+  EXPECT_EQ(appended, index);
+}
+
+TEST(Ragged, from_rows)
+{
+  auto polygons = random_polygons(20000);
+  auto r = Ragged<Vector3D>::from_rows(polygons);
+  ASSERT_EQ(r.size(), polygons.size());
+  for (size_t i = 0; i < r.size(); ++i)
+  {
+    ASSERT_EQ(r.row_size(i), polygons[i].size());
+    ASSERT_TRUE(std::ranges::equal(r[i], polygons[i]));
+  }
+
+  // rows are consecutive in one buffer
+  EXPECT_EQ(r[1].data(), r[0].data() + r.row_size(0));
+  EXPECT_EQ(r.values().data(), r[0].data());
+  EXPECT_EQ(r.values().size(), r.nvalues());
+
+  // the same by appending the rows
+  Ragged<Vector3D> appended;
+  appended.reserve(polygons.size(), r.nvalues());
+  for (auto &p : polygons)
+    appended.push_back(p);
+  EXPECT_EQ(appended, r);
+}
+
+TEST(Ragged, rows)
+{
+  auto polygons = random_polygons(1000);
+  auto r = Ragged<Vector3D>::from_rows(polygons);
+
+  // modification through the spans of rows
+  size_t i = 0;
+  for (auto polygon : r.rows())
+  {
+    EXPECT_EQ(polygon.size(), polygons[i++].size());
+    for (auto &x : polygon)
+      x *= 2;
+  }
+  EXPECT_EQ(i, r.size());
+
+  const auto &c = r;
+  i = 0;
+  for (auto polygon : c.rows())
+  {
+    for (size_t k = 0; k < polygon.size(); ++k)
+      EXPECT_EQ(polygon[k], 2. * polygons[i][k]);
+    ++i;
+  }
+}
+
+TEST(Ragged, parallel_fill)
+{
+  std::vector<size_t> counts(50000);
+  for (size_t i = 0; i < counts.size(); ++i)
+    counts[i] = 3 + i % 3;
+
+  Ragged<double> r(counts);
+  ASSERT_EQ(r.nvalues(), std::accumulate(counts.begin(), counts.end(), size_t(0)));
+  Parallel::for_each(r.size(), 1024, [&](size_t i)
+  {
+    for (auto &x : r[i])
+      x = static_cast<double>(i);
+  });
+  for (size_t i = 0; i < r.size(); ++i)
+    for (auto x : r[i])
+      ASSERT_EQ(x, i);
+}
+
+TEST(Ragged, structure_of_arrays)
+{
+  // the index of the rows shared by a vector field
+  auto polygons = random_polygons(100);
+  auto r = Ragged<Vector3D>::from_rows(polygons);
+  const auto &index = r.index();
+  VectorField<3> f(index.nvalues());
+  for (size_t i = 0; i < index.size(); ++i)
+    for (size_t k = index.first(i); k < index.last(i); ++k)
+      f[k] = polygons[i][k - index.first(i)];
+
+  for (size_t k = 0; k < r.nvalues(); ++k)
+    EXPECT_EQ(f.get(k), r.values()[k]);
+}
@@ -0,0 +1,117 @@
+#include "math/Reductions.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <deque>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+using V3d = Vector<3>;
+using V3f = Vector<3, float>;
+
+namespace
+{
+  template<class V> std::vector<V> random_vectors(size_t n, int range = 1000)
+  {
+    std::mt19937 gen(3);
+    std::uniform_int_distribution<int> dist(-range, range);
+    std::vector<V> v(n);
+    for (auto &x : v)
+      x = V(dist(gen), dist(gen), dist(gen));
+    return v;
+  }
+
+  // reference results by the plain loop
+  template<class V> auto reference(const std::vector<V> &v)
+  {
+    using T = std::remove_cvref_t<decltype(v[0][0])>;
+    using S = typename Aggregate<3, T>::sum_type;
+    Aggregate<3, T> a;
+    a.count = v.size();
+    a.lo = a.hi = Vector<3, T>(v[0]);
+    for (auto &x : v)
+    {
+      const Vector<3, S> w(x);
+      a.sum += w;
+      for (size_t k = 0; k < 3; ++k)
+      {
+        a.lo[k] = std::min(a.lo[k], x[k]);
+        a.hi[k] = std::max(a.hi[k], x[k]);
+      }
+      a.sqs += w * w;
+      a.max_sqs = std::max(a.max_sqs, w * w);
+    }
+    return a;
+  }
+
+  template<class A> void expect_equal(const A &a, const A &b)
+  {
+    EXPECT_EQ(a.count, b.count);
+    EXPECT_EQ(a.sum, b.sum);
+    EXPECT_EQ(a.lo, b.lo);
+    EXPECT_EQ(a.hi, b.hi);
+    EXPECT_NEAR(a.sqs, b.sqs, 1e-4 * b.sqs); // the reference float sum is inaccurate itself
+    EXPECT_EQ(a.max_sqs, b.max_sqs);
+  }
+
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(3);
+} // namespace
+
+// integer valued components, so all sums are exact and don't depend on the order
+TEST(Reductions, packed_doubles)
+{
+  for (size_t n : {1, 2, 5, 7, 1000, 200001})
+  {
+    auto v = random_vectors<V3d>(n);
+    expect_equal(aggregate(v), reference(v));
+  }
+}
+
+TEST(Reductions, padded_floats)
+{
+  for (size_t n : {1, 3, 4, 1001, 100003})
+  {
+    auto v = random_vectors<PaddedVector<3, float>>(n);
+    expect_equal(aggregate(v), reference(v));
+  }
+}
+
+TEST(Reductions, integers)
+{
+  // the sum of squares and some squared magnitudes don't fit int
+  auto v = random_vectors<Vector<3, int>>(99999, 40000);
+  auto a = aggregate(v);
+  expect_equal(a, reference(v));
+  EXPECT_GT(a.sqs, std::numeric_limits<int>::max());
+  EXPECT_GT(a.max_sqs, std::numeric_limits<int>::max());
+}
+
+TEST(Reductions, non_contiguous_range)
+{
+  auto v = random_vectors<V3d>(100000);
+  std::deque<V3d> d(v.begin(), v.end());
+  expect_equal(aggregate(d), reference(v));
+}
+
+TEST(Reductions, empty_range)
+{
+  std::vector<V3d> v;
+  auto a = aggregate(v);
+  EXPECT_EQ(a.count, 0u);
+  EXPECT_EQ(a.sum, V3d());
+  EXPECT_EQ(a.sqs, 0.);
+}
+
+TEST(Reductions, centroid_and_max_fabs)
+{
+  std::vector<V3d> v = {V3d(0, 0, 0), V3d(2, 0, 0), V3d(0, 4, 0), V3d(2, 4, 4)};
+  auto a = aggregate(v);
+  EXPECT_EQ(a.centroid(), V3d(1, 2, 1));
+  EXPECT_DOUBLE_EQ(a.max_fabs(), 6.);
+  EXPECT_EQ(a.lo, V3d(0, 0, 0));
+  EXPECT_EQ(a.hi, V3d(2, 4, 4));
+}
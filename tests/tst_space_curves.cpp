@@ -0,0 +1,169 @@
+#include "math/SpaceCurves.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+using G2 = Vector<2, uint32_t>;
+using G3 = Vector<3, uint32_t>;
+
+namespace
+{
+  // all points of the grid [0, n)^N
+  template<size_t N> std::vector<Vector<N, uint32_t>> grid(uint32_t n)
+  {
+    std::vector<Vector<N, uint32_t>> g;
+    for (uint32_t i = 0; i < n; ++i)
+      for (uint32_t j = 0; j < n; ++j)
+        if constexpr (N == 2)
+          g.emplace_back(i, j);
+        else
+          for (uint32_t k = 0; k < n; ++k)
+            g.emplace_back(i, j, k);
+    return g;
+  }
+
+  template<size_t N> uint32_t manhattan(const Vector<N, uint32_t> &a, const Vector<N, uint32_t> &b)
+  {
+    uint32_t d = 0;
+    for (size_t i = 0; i < N; ++i)
+      d += (a[i] < b[i])? b[i] - a[i] : a[i] - b[i];
+    return d;
+  }
+
+  // the grid [0, 2^k)^N is a subtree of the curve, i.e. its keys are [0, 2^(N*k))
+  // and consecutive keys are neighbour cells
+  template<size_t N> void check_hilbert(uint32_t n)
+  {
+    auto g = grid<N>(n);
+    std::vector<uint64_t> keys;
+    for (auto &p : g)
+      keys.push_back(hilbert_key(p));
+
+    auto p = sort_permutation(keys);
+    for (size_t i = 0; i < p.size(); ++i)
+      ASSERT_EQ(keys[p[i]], i);
+    for (size_t i = 1; i < p.size(); ++i)
+      EXPECT_EQ(manhattan(g[p[i - 1]], g[p[i]]), 1u) << "at " << i;
+  }
+
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(4);
+} // namespace
+
+TEST(SpaceCurves, morton_is_bit_interleaving)
+{
+  std::mt19937_64 gen(8);
+  for (int i = 0; i < 1000; ++i)
+  {
+    G3 g(gen() & 0x1fffff, gen() & 0x1fffff, gen() & 0x1fffff);
+    uint64_t expected = 0;
+    for (unsigned b = 0; b < 21; ++b)
+      for (unsigned c = 0; c < 3; ++c)
+        expected |= uint64_t((g[c] >> b) & 1) << (3*b + c);
+    EXPECT_EQ(morton_key(g), expected);
+
+    G2 h(static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()));
+    expected = 0;
+    for (unsigned b = 0; b < 32; ++b)
+      for (unsigned c = 0; c < 2; ++c)
+        expected |= uint64_t((h[c] >> b) & 1) << (2*b + c);
+    EXPECT_EQ(morton_key(h), expected);
+  }
+}
+
+TEST(SpaceCurves, hilbert_2d_neighbours)
+{
+  check_hilbert<2>(64);
+}
+
+TEST(SpaceCurves, hilbert_3d_neighbours)
+{
+  check_hilbert<3>(16);
+}
+
+TEST(SpaceCurves, hilbert_is_bijection)
+{
+  std::mt19937_64 gen(9);
+  std::vector<uint64_t> keys;
+  for (int i = 0; i < 10000; ++i)
+    keys.push_back(hilbert_key(G2(static_cast<uint32_t>(gen()), static_cast<uint32_t>(gen()))));
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(std::adjacent_find(keys.begin(), keys.end()), keys.end());
+}
+
+TEST(SpaceCurves, integer_points)
+{
+  EXPECT_EQ(morton_key(Vector<2, int>(0, 0)), morton_key(G2(1u << 31, 1u << 31)));
+  EXPECT_EQ(hilbert_key(Vector<3, int>(-1, 0, 5)), hilbert_key(G3((1 << 20) - 1, 1 << 20, (1 << 20) + 5)));
+}
+
+TEST(SpaceCurves, quantizer)
+{
+  Quantizer<3, double> q(Vector3D(0, 0, 0), Vector3D(4, 2, 1));
+  EXPECT_EQ(q(Vector3D(0, 0, 0)), G3(0, 0, 0));
+  EXPECT_EQ(q(Vector3D(4, 2, 1)), G3(q.max, q.max / 2, q.max / 4));
+  EXPECT_EQ(q(Vector3D(-1, 5, 0.5)), G3(0, q.max, q.max / 8));
+
+  // degenerate box
+  Quantizer<2, float> p(Vector<2, float>(1, 1), Vector<2, float>(1, 1));
+  EXPECT_EQ(p(Vector<2, float>(1, 1)), G2(0, 0));
+}
+
+TEST(SpaceCurves, sort_permutation)
+{
+  for (size_t n : {0, 1, 2, 1000, 300001})
+  {
+    std::mt19937_64 gen(n);
+    std::vector<uint64_t> keys(n);
+    for (auto &k : keys)
+      k = gen() >> (gen() % 64); // various number of significant digits
+    for (size_t i = 0; i < n / 3; ++i)
+      keys[gen() % n] = keys[i]; // and duplicates
+
+    std::vector<size_t> expected(n);
+    std::iota(expected.begin(), expected.end(), size_t(0));
+    std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    EXPECT_EQ(sort_permutation(keys), expected);
+  }
+}
+
+TEST(SpaceCurves, order_of_points)
+{
+  std::mt19937 gen(10);
+  std::uniform_real_distribution<double> dist(-1., 1.);
+  std::vector<Vector3D> v(100000);
+  for (auto &x : v)
+    x = Vector3D(dist(gen), dist(gen), dist(gen));
+
+  // consecutive points along the curves are much closer than at random
+  auto mean_step = [&](const std::vector<size_t> &p)
+  {
+    double s = 0;
+    for (size_t i = 1; i < p.size(); ++i)
+      s += std::sqrt((v[p[i]] - v[p[i - 1]]) * (v[p[i]] - v[p[i - 1]]));
+    return s / static_cast<double>(p.size() - 1);
+  };
+  auto h = hilbert_order(v), m = morton_order(v);
+  std::vector<size_t> identity(v.size());
+  std::iota(identity.begin(), identity.end(), size_t(0));
+
+  EXPECT_LT(mean_step(h), 0.05 * mean_step(identity));
+  EXPECT_LT(mean_step(h), mean_step(m));
+
+  // both are permutations
+  std::ranges::sort(h);
+  std::ranges::sort(m);
+  EXPECT_EQ(h, identity);
+  EXPECT_EQ(m, identity);
+}
+
+TEST(SpaceCurves, order_of_integer_points)
+{
+  std::vector<Vector<2, int>> v = {Vector<2, int>(1, 1), Vector<2, int>(-1, -1), Vector<2, int>(0, 0)};
+  EXPECT_EQ(morton_order(v), (std::vector<size_t>{1, 2, 0}));
+}
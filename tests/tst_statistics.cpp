@@ -0,0 +1,138 @@
+#include "math/Statistics.h"
+#include "Concurrency.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  // samples with a large mean and a small spread, a hard case for the sum of squares
+  std::vector<Vector3D> random_vectors(size_t n)
+  {
+    std::mt19937 gen(3);
+    std::normal_distribution<double> dist(0, 1);
+    std::vector<Vector3D> v(n);
+    for (auto &x : v)
+    {
+      double a = dist(gen), b = dist(gen), c = dist(gen);
+      x = Vector3D(1e8 + a, -1e8 + a + 0.5 * b, 1e6 + 2 * c);
+    }
+    return v;
+  }
+
+  // two-pass reference in long double
+  Tensor<3, long double> reference_covariance(const std::vector<Vector3D> &v)
+  {
+    Vector<3, long double> m;
+    for (auto &x : v)
+      m += Vector<3, long double>(x);
+    m /= static_cast<long double>(v.size());
+    Tensor<3, long double> c;
+    for (auto &x : v)
+    {
+      auto d = Vector<3, long double>(x) - m;
+      c += d ^ d;
+    }
+    return c / static_cast<long double>(v.size());
+  }
+
+  // runs the parallel code paths on a single core machine too
+  const auto *threads = Tests::concurrency(4);
+} // namespace
+
+TEST(Statistics, vectors)
+{
+  auto v = random_vectors(200000);
+  auto s = statistics(v);
+  ASSERT_EQ(s.count(), v.size());
+  EXPECT_NEAR(s.mean()[0], 1e8, 0.01);
+  EXPECT_NEAR(s.mean()[2], 1e6, 0.02);
+
+  // covariance of (a, a + b/2, 2c) is [[1, 1, 0], [1, 1.25, 0], [0, 0, 4]]
+  auto c = s.covariance();
+  auto r = reference_covariance(v);
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t j = 0; j < 3; ++j)
+    {
+      EXPECT_NEAR(c[i][j], static_cast<double>(r[i][j]), 1e-8); // eps |mean|
+      EXPECT_EQ(c[i][j], c[j][i]);
+    }
+  EXPECT_NEAR(c[1][1], 1.25, 0.02);
+  EXPECT_NEAR(c[2][2], 4, 0.05);
+  EXPECT_EQ(s.variance(), Vector3D(c[0][0], c[1][1], c[2][2]));
+  const auto sc = s.sample_covariance();
+  EXPECT_NEAR(sc[2][2], c[2][2] * v.size() / (v.size() - 1), 1e-12);
+}
+
+TEST(Statistics, merge)
+{
+  auto v = random_vectors(10000);
+  Statistics<Vector3D> serial;
+  for (auto &x : v)
+    serial += x;
+
+  // uneven parts, the empty ones too
+  Statistics<Vector3D> merged, empty;
+  merged.merge(empty);
+  merged += statistics(std::span(v).subspan(0, 17));
+  merged += statistics(std::span(v).subspan(17, 5000));
+  merged += empty;
+  merged += statistics(std::span(v).subspan(5017));
+
+  EXPECT_EQ(merged.count(), serial.count());
+  const auto c = merged.covariance(), r = serial.covariance();
+  for (size_t i = 0; i < 3; ++i)
+  {
+    EXPECT_NEAR(merged.mean()[i], serial.mean()[i], 1e-6);
+    for (size_t j = 0; j < 3; ++j)
+      EXPECT_NEAR(c[i][j], r[i][j], 1e-8);
+  }
+}
+
+TEST(Statistics, tensors)
+{
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  std::vector<Tensor3D> t(50000);
+  for (auto &x : t)
+    for (auto &c : x)
+      c = 1e3 + dist(gen);
+
+  auto s = statistics(t);
+  ASSERT_EQ(s.count(), t.size());
+
+  // componentwise two-pass reference
+  Tensor3D m, var;
+  for (auto &x : t)
+    m += x;
+  m /= static_cast<double>(t.size());
+  for (auto &x : t)
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        var[i][j] += (x[i][j] - m[i][j]) * (x[i][j] - m[i][j]);
+  var /= static_cast<double>(t.size());
+
+  const auto v = s.variance();
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t j = 0; j < 3; ++j)
+    {
+      EXPECT_NEAR(s.mean()[i][j], m[i][j], 1e-10);
+      EXPECT_NEAR(v[i][j], var[i][j], 1e-12);
+      EXPECT_NEAR(v[i][j], 1. / 3, 0.01);
+    }
+}
+
+TEST(Statistics, floats)
+{
+  // the naive sum of squares loses all digits here
+  Statistics<Vector<2, float>> s;
+  for (int i = 0; i < 1000; ++i)
+    s += Vector<2, float>(1e4f + (i % 2), 1e4f - (i % 2));
+  const auto c = s.covariance();
+  EXPECT_NEAR(c[0][0], 0.25f, 1e-3f);
+  EXPECT_NEAR(c[0][1], -0.25f, 1e-3f);
+}
@@ -0,0 +1,113 @@
+#include "math/Summation.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+using V3f = Vector<3, float>;
+using V3d = Vector<3, double>;
+
+namespace
+{
+  // vectors with components of very different magnitudes and exact sum in long double
+  std::vector<V3f> random_vectors(size_t n, Vector<3, long double> &exact)
+  {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    std::vector<V3f> v(n);
+    exact = Vector<3, long double>();
+    for (auto &x : v)
+    {
+      x = V3f(dist(gen), 1e3f * dist(gen), 1e-3f * dist(gen));
+      exact += Vector<3, long double>(x);
+    }
+    return v;
+  }
+} // namespace
+
+TEST(Summation, empty_ranges)
+{
+  std::vector<V3d> v;
+  EXPECT_EQ(pairwise_sum(v), V3d());
+  EXPECT_EQ(compensated_sum(v), V3d());
+  EXPECT_EQ(compensated_dot(v, v), 0.);
+}
+
+TEST(Summation, pairwise_sum_of_floats)
+{
+  Vector<3, long double> exact;
+  auto v = random_vectors(1 << 20, exact);
+
+  V3f naive;
+  for (auto &x : v)
+    naive += x;
+  auto pairwise = pairwise_sum(v);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    auto e = static_cast<double>(exact[i]);
+    EXPECT_NEAR(pairwise[i], e, 1e-5 * e);
+    EXPECT_LT(std::abs(pairwise[i] - e), std::abs(naive[i] - e));
+  }
+}
+
+TEST(Summation, compensated_sum_of_floats)
+{
+  Vector<3, long double> exact;
+  auto v = random_vectors(1 << 20, exact);
+
+  // correctly rounded float result
+  auto s = compensated_sum(v);
+  for (size_t i = 0; i < 3; ++i)
+    EXPECT_FLOAT_EQ(s[i], static_cast<float>(exact[i]));
+
+  // about twice as many correct bits in the unevaluated sum
+  CompensatedSum<V3f> acc;
+  for (auto &x : v)
+    acc += x;
+  auto d = V3d(acc.sum()) + V3d(acc.error());
+  for (size_t i = 0; i < 3; ++i)
+  {
+    auto e = static_cast<double>(exact[i]);
+    EXPECT_NEAR(d[i], e, 1e-9 * e);
+  }
+}
+
+TEST(Summation, compensated_sum_merge)
+{
+  Vector<3, long double> exact;
+  auto v = random_vectors(1000, exact);
+
+  CompensatedSum<V3f> a, b, all;
+  for (size_t i = 0; i < v.size(); ++i)
+  {
+    (i < 300 ? a : b) += v[i];
+    all += v[i];
+  }
+  a += b;
+  EXPECT_EQ(a.value(), all.value());
+}
+
+TEST(Summation, compensated_dot_of_floats)
+{
+  Vector<3, long double> exact;
+  auto x = random_vectors(1 << 18, exact), y = x;
+  std::reverse(y.begin(), y.end());
+
+  long double dot = 0;
+  for (size_t i = 0; i < x.size(); ++i)
+    for (size_t k = 0; k < 3; ++k)
+      dot += static_cast<long double>(x[i][k]) * y[i][k];
+
+  EXPECT_FLOAT_EQ(compensated_dot(x, y), static_cast<float>(dot));
+}
+
+TEST(Summation, ill_conditioned_scalars)
+{
+  std::vector<double> x = {1e16, 1., -1e16, 1., 1e-16, 3.};
+  EXPECT_EQ(compensated_sum(x), 5. + 1e-16);
+
+  std::vector<double> a = {1e8 + 1, 1e8 - 1}, b = {1e8 + 1, -(1e8 + 1)};
+  EXPECT_EQ(compensated_dot(a, b), 2e8 + 2); // (1e8+1)^2 - (1e8-1)(1e8+1)
+}
@@ -0,0 +1,132 @@
+#include "math/SymTensor.h"
+#include "quantities/State.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+
+using namespace Math;
+
+namespace
+{
+  // symmetric positive definite, A = B*~B + E
+  SymTensor3D random_spd(std::mt19937 &gen)
+  {
+    std::uniform_real_distribution<double> dist(-1, 1);
+    Tensor3D B;
+    for (auto &x : B)
+      x = dist(gen);
+    return SymTensor3D(B * ~B + Tensor3D(1.));
+  }
+} // namespace
+
+TEST(SymTensor, storage)
+{
+  EXPECT_EQ(sizeof(SymTensor3D), 6 * sizeof(double));
+  EXPECT_EQ(sizeof(SymTensor2D), 3 * sizeof(double));
+  EXPECT_EQ(SymTensor3D::ncomps, 6);
+
+  SymTensor3D A(1, 2, 3, 4, 5, 6);
+  A(2, 0) = 7;
+  EXPECT_EQ(A(0, 2), 7);
+  EXPECT_EQ(&A(1, 2), &A(2, 1));
+}
+
+TEST(SymTensor, conversions)
+{
+  std::mt19937 gen(1);
+  for (int n = 0; n < 100; ++n)
+  {
+    const auto A = random_spd(gen);
+    const auto a = Tensor3D(A);
+    EXPECT_EQ(a, ~a);
+    EXPECT_EQ(SymTensor3D(a), A);
+  }
+
+  // the symmetric part of a general tensor
+  const Tensor3D b(1, 2, 3, 4, 5, 6, 7, 8, 9);
+  EXPECT_EQ(Tensor3D(SymTensor3D(b)), (b + ~b) / 2.);
+}
+
+TEST(SymTensor, det_invert)
+{
+  std::mt19937 gen(2);
+  for (int n = 0; n < 100; ++n)
+  {
+    const auto A = random_spd(gen);
+    const auto a = Tensor3D(A);
+    EXPECT_NEAR(A.det(), a.det(), 1e-12 * fabs(a.det()));
+    EXPECT_NEAR(A.trace(), a.trace(), 1e-14);
+
+    const auto I = Tensor3D(A.invert()) * a;
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 3; ++j)
+        EXPECT_NEAR(I[i][j], i == j, 1e-12);
+  }
+  EXPECT_EQ(SymTensor3D(1, 1, 1, 1, 1, 1).invert(), SymTensor3D());
+}
+
+TEST(SymTensor, large)
+{
+  // N > 3 goes through the Tensor
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  SymTensor<5> A(10.);
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = i + 1; j < 5; ++j)
+      A(i, j) = dist(gen);
+  const auto a = Tensor<5>(A);
+  EXPECT_NEAR(A.det(), a.det(), 1e-10 * fabs(a.det()));
+  const auto I = Tensor<5>(A.invert()) * a;
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      EXPECT_NEAR(I[i][j], i == j, 1e-12);
+}
+
+TEST(SymTensor, products)
+{
+  std::mt19937 gen(4);
+  const auto A = random_spd(gen), B = random_spd(gen);
+  const auto a = Tensor3D(A), b = Tensor3D(B);
+  const Vector3D v(1, -2, 3);
+
+  const auto av = A * v, bv = a * v;
+  for (size_t i = 0; i < 3; ++i)
+    EXPECT_NEAR(av[i], bv[i], 1e-14);
+  double s = 0;
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      s += a[i][j] * b[i][j];
+  EXPECT_NEAR(contract(A, B), s, 1e-13);
+  EXPECT_NEAR(contract(A, b), s, 1e-13);
+
+  // symmetrized product
+  const auto ab = Tensor3D(A * B), sym = (a * b + b * a) / 2.;
+  for (size_t i = 0; i < 3; ++i)
+    for (size_t j = 0; j < 3; ++j)
+      EXPECT_NEAR(ab[i][j], sym[i][j], 1e-13);
+}
+
+TEST(SymTensor, state)
+{
+  using sigma_t = Quantities::Traits<SymTensor3D, 3, "sigma">;
+  using rho_t = Quantities::Traits<double, 3, "rho">;
+  constexpr sigma_t sigma;
+  constexpr rho_t rho;
+
+  Quantities::State<sigma_t, rho_t> s(SymTensor3D(1, 2, 3, 4, 5, 6), 2.);
+  auto m = s + s * 0.5;
+  EXPECT_EQ(m[sigma], SymTensor3D(1.5, 3, 4.5, 6, 7.5, 9));
+  EXPECT_EQ(m[rho], 3);
+}
+
+TEST(SymTensor, io)
+{
+  std::stringstream ss;
+  ss << SymTensor2D(1, 2, 3);
+  EXPECT_EQ(ss.str(), "[1, 2, 3]");
+
+  SymTensor2D A;
+  ss >> A;
+  EXPECT_EQ(A, SymTensor2D(1, 2, 3));
+}
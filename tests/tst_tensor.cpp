@@ -1,6 +1,9 @@
 #include "math/Tensor.h"
 #include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
 #include <sstream>
+#include <utility>
 
 using namespace Math;
 
@@ -243,6 +246,15 @@ TEST(Tensor, determinant_4x4)
   EXPECT_EQ(t4.det(), -1);
 }
 
+TEST(Tensor, determinant_4x4_double)
+{
+  Tensor<4> t4(2., 3., 5., 2.,
+               6., 1., 8., 3.,
+               5., 4., 9., 2.,
+               1., 3., 5., 6.);
+  EXPECT_DOUBLE_EQ(t4.det(), -1.);
+}
+
 TEST(Tensor, invert_identity)
 {
   T3i E(1, 1, 1);
@@ -276,6 +288,129 @@ TEST(Tensor, invert_4x4)
   EXPECT_EQ(t4 * t4_inverted, E4);
 }
 
+TEST(Tensor, invert_4x4_double)
+{
+  Tensor<4> t4(2., 3., 5., 2.,
+               6., 1., 8., 3.,
+               5., 4., 9., 2.,
+               1., 3., 5., 6.);
+  Tensor<4> t4_inverted(
+      121.,  28., -76., -29.,
+       88.,  20., -55., -21.,
+     -113., -26.,  71.,  27.,
+       30.,   7., -19.,  -7.);
+  auto R = t4.invert();
+  for (size_t i = 0; i < 4; ++i)
+    for (size_t j = 0; j < 4; ++j)
+      EXPECT_NEAR(R[i][j], t4_inverted[i][j], 1e-10);
+}
+
+TEST(Tensor, determinant_runtime_matches_compile_time)
+{
+  // LU in runtime, cofactor expansion in compile-time
+  constexpr Tensor<6> A(4., 1., 0., 2., -1., 3.,
+                        1., 5., 2., 0., 1., -2.,
+                        0., 2., 6., 1., 0., 1.,
+                        2., 0., 1., 7., 3., 0.,
+                       -1., 1., 0., 3., 8., 2.,
+                        3., -2., 1., 0., 2., 9.);
+  constexpr double d = A.det();
+  Tensor<6> B = A;
+  EXPECT_NEAR(B.det(), d, 1e-12 * std::fabs(d));
+
+  // row swaps change the sign
+  for (size_t j = 0; j < 6; ++j)
+    std::swap(B[0][j], B[4][j]);
+  EXPECT_NEAR(B.det(), -d, 1e-12 * std::fabs(d));
+}
+
+TEST(Tensor, determinant_triangular_8x8)
+{
+  Tensor<8> A;
+  double d = 1;
+  for (size_t i = 0; i < 8; ++i)
+  {
+    for (size_t j = i; j < 8; ++j)
+      A[i][j] = 1. + 0.5 * i + 0.25 * j;
+    d *= A[i][i];
+  }
+  EXPECT_DOUBLE_EQ(A.det(), d);
+  EXPECT_DOUBLE_EQ((~A).det(), d);
+}
+
+TEST(Tensor, invert_large)
+{
+  // diagonally dominant, rows permuted to exercise the pivoting
+  auto check = [](auto A)
+  {
+    constexpr size_t N = sizeof(A) / sizeof(A[0][0]) == 64? 8 : 12;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        A[(i + 3) % N][j] = std::sin(1. + i * N + j) + ((i == j)? N : 0.);
+    auto R = A.invert() * A;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        EXPECT_NEAR(R[i][j], (i == j)? 1. : 0., 1e-13);
+  };
+  check(Tensor<8>());
+  check(Tensor<12>());
+}
+
+TEST(Tensor, invert_singular_large)
+{
+  // equal rows stay equal during the elimination, thus the pivot is zero exactly
+  Tensor<5> A;
+  for (size_t i = 0; i < 5; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      A[i][j] = std::sin(1. + 5 * (i % 4) + j);
+  EXPECT_EQ(A.det(), 0.);
+  EXPECT_EQ(A.invert(), Tensor<5>(0.));
+}
+
+namespace
+{
+  // the tiled product of large tensors against the i-j-k sums
+  template<size_t N, class T> void check_multiply()
+  {
+    Tensor<N, T> A, B, C;
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+      {
+        A[i][j] = static_cast<T>(std::sin(1. + i * N + j));
+        B[i][j] = static_cast<T>(std::cos(2. + j * N + i));
+      }
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        for (size_t k = 0; k < N; ++k)
+          C[i][j] += A[i][k] * B[k][j];
+
+    const auto R = A * B;
+    const T eps = N * std::numeric_limits<T>::epsilon();
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        EXPECT_NEAR(R[i][j], C[i][j], eps * (1 + std::fabs(C[i][j]))) << N << ' ' << i << ' ' << j;
+
+    // the factor may be the tensor itself
+    auto S = A;
+    S *= S;
+    EXPECT_EQ(S, A * A);
+  }
+} // namespace
+
+TEST(Tensor, multiply_large)
+{
+  // all the combinations of the remainders of the row and column tiles
+  check_multiply<12, double>();
+  check_multiply<13, double>();
+  check_multiply<16, double>();
+  check_multiply<18, double>();
+  check_multiply<31, double>();
+  check_multiply<32, double>();
+  check_multiply<17, float>();
+  check_multiply<24, float>();
+  check_multiply<14, long double>();
+}
+
 TEST(Tensor, output_default_in_brackets)
 {
   std::stringstream ss;
@@ -388,3 +523,18 @@ TEST(Tensor, roundtrip_bare_comps)
   ss >> t2;
   EXPECT_EQ(t1, t2);
 }
+
+TEST(Tensor, padded_vectors)
+{
+  using V3d = Vector<3>;
+  V3d a(0.1, 0.2, 0.3), b(-1.7, 2.9, 0.013);
+  PaddedVector3D pa(a), pb(b);
+  T3d A(1, 2, 3, 4, 5, 6, 7, 8, 10);
+  EXPECT_EQ(V3d(pa * A), a * A);
+  EXPECT_EQ(V3d(A * pa), A * a);
+  EXPECT_EQ(V3d(pa / A), a / A);
+  EXPECT_EQ(pa ^ pb, a ^ b);
+  EXPECT_EQ(~pa, ~a);
+  EXPECT_EQ(pa % A, a % A);
+  EXPECT_EQ(A % pa, A % a);
+}
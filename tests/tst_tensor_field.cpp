@@ -0,0 +1,132 @@
+#include "math/TensorField.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace
+{
+  template<size_t N> TensorField<N> random_field(size_t n, unsigned seed = 42)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    TensorField<N> f(n);
+    for (size_t k = 0; k < n; ++k)
+    {
+      Tensor<N> A;
+      for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < N; ++j)
+          A[i][j] = dist(gen);
+      f.set(k, A);
+    }
+    return f;
+  }
+
+  template<size_t N> void expect_near(const Tensor<N> &A, const Tensor<N> &B, double eps)
+  {
+    for (size_t i = 0; i < N; ++i)
+      for (size_t j = 0; j < N; ++j)
+        EXPECT_NEAR(A[i][j], B[i][j], eps * (1 + fabs(B[i][j])));
+  }
+} // namespace
+
+TEST(TensorField, init_and_access)
+{
+  TensorField<3> f(5, Tensor3D(1, 2, 3, 4, 5, 6, 7, 8, 9));
+  EXPECT_EQ(f.size(), 5u);
+  for (size_t k = 0; k < f.size(); ++k)
+    EXPECT_EQ(f.get(k), Tensor3D(1, 2, 3, 4, 5, 6, 7, 8, 9));
+
+  f.set(2, Tensor3D(1.));
+  EXPECT_EQ(f[2], Tensor3D(1.));
+  EXPECT_EQ(f.component(0, 1)[2], 0);
+  EXPECT_EQ(f.component(0, 1)[3], 2);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(f.component(1, 2).data()) % simd::alignment, 0u);
+
+  f.resize(7);
+  EXPECT_EQ(f[4], Tensor3D(1, 2, 3, 4, 5, 6, 7, 8, 9));
+  EXPECT_EQ(f[6], Tensor3D());
+}
+
+TEST(TensorField, det)
+{
+  // odd size for the remainder of the vectorized loop
+  auto f2 = random_field<2>(1001);
+  auto f3 = random_field<3>(1001);
+  std::vector<double> d2(f2.size()), d3(f3.size());
+  det(f2, std::span(d2));
+  det(f3, std::span(d3));
+  for (size_t k = 0; k < f3.size(); ++k)
+  {
+    EXPECT_NEAR(d2[k], f2[k].det(), 1e-15);
+    EXPECT_NEAR(d3[k], f3[k].det(), 1e-15);
+  }
+}
+
+TEST(TensorField, invert)
+{
+  auto f2 = random_field<2>(1001);
+  auto f3 = random_field<3>(1001);
+  TensorField<2> r2(f2.size());
+  TensorField<3> r3(f3.size());
+  EXPECT_EQ(invert(f2, r2), 0u);
+  EXPECT_EQ(invert(f3, r3), 0u);
+  for (size_t k = 0; k < f3.size(); ++k)
+  {
+    expect_near(r2[k], f2[k].invert(), 1e-12);
+    expect_near(r3[k], f3[k].invert(), 1e-12);
+  }
+
+  // in place
+  auto a = f3;
+  invert(a, a);
+  for (size_t k = 0; k < f3.size(); ++k)
+    EXPECT_EQ(a[k], r3[k]);
+}
+
+TEST(TensorField, invert_transpose)
+{
+  auto f2 = random_field<2>(333);
+  auto f3 = random_field<3>(333);
+  TensorField<2> r2(f2.size());
+  TensorField<3> r3(f3.size());
+  invert_transpose(f2, r2);
+  invert_transpose(f3, r3);
+  for (size_t k = 0; k < f3.size(); ++k)
+  {
+    expect_near(r2[k], ~f2[k].invert(), 1e-12);
+    expect_near(r3[k], ~f3[k].invert(), 1e-12);
+  }
+}
+
+TEST(TensorField, singular_mask)
+{
+  auto f = random_field<3>(100);
+  f.set(3, Tensor3D());
+  f.set(50, Tensor3D(1, 2, 3, 2, 4, 6, 0, 1, 1));
+  f.set(99, Tensor3D(1, 1, 0, 1, 1, 0, 0, 0, 1));
+
+  TensorField<3> r(f.size(), Tensor3D(7.));
+  std::vector<std::uint8_t> singular(f.size(), 2);
+  EXPECT_EQ(invert(f, r, singular), 3u);
+  for (size_t k = 0; k < f.size(); ++k)
+  {
+    const bool s = (k == 3 || k == 50 || k == 99);
+    EXPECT_EQ(singular[k], s) << k;
+    if (s)
+    {
+      EXPECT_EQ(r[k], Tensor3D()) << k;
+    }
+  }
+
+  TensorField<2> f2(10, Tensor2D(1, 2, 2, 4));
+  f2.set(4, Tensor2D(1.));
+  std::vector<std::uint8_t> singular2(f2.size());
+  EXPECT_EQ(invert_transpose(f2, f2, singular2), 9u);
+  EXPECT_EQ(singular2[4], 0);
+  EXPECT_EQ(f2[4], Tensor2D(1.));
+  EXPECT_EQ(f2[5], Tensor2D());
+}
@@ -0,0 +1,217 @@
+#include "math/TensorN.h"
+#include "ExpectNear.h"
+#include "RandomTensors.h"
+
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <sstream>
+
+using namespace Math;
+using namespace Tests;
+
+namespace
+{
+  // counts the allocations and the bytes in use
+  class CountingResource : public std::pmr::memory_resource
+  {
+    std::pmr::memory_resource *upstream = std::pmr::new_delete_resource();
+
+  public:
+    size_t allocations = 0, bytes = 0;
+
+    void* do_allocate(size_t n, size_t align) override
+      { ++allocations; bytes += n; return upstream->allocate(n, align); }
+    void do_deallocate(void *p, size_t n, size_t align) override
+      { bytes -= n; upstream->deallocate(p, n, align); }
+    bool do_is_equal(const std::pmr::memory_resource &r) const noexcept override { return this == &r; }
+  };
+
+  // the default resource is replaced by the one which throws on any allocation
+  struct NoDefaultResource
+  {
+    std::pmr::memory_resource *old = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    ~NoDefaultResource() { std::pmr::set_default_resource(old); }
+  };
+
+  template<size_t N> void expect_near(const TensorN<> &A, const Tensor<N> &B, double eps = 1e-12)
+  {
+    ASSERT_EQ(A.size(), N);
+    Tests::expect_near(A.view<N>(), B, eps);
+  }
+
+  template<size_t N> void expect_near(const VectorN<> &a, const Vector<N> &b, double eps = 1e-12)
+  {
+    ASSERT_EQ(a.size(), N);
+    Tests::expect_near(a.view<N>(), b, eps);
+  }
+
+  // the same results as of Tensor<N> and Vector<N>
+  template<size_t N> void check_ops(std::pmr::memory_resource *mr)
+  {
+    const auto A = random_tensor<N>(), B = random_tensor<N>(3);
+    const auto a = random_vector<N>(), b = random_vector<N>(5);
+    const TensorN<> An(A, mr), Bn(B, mr);
+    const VectorN<> an(a, mr), bn(b, mr);
+
+    expect_near(An + Bn, A + B);
+    expect_near(An - Bn, A - B);
+    expect_near(An * Bn, A * B);
+    expect_near(An * 2., A * 2.);
+    expect_near(2. * An, 2. * A);
+    expect_near(An / 2., A / 2.);
+    expect_near(An / Bn, A / B);
+    expect_near(-An, -A);
+    expect_near(+An, A);
+    expect_near(~An, ~A);
+    expect_near(An.invert(), A.invert());
+    EXPECT_NEAR(An.det(), A.det(), 1e-12 * fabs(A.det()));
+    EXPECT_EQ(An.trace(), A.trace());
+
+    expect_near(an + bn, a + b);
+    expect_near(an - bn, a - b);
+    expect_near(-an, -a);
+    expect_near(an * 2., a * 2.);
+    expect_near(2. * an, 2. * a);
+    expect_near(an / 2., a / 2.);
+    EXPECT_NEAR(an * bn, a * b, 1e-14);
+    EXPECT_NEAR(fabs(an), fabs(a), 1e-14);
+    EXPECT_NEAR(sqs(an), sqs(a), 1e-14);
+    expect_near(normalize(an), normalize(a));
+
+    expect_near(an * An, a * A);
+    expect_near(An * an, A * a);
+    expect_near(an / An, a / A);
+    expect_near(an ^ bn, a ^ b);
+  }
+} // namespace
+
+TEST(TensorN, ctors)
+{
+  const TensorN<> A(3, 2.);
+  EXPECT_EQ(A.size(), 3);
+  EXPECT_EQ(A.view<3>(), Tensor3D(2.));
+  EXPECT_EQ(TensorN<>(4), TensorN<>(4, 0.));
+  EXPECT_TRUE(TensorN<>().empty());
+  const TensorN<> B(Tensor2D(1., 2., 3., 4.));
+  EXPECT_EQ(B[1][0], 3);
+
+  const VectorN<> a(3, 1.);
+  EXPECT_EQ(a.view<3>(), Vector3D(1, 1, 1));
+  EXPECT_EQ(VectorN<>(Vector2D(1, 2))[1], 2);
+  EXPECT_TRUE(VectorN<>().empty());
+
+  // integral values as of Tensor<N>(0), not the null resource
+  EXPECT_EQ(TensorN<>(4, 0), TensorN<>(4));
+  EXPECT_EQ(TensorN<>(3, 1).view<3>(), Tensor3D(1.));
+  EXPECT_EQ(VectorN<>(3, 0), VectorN<>(3));
+  EXPECT_EQ(VectorN<>(2, 2).view<2>(), Vector2D(2, 2));
+
+  // different sizes aren't equal
+  EXPECT_NE(TensorN<>(2), TensorN<>(3));
+  EXPECT_NE(VectorN<>(2), VectorN<>(3));
+}
+
+TEST(TensorN, ops)
+{
+  check_ops<2>(std::pmr::get_default_resource());
+  check_ops<3>(std::pmr::get_default_resource());
+  check_ops<7>(std::pmr::get_default_resource());
+
+  std::pmr::monotonic_buffer_resource arena;
+  check_ops<12>(&arena);
+}
+
+TEST(TensorN, singular)
+{
+  // zero as of Tensor::invert
+  auto A = TensorN<>(random_tensor<6>());
+  for (size_t j = 0; j < 6; ++j)
+    A[3][j] = 0;
+  const auto b = VectorN<>(random_vector<6>());
+  EXPECT_EQ(A.det(), 0);
+  EXPECT_EQ(A.invert(), TensorN<>(6));
+  EXPECT_EQ(b / A, VectorN<>(6));
+  EXPECT_EQ(TensorN<>(6, 1.) / A, TensorN<>(6));
+}
+
+TEST(TensorN, views)
+{
+  // the same storage
+  TensorN<> A(3);
+  A.view<3>() = Tensor3D(1., 2., 3., 4., 5., 6., 7., 8., 9.);
+  EXPECT_EQ(A[2][1], 8);
+  A[0][2] = -1;
+  EXPECT_EQ(A.view<3>()[0][2], -1);
+  EXPECT_NEAR(A.view<3>().det(), A.det(), 1e-12);
+
+  VectorN<> a(3);
+  a.view<3>() = Vector3D(1, 2, 3);
+  EXPECT_EQ(a[2], 3);
+  EXPECT_EQ(a.view<3>() * A.view<3>(), (a * A).view<3>());
+}
+
+TEST(TensorN, resources)
+{
+  CountingResource counter;
+  {
+    const TensorN<> A(random_tensor<8>(), &counter), B(random_tensor<8>(3), &counter);
+    const VectorN<> b(random_vector<8>(), &counter);
+    EXPECT_EQ(counter.allocations, 3);
+
+    // all the temporaries and the results are allocated from the resource of the operands
+    NoDefaultResource guard;
+    const auto C = (A * B + B) / A;
+    const auto x = b / ~A;
+    const auto y = A.invert() * b;
+    EXPECT_EQ(C.resource(), &counter);
+    EXPECT_EQ(x.resource(), &counter);
+    EXPECT_EQ(y.resource(), &counter);
+    EXPECT_NEAR(A.det(), random_tensor<8>().det(), 1e-12 * fabs(A.det()));
+
+    // copies keep the resource of the source, assignments keep their own
+    TensorN<> D(A), E(std::pmr::new_delete_resource());
+    EXPECT_EQ(D.resource(), &counter);
+    E = A;
+    EXPECT_EQ(E.resource(), std::pmr::new_delete_resource());
+    EXPECT_EQ(E, A);
+    E = std::move(D);
+    EXPECT_EQ(E, A);
+    EXPECT_EQ(D.size(), 8);
+    TensorN<> F(&counter);
+    F = std::move(D);
+    EXPECT_EQ(F, A);
+    EXPECT_TRUE(D.empty());
+  }
+  // everything is freed
+  EXPECT_EQ(counter.bytes, 0);
+  EXPECT_GT(counter.allocations, 10);
+
+  // a buffer on stack, no malloc at all
+  std::byte buffer[1 << 14];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+  for (int c = 0; c < 100; ++c)
+  {
+    NoDefaultResource guard;
+    TensorN<> A(5, 5., &arena);
+    VectorN<> b(5, 1., &arena);
+    A[0][4] = c;
+    const auto x = b / ~A;
+    expect_near(A * x, Vector<5>(1.));
+    arena.release();
+  }
+}
+
+TEST(TensorN, io)
+{
+  std::stringstream s;
+  const TensorN<> A(Tensor2D(1., 2., 3., 4.));
+  const VectorN<> a(Vector3D(1, 2, 3));
+  s << A << " " << a;
+  EXPECT_EQ(s.str(), "[1, 2, 3, 4] (1, 2, 3)");
+
+  TensorN<> B(2);
+  VectorN<> b(3);
+  s >> B >> b;
+  EXPECT_EQ(B, A);
+  EXPECT_EQ(b, a);
+}
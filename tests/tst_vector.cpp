@@ -1,6 +1,8 @@
 #include "math/Vector.h"
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 using namespace Math;
@@ -147,6 +149,58 @@ TEST(Vector, cos_sin_angle_arbitrary_vectors)
   EXPECT_DOUBLE_EQ(sin(v, ey), 0.6);
 }
 
+TEST(Vector, fused_cos_sin_angle)
+{
+  V3d a(1, 2, 2), b(-2, 1, 7);
+  auto [c, s] = cos_sin(a, b);
+  EXPECT_DOUBLE_EQ(c, cos(a, b));
+  EXPECT_DOUBLE_EQ(c, (a * b) / (fabs(a) * fabs(b)));
+  EXPECT_DOUBLE_EQ(s, fabs(a % b) / (fabs(a) * fabs(b)));
+  EXPECT_DOUBLE_EQ(c*c + s*s, 1.0);
+  EXPECT_DOUBLE_EQ(angle(a, b), std::acos(c));
+  EXPECT_DOUBLE_EQ(angle(V2d(1, 0), V2d(-1, 1e-3)), std::atan2(1e-3, -1));
+
+  // small angles are accurate unlike sqrt(1 - cos^2)
+  const double eps = 1e-9;
+  V3d u(1, 0, 0), w(1, eps, 0);
+  EXPECT_NEAR(sin(u, w), eps, 1e-20);
+  EXPECT_NEAR(angle(u, w), eps, 1e-20);
+  EXPECT_NEAR(angle(u, -w), std::acos(-1.) - eps, 1e-15);
+
+  auto n = normalize(V3d(0, -3, 4));
+  EXPECT_DOUBLE_EQ(n[1], -0.6);
+  EXPECT_DOUBLE_EQ(n[2], 0.8);
+  EXPECT_NEAR(sqs(normalize(Vector<3, float>(1e-3f, 2e3f, -7.f))), 1.f, 1e-6f);
+}
+
+TEST(Vector, cos_sin_range)
+{
+  // integers as v1 v2 / (|v1| |v2|) and sqrt(1 - cos^2)
+  const Vector<2, int> vi(3, 4);
+  EXPECT_EQ(cos(vi, vi), 1);
+  EXPECT_EQ(sin(vi, vi), 0);
+  EXPECT_EQ(cos(Vector<2, int>(1, 0), Vector<2, int>(0, 1)), 0);
+  EXPECT_EQ(sin(Vector<2, int>(1, 0), Vector<2, int>(0, 1)), 1);
+  EXPECT_EQ(cos_sin(vi, vi), std::make_pair(1, 0));
+
+  // no overflow nor underflow of the squared norms product
+  for (double x : {1e100, 1e-100})
+  {
+    const V3d a(x, 0, 0), b(x, x, 0);
+    EXPECT_DOUBLE_EQ(cos(a, a), 1.0);
+    EXPECT_DOUBLE_EQ(sin(a, a), 0.0);
+    EXPECT_DOUBLE_EQ(cos(a, b), std::sqrt(.5));
+    EXPECT_DOUBLE_EQ(sin(a, b), std::sqrt(.5));
+    EXPECT_DOUBLE_EQ(cos_sin(a, b).first, std::sqrt(.5));
+    EXPECT_DOUBLE_EQ(cos_sin(a, b).second, std::sqrt(.5));
+  }
+  const Vector<3, float> f(1e10f, 0, 0), g(0, 1e10f, 1e10f);
+  EXPECT_FLOAT_EQ(cos(f, f), 1.f);
+  EXPECT_FLOAT_EQ(sin(f, g), 1.f);
+  EXPECT_FLOAT_EQ(cos_sin(f, f).first, 1.f);
+  EXPECT_FLOAT_EQ(cos_sin(f, g).second, 1.f);
+}
+
 TEST(Vector, rotation_2d)
 {
   V2i v(1, 0);
@@ -273,3 +327,117 @@ TEST(Vector, roundtrip_bare_comps)
   ss >> v2;
   EXPECT_EQ(v1, v2);
 }
+
+TEST(Vector, packed_arithmetic_3d)
+{
+  V3d a(1, 2, 3), b(0.5, -1, 4);
+  EXPECT_EQ(a + b, V3d(1.5, 1, 7));
+  EXPECT_EQ(a - b, V3d(0.5, 3, -1));
+  EXPECT_EQ(a * 2., V3d(2, 4, 6));
+  EXPECT_EQ(a / 2., V3d(0.5, 1, 1.5));
+  EXPECT_EQ(-a, V3d(-1, -2, -3));
+  EXPECT_DOUBLE_EQ(a * b, 10.5);
+  EXPECT_EQ(a % b, V3d(11, -2.5, -2));
+  EXPECT_DOUBLE_EQ(fabs(V3d(2, 3, 6)), 7.);
+}
+
+TEST(Vector, packed_arithmetic_2d_4d)
+{
+  V2d a(1, 2), b(3, -4);
+  EXPECT_EQ(a + b, V2d(4, -2));
+  EXPECT_EQ(b / 2., V2d(1.5, -2));
+  EXPECT_DOUBLE_EQ(a * b, -5.);
+
+  using V4d = Vector<4>;
+  V4d c(1, 2, 3, 4), d(4, 3, 2, 1);
+  EXPECT_EQ(c + d, V4d(5));
+  EXPECT_EQ(c - d, V4d(-3, -1, 1, 3));
+  EXPECT_EQ(c * 3., V4d(3, 6, 9, 12));
+  EXPECT_DOUBLE_EQ(c * d, 20.);
+}
+
+TEST(Vector, packed_arithmetic_4f)
+{
+  using V4f = Vector<4, float>;
+  V4f a(1, 2, 3, 4), b(0.5f, 0.25f, -1, 2);
+  EXPECT_EQ(a + b, V4f(1.5f, 2.25f, 2, 6));
+  EXPECT_EQ(a - b, V4f(0.5f, 1.75f, 4, 2));
+  EXPECT_EQ(a * 2.f, V4f(2, 4, 6, 8));
+  EXPECT_EQ(a / 4.f, V4f(0.25f, 0.5f, 0.75f, 1));
+  EXPECT_FLOAT_EQ(a * b, 6.f);
+  EXPECT_FLOAT_EQ(sqs(a), 30.f);
+}
+
+TEST(Vector, packed_matches_generic)
+{
+  // the same computations done in compile-time by generic loops
+  constexpr V3d a(0.1, 0.2, 0.3), b(-1.7, 2.9, 0.013);
+  constexpr V3d sum = a + b, diff = a - b, cross = a % b;
+  constexpr double dot = a * b;
+  V3d ra(0.1, 0.2, 0.3), rb(-1.7, 2.9, 0.013);
+  V3d rsum = ra + rb, rdiff = ra - rb, rcross = ra % rb;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    EXPECT_DOUBLE_EQ(rsum[i], sum[i]);
+    EXPECT_DOUBLE_EQ(rdiff[i], diff[i]);
+    EXPECT_DOUBLE_EQ(rcross[i], cross[i]);
+  }
+  EXPECT_DOUBLE_EQ(ra * rb, dot);
+}
+
+TEST(Vector, padded_layout)
+{
+  using P3d = PaddedVector<3>;
+  using P3f = PaddedVector<3, float>;
+  EXPECT_EQ(sizeof(P3d), 4*sizeof(double));
+  EXPECT_EQ(alignof(P3d), 4*sizeof(double));
+  EXPECT_EQ(sizeof(P3f), 4*sizeof(float));
+  EXPECT_EQ(alignof(P3f), 4*sizeof(float));
+  P3d a(1, 2, 3);
+  EXPECT_EQ(a.end() - a.begin(), 3);
+}
+
+TEST(Vector, padded_arithmetic)
+{
+  using P3d = PaddedVector<3>;
+  using P3f = PaddedVector<3, float>;
+
+  P3d a(1, 2, 3), b(0.5, -1, 4);
+  EXPECT_EQ(a + b, P3d(1.5, 1, 7));
+  EXPECT_EQ(a - b, P3d(0.5, 3, -1));
+  EXPECT_EQ(a * 2., P3d(2, 4, 6));
+  EXPECT_EQ(a / 2., P3d(0.5, 1, 1.5));
+  EXPECT_DOUBLE_EQ(a * b, 10.5);
+  EXPECT_EQ(a % b, P3d(11, -2.5, -2));
+
+  P3f c(1, 2, 3), d(0.5f, -1, 4);
+  EXPECT_EQ(c + d, P3f(1.5f, 1, 7));
+  EXPECT_EQ(c / 2.f, P3f(0.5f, 1, 1.5f));
+  EXPECT_FLOAT_EQ(c * d, 10.5f);
+  EXPECT_EQ(c % d, P3f(11, -2.5f, -2));
+}
+
+TEST(Vector, padded_matches_packed)
+{
+  V3d a(0.1, 0.2, 0.3), b(-1.7, 2.9, 0.013);
+  PaddedVector3D pa(a), pb(b);
+  EXPECT_EQ(V3d(pa + pb), a + b);
+  EXPECT_EQ(V3d(pa % pb), a % b);
+  EXPECT_DOUBLE_EQ(pa * pb, a * b);
+}
+
+TEST(Vector, padding_stays_zero)
+{
+  // padding lane must not become NaN, otherwise dot products are spoiled
+  PaddedVector3D a(1, 2, 3);
+  a *= std::numeric_limits<double>::infinity();
+  EXPECT_EQ(a.begin()[3], 0.);
+  a = PaddedVector3D(1, 2, 3);
+  a /= 0.;
+  EXPECT_EQ(a.begin()[3], 0.);
+  a = PaddedVector3D(1, 2, 3);
+  a /= 2.;
+  EXPECT_DOUBLE_EQ(a * PaddedVector3D(2, 2, 2), 6.);
+  PaddedVector3D b(1);
+  EXPECT_EQ(b.begin()[3], 0.);
+}
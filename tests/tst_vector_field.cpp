@@ -0,0 +1,131 @@
+#include "math/VectorField.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+
+using namespace Math;
+
+using V3d = Vector<3>;
+using VF3d = VectorField<3>;
+
+TEST(VectorField, init_default_to_zero)
+{
+  VF3d f(5);
+  EXPECT_EQ(f.size(), 5u);
+  for (size_t k = 0; k < f.size(); ++k)
+    EXPECT_EQ(f[k].get(), V3d(0));
+}
+
+TEST(VectorField, init_with_value)
+{
+  VF3d f(3, V3d(1, 2, 3));
+  for (size_t k = 0; k < f.size(); ++k)
+    EXPECT_EQ(f.get(k), V3d(1, 2, 3));
+}
+
+TEST(VectorField, components_are_aligned_arrays)
+{
+  VF3d f(13);
+  for (size_t k = 0; k < f.size(); ++k)
+    f[k] = V3d(k, 10. + k, 100. + k);
+
+  const double base[] = {0, 10, 100};
+  for (size_t i = 0; i < 3; ++i)
+  {
+    auto c = f.component(i);
+    EXPECT_EQ(c.size(), 13u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c.data()) % simd::alignment, 0u);
+    for (size_t k = 0; k < c.size(); ++k)
+      EXPECT_EQ(c[k], base[i] + k);
+  }
+}
+
+TEST(VectorField, proxy_access)
+{
+  VF3d f(2);
+  f[0] = V3d(1, 2, 3);
+  f[1] = f[0];
+  f[1] += V3d(1);
+  f[1] *= 2.;
+  f[0][V3d::Z] = 5;
+  EXPECT_EQ(f.get(0), V3d(1, 2, 5));
+  EXPECT_EQ(f.get(1), V3d(4, 6, 8));
+
+  V3d v = f[1];
+  EXPECT_DOUBLE_EQ(v * f[0].get(), 56.);
+
+  const VF3d &cf = f;
+  EXPECT_EQ(cf[1], V3d(4, 6, 8));
+}
+
+TEST(VectorField, resize_keeps_values)
+{
+  VF3d f(3, V3d(1, 2, 3));
+  f.resize(100);
+  EXPECT_EQ(f.size(), 100u);
+  EXPECT_EQ(f.get(2), V3d(1, 2, 3));
+  EXPECT_EQ(f.get(3), V3d(0));
+  EXPECT_EQ(f.get(99), V3d(0));
+  f.resize(1);
+  EXPECT_EQ(f.get(0), V3d(1, 2, 3));
+}
+
+TEST(VectorField, axpy_and_scale)
+{
+  VF3d x(17, V3d(1, 2, 3)), y(17, V3d(1));
+  axpy(2., x, y);
+  for (size_t k = 0; k < y.size(); ++k)
+    EXPECT_EQ(y.get(k), V3d(3, 5, 7));
+
+  scale(0.5, y);
+  for (size_t k = 0; k < y.size(); ++k)
+    EXPECT_EQ(y.get(k), V3d(1.5, 2.5, 3.5));
+}
+
+TEST(VectorField, dot_and_norm)
+{
+  VF3d x(11), y(11, V3d(1, 1, 1));
+  for (size_t k = 0; k < x.size(); ++k)
+    x[k] = V3d(2, 3, 6) * double(k);
+
+  std::vector<double> r(x.size());
+  dot(x, y, std::span<double>(r));
+  for (size_t k = 0; k < x.size(); ++k)
+    EXPECT_DOUBLE_EQ(r[k], 11. * k);
+
+  norm(x, std::span<double>(r));
+  for (size_t k = 0; k < x.size(); ++k)
+    EXPECT_DOUBLE_EQ(r[k], 7. * k);
+}
+
+TEST(VectorField, cross)
+{
+  VF3d x(9), y(9), r(9);
+  for (size_t k = 0; k < x.size(); ++k)
+  {
+    x[k] = V3d(1, 2, 3 + k);
+    y[k] = V3d(4 - k, 5, 6);
+  }
+  cross(x, y, r);
+  for (size_t k = 0; k < x.size(); ++k)
+    EXPECT_EQ(r.get(k), x.get(k) % y.get(k));
+
+  // in-place
+  cross(x, y, x);
+  EXPECT_EQ(x.get(0), V3d(-3, 6, -3));
+}
+
+TEST(VectorField, normalize)
+{
+  VectorField<2, float> f(1000);
+  for (size_t k = 1; k < f.size(); ++k)
+    f[k] = Vector<2, float>(3.f * k, -4.f * k);
+  normalize(f);
+
+  EXPECT_EQ(f.get(0), (Vector<2, float>(0))); // zero vector stays zero
+  for (size_t k = 1; k < f.size(); ++k)
+  {
+    EXPECT_FLOAT_EQ(f[k][0], 0.6f);
+    EXPECT_FLOAT_EQ(f[k][1], -0.8f);
+  }
+}